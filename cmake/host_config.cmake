@@ -28,6 +28,18 @@ add_compile_definitions(
     "$<$<NOT:$<CONFIG:Release>>:_DEBUG>"
 )
 
+# MKI_MIN_LOG_LEVEL=<TRACE|DEBUG|INFO|WARN|ERROR|FATAL> compiles out MKI_LOG statements below the level
+if(DEFINED MKI_MIN_LOG_LEVEL AND NOT MKI_MIN_LOG_LEVEL STREQUAL "")
+    string(TOUPPER "${MKI_MIN_LOG_LEVEL}" MKI_MIN_LOG_LEVEL_NAME)
+    set(MKI_LOG_LEVEL_NAMES TRACE DEBUG INFO WARN ERROR FATAL)
+    list(FIND MKI_LOG_LEVEL_NAMES "${MKI_MIN_LOG_LEVEL_NAME}" MKI_MIN_LOG_LEVEL_INDEX)
+    if(MKI_MIN_LOG_LEVEL_INDEX LESS 0)
+        message(FATAL_ERROR "MKI_MIN_LOG_LEVEL ${MKI_MIN_LOG_LEVEL} is invalid")
+    endif()
+    message(STATUS "MKI_MIN_LOG_LEVEL:${MKI_MIN_LOG_LEVEL_NAME}")
+    add_compile_definitions(MKI_MIN_LOG_LEVEL=${MKI_MIN_LOG_LEVEL_INDEX})
+endif()
+
 set(LD_FLAGS_GLOBAL "-shared;-rdynamic;-ldl;-Wl,-z,relro;-Wl,-z,now")
 set(LD_FLAGS_GLOBAL "${LD_FLAGS_GLOBAL};-Wl,-z,noexecstack;-Wl,--build-id=none")
 
@@ -29,9 +29,10 @@ USE_VERBOSE=OFF
 ENABLE_COVERAGE=OFF
 USE_CXX11_ABI=""
 IS_RELEASE=False
-BUILD_OPTION_LIST="testframework release example dev debug unittest clean help"
+BUILD_OPTION_LIST="testframework release example dev debug unittest benchmark clean help"
 BUILD_CONFIGURE_LIST=("--output=.*" "--use_cxx11_abi=0" "--use_cxx11_abi=1"
-                      "--verbose" "--no_werror" "--coverage" "--namespace=.*" "--msdebug")
+                      "--verbose" "--no_werror" "--coverage" "--namespace=.*" "--msdebug"
+                      "--min_log_level=.*")
 
 # install cann
 function fn_install_cann_and_kernel()
@@ -70,6 +71,20 @@ function fn_build_googletest()
     rm v1.13.0.tar.gz
 }
 
+function fn_build_googlebenchmark()
+{
+    GBENCH_DIR=$THIRD_PARTY_DIR/benchmark
+    if [ -d "$GBENCH_DIR" ]; then
+        return $?
+    fi
+    [[ ! -d "$THIRD_PARTY_DIR" ]] && mkdir -p $THIRD_PARTY_DIR
+    cd $THIRD_PARTY_DIR
+    wget --no-check-certificate https://github.com/google/benchmark/archive/refs/tags/v1.8.3.tar.gz
+    tar -xf v1.8.3.tar.gz
+    mv benchmark-1.8.3 benchmark
+    rm v1.8.3.tar.gz
+}
+
 function fn_build_nlohmann_json()
 {
     if [ -d "$THIRD_PARTY_DIR/nlohmannJson" ]; then
@@ -293,6 +308,10 @@ function fn_main()
         "--no_werror")
             COMPILE_OPTIONS="${COMPILE_OPTIONS} -DNO_WERROR=ON"
             ;;
+        --min_log_level=*)
+            arg2=${arg2#*=}
+            COMPILE_OPTIONS="${COMPILE_OPTIONS} -DMKI_MIN_LOG_LEVEL=$arg2"
+            ;;
         "--msdebug")
             CHIP_TYPE=$(npu-smi info -m | grep -oE 'Ascend\s*\S+' | head -n 1 | tr -d ' ' | tr '[:upper:]' '[:lower:]')
             COMPILE_OPTIONS="${COMPILE_OPTIONS} -DUSE_MSDEBUG=ON -DCHIP_TYPE=${CHIP_TYPE}"
@@ -334,6 +353,11 @@ function fn_main()
             fn_build_googletest
             fn_build
             ;;
+        "benchmark")
+            COMPILE_OPTIONS="${COMPILE_OPTIONS} -DCMAKE_BUILD_TYPE=Release -DBUILD_BENCHMARK=ON"
+            fn_build_googlebenchmark
+            fn_build
+            ;;
         "clean")
             [[ -d "$CACHE_DIR" ]] && rm -rf $CACHE_DIR
             [[ -d "$OUTPUT_DIR" ]] && rm -rf $OUTPUT_DIR
@@ -341,9 +365,9 @@ function fn_main()
             echo "clear all build history."
             ;;
         *)
-            echo "build.sh testframework|release|example|dev|debug|unittest|clean"\
+            echo "build.sh testframework|release|example|dev|debug|unittest|benchmark|clean"\
             "--output=<dir>|--force_clean|--use_cxx11_abi=0|--use_cxx11_abi=1"\
-            "|--no_werror|--verbose|--coverage|--namespace=<namespace>|--msdebug"
+            "|--no_werror|--verbose|--coverage|--namespace=<namespace>|--msdebug|--min_log_level=<level>"
             ;;
     esac
 }
@@ -65,6 +65,72 @@ def aligned_string(s:str, align:int) -> str:
     return s.ljust(width, '\0')
 
 
+LZ4_MIN_MATCH = 4
+LZ4_LAST_LITERALS = 5
+LZ4_MF_LIMIT = 12
+LZ4_MAX_OFFSET = 0xFFFF
+LZ4_RUN_MASK = 15
+KERNEL_COMPRESS_NONE = 0
+KERNEL_COMPRESS_LZ4 = 1
+KERNEL_COMPRESS_FIELD_OFFSET = 40 # compressType and rawBinSize follow taskRation in the kernel header
+
+
+def is_kernel_compress_enabled():
+    return os.getenv("MKI_COMPRESS_KERNEL", "0") == "1"
+
+
+def _lz4_write_length(out: bytearray, length: int):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _lz4_write_sequence(out: bytearray, literals: bytes, offset: int = 0, match_len: int = 0):
+    literal_len = len(literals)
+    token = min(literal_len, LZ4_RUN_MASK) << 4
+    if match_len > 0:
+        token |= min(match_len - LZ4_MIN_MATCH, LZ4_RUN_MASK)
+    out.append(token)
+    if literal_len >= LZ4_RUN_MASK:
+        _lz4_write_length(out, literal_len - LZ4_RUN_MASK)
+    out += literals
+    if match_len > 0:
+        out += struct.pack('<H', offset)
+        if match_len - LZ4_MIN_MATCH >= LZ4_RUN_MASK:
+            _lz4_write_length(out, match_len - LZ4_MIN_MATCH - LZ4_RUN_MASK)
+
+
+# greedy LZ4 raw block encoder, decoded by Mki::Lz4BlockDecompress
+def lz4_block_compress(data: bytes) -> bytes:
+    data_len = len(data)
+    match_limit = data_len - LZ4_LAST_LITERALS
+    out = bytearray()
+    table = {}
+    anchor = 0
+    pos = 0
+    while pos + LZ4_MF_LIMIT <= data_len:
+        key = data[pos:pos + LZ4_MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = pos
+        if candidate is None or pos - candidate > LZ4_MAX_OFFSET:
+            pos += 1
+            continue
+        match_len = LZ4_MIN_MATCH
+        step = 8
+        while pos + match_len + step <= match_limit and \
+                data[candidate + match_len:candidate + match_len + step] == \
+                data[pos + match_len:pos + match_len + step]:
+            match_len += step
+        while pos + match_len < match_limit and data[candidate + match_len] == data[pos + match_len]:
+            match_len += 1
+        _lz4_write_sequence(out, data[anchor:pos], pos - candidate, match_len)
+        pos += match_len
+        anchor = pos
+    _lz4_write_sequence(out, data[anchor:])
+    return bytes(out)
+
+
 def get_header_from_file(file_path):
     result = True
     magic_dict = {"RT_DEV_BINARY_MAGIC_ELF": 0x43554245,
@@ -148,6 +214,14 @@ def write_to_cpp(binary_path, header, dst_cpp_path, kernel, target_version, is_c
     try:
         with open(binary_path, 'rb') as f:
             data = f.read()
+            if is_kernel_compress_enabled():
+                compressed = lz4_block_compress(data)
+                if len(compressed) < len(data):
+                    field_end = KERNEL_COMPRESS_FIELD_OFFSET + struct.calcsize('II')
+                    header = header[:KERNEL_COMPRESS_FIELD_OFFSET] + \
+                             struct.pack('II', KERNEL_COMPRESS_LZ4, len(data)) + header[field_end:]
+                    logging.info("compress %s from %d to %d bytes", binary_path, len(data), len(compressed))
+                    data = compressed
             binary_size = len(data)
             header += struct.pack('I', binary_size)
             data = header + data
@@ -335,5 +409,9 @@ if __name__ == '__main__':
     parser.add_argument('--binary_dir', type=str, required=True)
     parser.add_argument('--op_type', type=str, required=False)
     parser.add_argument('--tbe_ini_path', type=str, default="configs/tbe_tactic_json.ini", required=False)
+    parser.add_argument('--compress', action='store_true',
+                        help="lz4 compress kernel binaries, same as MKI_COMPRESS_KERNEL=1")
     input_args = parser.parse_args()
+    if input_args.compress:
+        os.environ["MKI_COMPRESS_KERNEL"] = "1"
     copy_tbe_device_code(input_args)
@@ -0,0 +1,123 @@
+# -*- coding: UTF-8 -*-
+# Copyright (c) 2024 Huawei Technologies Co., Ltd.
+# MindKernelInfra is licensed under Mulan PSL v2.
+# You can use this software according to the terms and conditions of the Mulan PSL v2.
+# You may obtain a copy of Mulan PSL v2 at:
+#          http://license.coscl.org.cn/MulanPSL2
+# THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+# EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+# MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+# See the Mulan PSL v2 for more details.
+
+
+"""compile configs/platform_configs/*.ini into a C++ table, see platform_config_table.h"""
+
+import argparse
+import os
+import sys
+
+MAX_FILE_LINE_NUM = 20000
+
+
+def parse_ini(file_path):
+    """same rules as IniFile::ParseIniFileToMap: spaces are removed, the first section and key win"""
+    content = {}
+    section = {}
+    section_name = ""
+    with open(file_path, "r") as ini_file:
+        for line_num, line in enumerate(ini_file):
+            if line_num > MAX_FILE_LINE_NUM:
+                break
+            line = "".join(line.split())
+            if not line or line.startswith("#"):
+                continue
+            if line.startswith("["):
+                if section_name and section:
+                    content.setdefault(section_name, section)
+                    section = {}
+                pos = line.rfind("]")
+                if pos != -1:
+                    section_name = line[1:pos]
+                continue
+            pos = line.find("=")
+            if pos == -1:
+                continue
+            key, value = line[:pos], line[pos + 1:]
+            if key and value:
+                section.setdefault(key, value)
+    if section_name and section:
+        content.setdefault(section_name, section)
+    return content
+
+
+def cpp_str(value):
+    return '"' + value.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def generate(input_dir, output):
+    tables = []
+    soc_versions = set()
+    # without an input dir the table is empty and PlatformManager loads ini files at runtime
+    for file_name in sorted(os.listdir(input_dir)) if input_dir else []:
+        if not file_name.endswith(".ini") or file_name.startswith("."):
+            continue
+        content = parse_ini(os.path.join(input_dir, file_name))
+        soc_version = content.get("version", {}).get("SoC_version", "")
+        if not soc_version:
+            continue
+        if soc_version in soc_versions:
+            raise ValueError("There are repetitive soc version[%s] in config files" % soc_version)
+        soc_versions.add(soc_version)
+        tables.append((soc_version, file_name, content))
+
+    lines = ["// generated by scripts/gen_platform_config_table.py, do not edit",
+             '#include "mki/utils/platform/platform_config_table.h"', "", "namespace Mki {"]
+    for idx, (_, file_name, content) in enumerate(tables):
+        lines.append("// %s" % file_name)
+        lines.append("static const PlatformConfigItem PLATFORM_CONFIG_ITEMS_%d[] = {" % idx)
+        for label in sorted(content):
+            for key in sorted(content[label]):
+                lines.append("    {%s, %s, %s}," % (cpp_str(label), cpp_str(key), cpp_str(content[label][key])))
+        lines.append("};")
+        lines.append("")
+    lines.append("static const PlatformConfigTable PLATFORM_CONFIG_TABLES[] = {")
+    for idx, (soc_version, file_name, _) in enumerate(tables):
+        lines.append("    {%s, %s, PLATFORM_CONFIG_ITEMS_%d, sizeof(PLATFORM_CONFIG_ITEMS_%d) / sizeof(PlatformConfigItem)},"
+                     % (cpp_str(soc_version), cpp_str(file_name), idx, idx))
+    if not tables:
+        lines.append("    {nullptr, nullptr, nullptr, 0},")
+    lines.append("};")
+    lines.append("")
+    lines.append("const PlatformConfigTable *GetBuiltinPlatformConfigTables(size_t &count)")
+    lines.append("{")
+    lines.append("    count = %d;" % len(tables))
+    lines.append("    return PLATFORM_CONFIG_TABLES;")
+    lines.append("}")
+    lines.append("} // namespace Mki")
+    lines.append("")
+
+    text = "\n".join(lines)
+    # keep the timestamp when nothing changes, so dependent objects are not rebuilt
+    if os.path.exists(output):
+        with open(output, "r") as old_file:
+            if old_file.read() == text:
+                return
+    os.makedirs(os.path.dirname(os.path.abspath(output)), exist_ok=True)
+    with open(output, "w") as out_file:
+        out_file.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="generate the builtin platform config table")
+    parser.add_argument("--input_dir", default="", help="dir of platform config ini files, empty table if not set")
+    parser.add_argument("--output", required=True, help="generated cpp file")
+    args = parser.parse_args()
+    try:
+        generate(args.input_dir, args.output)
+    except (OSError, ValueError) as error:
+        sys.stderr.write("gen_platform_config_table: %s\n" % error)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
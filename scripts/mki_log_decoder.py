@@ -0,0 +1,167 @@
+# -*- coding: UTF-8 -*-
+# Copyright (c) 2024 Huawei Technologies Co., Ltd.
+# MindKernelInfra is licensed under Mulan PSL v2.
+# You can use this software according to the terms and conditions of the Mulan PSL v2.
+# You may obtain a copy of Mulan PSL v2 at:
+#          http://license.coscl.org.cn/MulanPSL2
+# THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+# EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+# MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+# See the Mulan PSL v2 for more details.
+
+"""decode *.binlog written by ASDOPS_LOG_TO_BINARY=1 into the text log format, see log_sink_binary.h"""
+
+import argparse
+import datetime
+import re
+import struct
+import sys
+
+MAGIC = b"MKIBLOG\0"
+VERSION = 1
+RECORD_CALLSITE, RECORD_FORMAT, RECORD_TEXT, RECORD_RENDERED = 1, 2, 3, 4
+ARG_INT, ARG_LONG, ARG_DOUBLE, ARG_STRING, ARG_POINTER = 0, 1, 2, 3, 4
+LEVELS = ["trace", "debug", "info", "warn", "error", "fatal"]
+FORMAT_SPEC = re.compile(r"%([-+ #0']*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|L|q|j|z|t)?([diuoxXcfFeEgGaAsp%])")
+
+
+class Callsite:
+    def __init__(self, level, line, file_name, func_name, fmt, arg_types):
+        self.level = level
+        self.line = line
+        self.file_name = file_name
+        self.func_name = func_name
+        self.fmt = fmt
+        self.arg_types = arg_types
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def read(self, fmt):
+        value = struct.unpack_from("<" + fmt, self.data, self.pos)
+        self.pos += struct.calcsize("<" + fmt)
+        return value[0]
+
+    def read_bytes(self, size):
+        if self.pos + size > len(self.data):
+            raise struct.error("record truncated")
+        value = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return value
+
+    def read_str16(self):
+        return self.read_bytes(self.read("H")).decode("utf-8", errors="replace")
+
+
+def render(fmt, args):
+    """printf style rendering with the already decoded arguments"""
+    arg_iter = iter(args)
+
+    def replace(match):
+        flags, width, precision, length, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(next(arg_iter))
+        if precision == "*":
+            precision = str(next(arg_iter))
+        value = next(arg_iter)
+        spec = flags.replace("'", "") + (width or "") + ("." + precision if precision is not None else "")
+        if conv in "uoxX" and value < 0:
+            value &= 0xFFFFFFFFFFFFFFFF if length and length not in ("h", "hh") else 0xFFFFFFFF
+        if conv == "p":
+            return ("0x%x" % value) if value != 0 else "(nil)"
+        if conv == "c":
+            return ("%" + spec + "c") % chr(value & 0xFF)
+        if conv == "u":
+            conv = "d"
+        return ("%" + spec + conv) % value
+
+    try:
+        return FORMAT_SPEC.sub(replace, fmt)
+    except (StopIteration, TypeError, ValueError):
+        return fmt + " " + str(args)
+
+
+def header(time_us, level, tid, file_name, line):
+    time_str = datetime.datetime.fromtimestamp(time_us // 1000000).strftime("%Y-%m-%d %H:%M:%S")
+    level_str = LEVELS[level] if level < len(LEVELS) else "unknown"
+    return "[%s.%06d] [%s] [%d] [%s:%d] " % (time_str, time_us % 1000000, level_str, tid, file_name, line)
+
+
+def read_args(reader, arg_types):
+    args = []
+    for arg_type in arg_types:
+        if arg_type == ARG_INT:
+            args.append(reader.read("i"))
+        elif arg_type == ARG_LONG:
+            args.append(reader.read("q"))
+        elif arg_type == ARG_DOUBLE:
+            args.append(reader.read("d"))
+        elif arg_type == ARG_STRING:
+            args.append(reader.read_str16())
+        elif arg_type == ARG_POINTER:
+            args.append(reader.read("Q"))
+        else:
+            raise ValueError("unknown arg type %d" % arg_type)
+    return args
+
+
+def decode(data, out):
+    if data[:len(MAGIC)] != MAGIC:
+        raise ValueError("not a mki binary log")
+    reader = Reader(data)
+    reader.pos = len(MAGIC)
+    version = reader.read("I")
+    if version != VERSION:
+        raise ValueError("unsupported binary log version %d" % version)
+
+    callsites = {}
+    while not reader.eof():
+        record_type = reader.read("B")
+        if record_type == RECORD_CALLSITE:
+            callsite_id, level, line = reader.read("I"), reader.read("B"), reader.read("I")
+            file_name, func_name, fmt = reader.read_str16(), reader.read_str16(), reader.read_str16()
+            arg_types = list(reader.read_bytes(reader.read("B")))
+            callsites[callsite_id] = Callsite(level, line, file_name, func_name, fmt, arg_types)
+        elif record_type in (RECORD_FORMAT, RECORD_RENDERED):
+            callsite = callsites[reader.read("I")]
+            time_us, tid = reader.read("Q"), reader.read("I")
+            if record_type == RECORD_FORMAT:
+                content = render(callsite.fmt, read_args(reader, callsite.arg_types))
+            else:
+                content = reader.read_str16()
+            out.write(header(time_us, callsite.level, tid, callsite.file_name, callsite.line) + content + "\n")
+        elif record_type == RECORD_TEXT:
+            out.write(reader.read_bytes(reader.read("I")).decode("utf-8", errors="replace"))
+        else:
+            raise ValueError("unknown record type %d at offset %d" % (record_type, reader.pos - 1))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="decode mki binary logs (*.binlog) to text")
+    parser.add_argument("files", nargs="+", help="binary log files")
+    parser.add_argument("-o", "--output", help="output file, default stdout")
+    args = parser.parse_args()
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        for file_name in args.files:
+            with open(file_name, "rb") as binlog:
+                try:
+                    decode(binlog.read(), out)
+                except (ValueError, KeyError, struct.error) as error:
+                    sys.stderr.write("%s: %s\n" % (file_name, error))
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
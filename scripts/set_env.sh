@@ -23,8 +23,13 @@ if [[ -f "$path" ]] && [[ "$path" =~ 'set_env.sh' ]];then
     export ASDOPS_LOG_LEVEL=INFO
     export ASDOPS_LOG_TO_FILE=0
     export ASDOPS_LOG_TO_FILE_FLUSH=0
+    export ASDOPS_LOG_MAX_FILE_SIZE=1024 #单个日志文件大小上限，单位MB
+    export ASDOPS_LOG_MAX_FILE_COUNT=50 #日志目录下保留的日志文件个数
+    export ASDOPS_LOG_TO_BINARY=0 #二进制日志，使用scripts/mki_log_decoder.py解析
     export ASDOPS_LOG_TO_BOOST_TYPE=atb #算子库对应加速库日志类型，默认transformer
     export ASDOPS_LOG_PATH=~
+    export ASDOPS_DEVICE_CACHE_LIMIT=0 #设备内存缓存分配器保留内存上限，单位MB，0表示不限制
+    export ASDOPS_TILING_RING_SIZE=4 #每条流的tiling环形缓冲区大小，单位MB
 else
     echo "There is no 'set_env.sh' to import"
 fi
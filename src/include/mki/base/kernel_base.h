@@ -14,12 +14,17 @@
 #include <string>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include "mki/kernel.h"
 #include "mki/kernel_info.h"
 #include "mki/run_info.h"
 #include "mki/bin_handle.h"
+#include "mki/utils/rt/base/types.h"
 
 namespace Mki {
+class LaunchGraph;
+
 class KernelBase : public Kernel {
 using KernelSelfCreator = std::function<KernelBase*(void)>;
 public:
@@ -38,10 +43,21 @@ public:
 
     void SetLaunchWithTiling(bool flag) override;
     void SetTilingHostAddr(uint8_t *addr, uint64_t len) override;
+    void SetHostAllocator(HostAllocator *allocator) override;
+    void SetArgsFrozen(bool flag) override;
+    void SetTilingCacheCapacity(size_t capacity) override;
+    TilingCacheStats GetTilingCacheStats() const override;
+    KernelPool *GetKernelPool() const override;
     std::string GetName() const override;
     const KernelInfo &GetKernelInfo() const override;
     KernelType GetType() const override;
 
+    // used by LaunchBatch, builds the args of an initialized kernel into args which holds
+    // GetKernelInfo().GetArgsSize() bytes, argsInfo keeps the args ex that kernelParam points to
+    Status BuildBatchLaunch(const LaunchParam &launchParam, const RunInfo &runInfo, uint8_t *args,
+                            KernelInfo::FrozenArgsInfo &argsInfo, MkiRtKernelParam &kernelParam,
+                            MkiRtLaunchItem &launchItem);
+
 protected:
     virtual Status InitImpl(const LaunchParam &launchParam);
     const BinHandle *GetBinHandle() const;
@@ -52,7 +68,14 @@ protected:
     KernelInfo kernelInfo_;
 
 private:
+    Status InitKernelInfo(const LaunchParam &launchParam);
     uint64_t GetKernelArgsNum(const LaunchParam &launchParam);
+    Status RunWithTilingRing(const LaunchParam &launchParam, const RunInfo &runInfo);
+    Status RunWithCapture(LaunchGraph &graph, const LaunchParam &launchParam, const RunInfo &runInfo,
+                          bool uploadTiling);
+    Status RunKernel(const LaunchParam &launchParam, const RunInfo &runInfo);
+    Status RunWithFrozenArgs(const LaunchParam &launchParam, const RunInfo &runInfo);
+    Status LaunchKernel(const MkiRtKernelParam &kernelParam, void *stream) const;
     uint64_t GetTensorListSize(const LaunchParam &launchParam);
     Status InitTensorList(const LaunchParam &launchParam);
     void BuildTensorList(uint8_t *startPtr, SVector<int> &lens, SVector<Tensor> &tensors,
@@ -63,6 +86,9 @@ private:
     KernelType kernelType_{KernelType::KERNEL_TYPE_INVALID};
     const BinHandle *handle_{nullptr};
     KernelSelfCreator creator_{nullptr};
+    std::shared_ptr<TilingCache> tilingCache_{nullptr};
+    mutable std::once_flag kernelPoolFlag_;
+    mutable std::unique_ptr<KernelPool> kernelPool_{nullptr};
     friend void SetKernelSelfCreator(KernelBase &kernel, KernelSelfCreator func);
 };
 
@@ -34,6 +34,7 @@ public:
 
     const KernelList &GetKernelList() const override;
     Kernel *GetKernelByName(const std::string &kernelName) const override;
+    PooledKernel AcquireKernelByName(const std::string &kernelName) const override;
     void AddKernel(const std::string &kernelName, Kernel const *kernel);
 
 protected:
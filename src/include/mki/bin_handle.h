@@ -13,6 +13,8 @@
 #define MKI_BIN_HANDLE_H
 #include <string>
 #include <atomic>
+#include <mutex>
+#include <vector>
 #include "mki/tensor.h"
 #include "mki/utils/non_copyable/non_copyable.h"
 
@@ -37,6 +39,8 @@ struct KernelMetaInfo {
     uint32_t vectorRatio = 0;
     const void *codeBuf = nullptr;
     uint32_t codeBufLen = 0;
+    uint32_t compressType = 0; // 0: raw code, 1: lz4 block
+    uint32_t rawCodeBufLen = 0;
 };
 
 class BinHandle : public NonCopyable {
@@ -44,7 +48,11 @@ public:
     explicit BinHandle(const BinaryBasicInfo *binInfo);
     ~BinHandle();
     KernelHandle GetHandle() const;
-    bool Init(const std::string &kernelName);
+    // parse kernel meta info, with lazyRegister the binary is registered on first EnsureRegistered/GetHandle
+    bool Init(const std::string &kernelName, bool lazyRegister = false);
+    bool EnsureRegistered() const;
+    bool IsRegistered() const;
+    uint64_t GetRegisterCostUs() const;
     uint32_t GetKernelTilingSize() const;
     int32_t GetKernelCoreType() const;
     uint32_t GetIntercoreSync() const;
@@ -55,14 +63,22 @@ public:
 private:
     bool CheckBinaryValid() const;
     bool CheckKernelInfo(const std::string &kernelName) const;
-    bool RegisterBin(const std::string &kernelName);
+    bool RegisterBin(const std::string &kernelName) const;
+    bool DecompressCode(std::vector<uint8_t> &code) const;
+    bool TimedRegisterBin() const;
 
 private:
     KernelMetaInfo metaInfo_;
-    void *handle_ = nullptr;
-    void *moduleHandle_ = nullptr;
+    std::string kernelName_;
+    mutable void *handle_ = nullptr;
+    mutable void *moduleHandle_ = nullptr;
     BinaryBasicInfo const *const basicInfo_ = nullptr;
     std::atomic_bool codeLoadSuccess_ = false;
+    bool lazyRegister_ = false;
+    mutable std::mutex registerMutex_;
+    mutable std::atomic_bool registerFailed_ = false;
+    mutable std::atomic_bool registered_ = false;
+    mutable std::atomic<uint64_t> registerCostUs_{0};
 };
 } // namespace Mki
 
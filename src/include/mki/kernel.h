@@ -16,6 +16,8 @@
 #include "mki/launch_param.h"
 #include "mki/run_info.h"
 #include "mki/kernel_info.h"
+#include "mki/kernel_pool.h"
+#include "mki/tiling_cache.h"
 #include "mki/utils/status/status.h"
 
 namespace Mki {
@@ -51,6 +53,15 @@ public:
     virtual std::string GetName() const = 0;
     virtual const KernelInfo &GetKernelInfo() const = 0;
     virtual KernelType GetType() const = 0;
+
+    // appended with defaults, so op libraries built against the original interface keep their vtable layout
+    virtual void SetArgsFrozen(bool flag) { (void)flag; }
+    virtual void SetTilingCacheCapacity(size_t capacity) { (void)capacity; }
+    virtual TilingCacheStats GetTilingCacheStats() const { return TilingCacheStats(); }
+    // nullptr when the kernel has no instance pool, its instances are cloned and deleted
+    virtual KernelPool *GetKernelPool() const { return nullptr; }
+    // kernels that do not keep their buffers in KernelInfo ignore the allocator
+    virtual void SetHostAllocator(HostAllocator *allocator) { (void)allocator; }
 };
 } // namespace Mki
 #endif
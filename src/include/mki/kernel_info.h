@@ -13,7 +13,10 @@
 #define MKI_KERNEL_INFO_H
 
 #include <cstdint>
+#include <vector>
+#include "mki/utils/allocator/host_allocator.h"
 #include "mki/utils/non_copyable/non_copyable.h"
+#include "mki/utils/rt/base/types.h"
 #include "mki/utils/status/status.h"
 #include "mki/utils/SVector/SVector.h"
 
@@ -44,6 +47,31 @@ struct TensorListExtInfo {
     uint64_t tensorListSize = 0;
 };
 
+enum class ArgsPatchType : uint32_t {
+    INPUT = 0,  // in tensor data
+    OUTPUT,     // out tensor data
+    WORKSPACE,  // scratch device addr + addrOffset
+    TILING,     // tiling device addr + addrOffset, only when launch without tiling
+};
+
+struct ArgsPatchInfo {
+    uint64_t argOffset = 0; // byte offset of the pointer slot in args
+    ArgsPatchType type = ArgsPatchType::INPUT;
+    uint64_t tensorIdx = 0;
+    uint64_t addrOffset = 0;
+};
+
+// args image resolved by the first Run after Init, later Runs only patch the recorded slots
+struct FrozenArgsInfo {
+    bool valid = false;
+    uint64_t argsNum = 0;
+    size_t inTensorCount = 0;
+    size_t outTensorCount = 0;
+    RtArgsExT argsEx;
+    std::vector<RtHostInputInfoT> hostInputInfos;
+    std::vector<ArgsPatchInfo> patchInfos;
+};
+
 public:
     KernelInfo() = default;
     ~KernelInfo();
@@ -52,6 +80,10 @@ public:
 
 public:
     void Reset();
+    // HostAllocator, args/tiling/tensorList buffers are kept by Reset and reused by the next Init
+    void SetHostAllocator(HostAllocator *allocator);
+    HostAllocator *GetHostAllocator() const;
+
     // Args
     Status InitArgs(uint64_t len);
     uint8_t *GetArgs() const;
@@ -116,8 +148,23 @@ public:
     void SetMemsetInfo(uint64_t argIdx, uint64_t size);
     const MiniVector<KernelInfo::MemsetInfo> &GetMemsetInfo() const;
 
+    // FrozenArgs
+    void SetArgsFrozen(bool flag);
+    bool GetArgsFrozen() const;
+    FrozenArgsInfo &GetFrozenArgsInfo();
+    const FrozenArgsInfo &GetFrozenArgsInfo() const;
+
+private:
+struct HostBuffer {
+    uint8_t *addr = nullptr;
+    uint64_t capacity = 0;
+};
+
 private:
+    uint8_t *AcquireHostBuffer(HostBuffer &buffer, uint64_t len);
+    void ReleaseHostBuffer(HostBuffer &buffer);
     void ResetArgs();
+    void ResetFrozenArgsInfo();
     void ResetTilingInfo();
     void ResetTensorListExtInfo();
     void ResetConstTensorInfo();
@@ -130,12 +177,18 @@ private:
     bool initFlag_{false};  // kernel info 线程间不共享
     bool launchWithTiling_{true};
     bool launchWithTensorlist_{false};
+    bool argsFrozen_{false};
     int64_t hwsyncIdx_ = -1; // < 0: no hwsync, >= 0: hwsync arg idx
     TilingExtInfo tilingExtInfo_;
     TensorListExtInfo tensorListExtInfo_;
     MiniVector<ConstTensorInfo> constTensorInfo_;
     MiniVector<uint64_t> scratchSizes_;
     MiniVector<MemsetInfo> memsetInfo_;
+    FrozenArgsInfo frozenArgsInfo_;
+    HostAllocator *hostAllocator_ = GetDefaultHostAllocator();
+    HostBuffer argsBuffer_;
+    HostBuffer tilingBuffer_;
+    HostBuffer tensorListBuffer_;
 };
 } // namespace Mki
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_KERNEL_POOL_H
+#define MKI_KERNEL_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "mki/utils/non_copyable/non_copyable.h"
+
+namespace Mki {
+class Kernel;
+class KernelPool;
+
+struct KernelPoolStats {
+    uint64_t acquireCount = 0;
+    uint64_t createCount = 0;    // pool is empty, a new instance is cloned from the prototype
+    uint64_t localHitCount = 0;  // served by the idle list of the calling thread's shard
+    uint64_t releaseCount = 0;
+    uint64_t dropCount = 0;      // released while the pool is full, the instance is deleted
+    size_t idleCount = 0;
+    size_t inUseCount = 0;
+    size_t idleHighWater = 0;
+    size_t inUseHighWater = 0;
+    size_t capacity = 0;
+};
+
+struct KernelPoolDeleter {
+    KernelPool *pool = nullptr;
+    void operator()(Kernel *kernel) const;
+};
+
+// kernel released by PooledKernel goes back to its pool instead of being deleted
+using PooledKernel = std::unique_ptr<Kernel, KernelPoolDeleter>;
+
+// recycles clones of one prototype kernel, idle instances keep their KernelInfo buffers
+class KernelPool : public NonCopyable {
+public:
+    explicit KernelPool(const Kernel *prototype);
+    ~KernelPool();
+
+    Kernel *Acquire();
+    void Release(Kernel *kernel);
+    PooledKernel AcquireScoped();
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const;
+    void Clear();
+    KernelPoolStats GetStats() const;
+
+private:
+    Kernel *PopIdle(size_t shardIdx);
+    void RecycleKernel(Kernel *kernel) const;
+    static size_t GetThreadShardIdx();
+    static void UpdateHighWater(std::atomic<size_t> &highWater, size_t value);
+
+private:
+    static constexpr size_t SHARD_NUM = 8;
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<Kernel *> idleKernels;
+    };
+    const Kernel *prototype_ = nullptr;
+    Shard shards_[SHARD_NUM];
+    std::atomic<size_t> capacity_;
+    std::atomic<size_t> idleCount_{0};
+    std::atomic<size_t> inUseCount_{0};
+    std::atomic<size_t> idleHighWater_{0};
+    std::atomic<size_t> inUseHighWater_{0};
+    std::atomic<uint64_t> acquireCount_{0};
+    std::atomic<uint64_t> createCount_{0};
+    std::atomic<uint64_t> localHitCount_{0};
+    std::atomic<uint64_t> releaseCount_{0};
+    std::atomic<uint64_t> dropCount_{0};
+};
+} // namespace Mki
+
+#endif
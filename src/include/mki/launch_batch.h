@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_LAUNCH_BATCH_H
+#define MKI_LAUNCH_BATCH_H
+
+#include <vector>
+#include "mki/kernel.h"
+#include "mki/launch_param.h"
+#include "mki/run_info.h"
+#include "mki/utils/status/status.h"
+
+namespace Mki {
+struct LaunchBatchItem {
+    Kernel *kernel = nullptr; // initialized with launchParam
+    const LaunchParam *launchParam = nullptr;
+    const RunInfo *runInfo = nullptr;
+};
+
+/**
+ Launch prepared kernels in order with one backend call.
+ The args of all kernels are built into one contiguous host buffer and submitted by MkiRtFunctionLaunchBatch.
+ All items must use the same stream. The batch is split where a kernel clears tensors before its launch, so
+ the memset keeps its place in the stream. Kernels that are not KernelBase, and every kernel while a
+ LaunchGraph is capturing, are run one by one through Kernel::Run.
+*/
+Status LaunchBatch(const std::vector<LaunchBatchItem> &items);
+} // namespace Mki
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_LAUNCH_GRAPH_H
+#define MKI_LAUNCH_GRAPH_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "mki/bin_handle.h"
+#include "mki/kernel_info.h"
+#include "mki/launch_param.h"
+#include "mki/run_info.h"
+#include "mki/utils/rt/base/types.h"
+#include "mki/utils/non_copyable/non_copyable.h"
+#include "mki/utils/status/status.h"
+
+namespace Mki {
+/**
+ Launch sequence captured from KernelBase::Run.
+ Kernels run on the capturing thread between BeginCapture and EndCapture are launched as usual and
+ recorded with their resolved args, so Replay launches the same sequence without Init, tiling or args
+ building. Tensor and workspace addresses are rebound by UpdateAddress, scalars in the tiling data by
+ UpdateTiling. When the backend supports task capture, Replay executes a runtime model built from the
+ nodes, otherwise the nodes are launched one by one. Events between streams are not captured, nor are
+ tensors cleared by aclrtMemset when no memset kernel is registered. Clear and a model rebuild wait for
+ the replays still running, on whatever streams they were given.
+*/
+class LaunchGraph : public NonCopyable {
+public:
+    LaunchGraph() = default;
+    ~LaunchGraph();
+
+    Status BeginCapture();
+    Status EndCapture();
+    bool IsCapturing() const;
+    void Clear();
+    size_t GetNodeCount() const;
+    const std::string &GetNodeName(size_t nodeIdx) const;
+
+    // rebind tensor and workspace slots captured with base address oldAddr, returns the slot count
+    size_t UpdateAddress(const void *oldAddr, void *newAddr);
+    // overwrite size bytes of the tiling data of a node at offset
+    Status UpdateTiling(size_t nodeIdx, uint64_t offset, const void *data, uint64_t size);
+    // launch on stream, nullptr means the streams used in capture
+    Status Replay(MkiRtStream stream = nullptr);
+    // replay through runtime task capture when supported, on by default
+    void SetNativeCapture(bool flag);
+    bool IsNativeModelReady() const;
+
+    // graph capturing on the calling thread, nullptr when none
+    static LaunchGraph *GetCapturing();
+    // used by KernelBase: tiling device memory that lives as long as the graph
+    uint8_t *AddTiling(const uint8_t *hostTiling, uint64_t size, MkiRtStream stream);
+    void AddNode(const BinHandle *handle, const std::string &name, const MkiRtKernelParam &kernelParam,
+                 const KernelInfo::FrozenArgsInfo &argsInfo, const MiniVector<KernelInfo::MemsetInfo> &memsetInfo,
+                 const LaunchParam &launchParam, const RunInfo &runInfo);
+
+private:
+    struct AddrSlot {
+        uint64_t argOffset = 0;
+        uint8_t *base = nullptr;
+        uint64_t addrOffset = 0;
+    };
+    struct Node {
+        const BinHandle *handle = nullptr;
+        std::string name;
+        MkiRtStream stream = nullptr;
+        uint64_t tilingId = 0;
+        uint32_t blockDim = 0;
+        uint64_t argsNum = 0;
+        std::vector<uint8_t> args;
+        std::vector<RtHostInputInfoT> hostInputInfos;
+        RtArgsExT argsEx;
+        std::vector<AddrSlot> addrSlots;
+        MiniVector<KernelInfo::MemsetInfo> memsetInfo;
+        uint8_t *tilingDeviceAddr = nullptr; // set when the tiling is not in args
+        uint64_t tilingSize = 0;
+    };
+
+    Status LaunchNodes(MkiRtStream stream);
+    Status LaunchNode(Node &node, MkiRtStream stream) const;
+    Status BuildNativeModel(MkiRtStream stream);
+    void DestroyNativeModel();
+    // stream nullptr means the streams used in capture
+    void RecordReplay(MkiRtStream stream);
+    void WaitReplays();
+
+private:
+    bool capturing_ = false;
+    std::vector<Node> nodes_;
+    std::vector<std::pair<uint8_t *, uint64_t>> tilingBuffers_; // device tiling and its size
+    bool nativeCapture_ = true;
+    bool nativeUnsupported_ = false;
+    bool hostMemset_ = false; // a node clears tensors by aclrtMemset, which can not be captured
+    MkiRtModel nativeModel_ = nullptr;
+    bool nativeModelDirty_ = false;
+    // event after the last replay on each stream, waited before the model or the tiling is freed
+    std::vector<std::pair<MkiRtStream, MkiRtEvent>> replayEvents_;
+};
+} // namespace Mki
+
+#endif
@@ -37,6 +37,7 @@ public:
     virtual const KernelList &GetKernelList() const = 0;
     virtual Kernel *GetBestKernel(const LaunchParam &launchParam) const = 0;
     virtual Kernel *GetKernelByName(const std::string &kernelName) const = 0;
+    virtual PooledKernel AcquireKernelByName(const std::string &kernelName) const = 0;
 };
 } // namespace Mki
 
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_STREAM_SCHEDULER_H
+#define MKI_STREAM_SCHEDULER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mki/kernel.h"
+#include "mki/launch_param.h"
+#include "mki/operation.h"
+#include "mki/utils/rt/base/types.h"
+#include "mki/utils/non_copyable/non_copyable.h"
+#include "mki/utils/status/status.h"
+
+namespace Mki {
+struct StreamSchedulerStats {
+    uint64_t runCount = 0;
+    uint64_t launchCount = 0;
+    uint64_t sideLaunchCount = 0;    // launches on pool streams, they can overlap the stream given to Run
+    uint64_t eventWaitCount = 0;     // stream waits at dependencies, fork and join included
+    uint32_t nodeCount = 0;
+    uint32_t streamsUsed = 0;        // streams used by the schedule, the stream given to Run included
+    uint32_t criticalPathLength = 0; // nodes on the longest dependency chain
+
+    // node count / critical path length, 1 means the nodes form a chain and nothing overlaps
+    double Parallelism() const;
+};
+
+/**
+ Runs a small DAG of operations on a pool of streams.
+ Nodes are added in program order, a node depends on the earlier nodes whose out tensors it reads or
+ writes and whose in tensors it overwrites, matched by tensor memory ranges. Independent branches are
+ assigned to different streams and events are only waited at dependencies between streams. The first
+ stream of the pool is the stream given to Run: the branches start after the work queued on it before
+ Run, and it waits for all branches at the end. Not thread safe.
+*/
+class StreamScheduler : public NonCopyable {
+public:
+    static constexpr uint32_t DEFAULT_STREAM_NUM = 4;
+
+    // streamNum streams at most, the stream given to Run included
+    explicit StreamScheduler(uint32_t streamNum = DEFAULT_STREAM_NUM);
+    ~StreamScheduler();
+
+    // selects and initializes the best kernel of op for launchParam, out tensors must be inferred
+    Status AddNode(const Operation &op, const LaunchParam &launchParam, size_t *nodeIdx = nullptr);
+    // orders two nodes without a shared tensor, from must be added before to
+    Status AddDependency(size_t from, size_t to);
+    void Clear();
+    size_t GetNodeCount() const;
+    const std::vector<size_t> &GetNodeDependencies(size_t nodeIdx) const;
+    // index in the stream pool, 0 is the stream given to Run, the schedule is planned as nodes are added
+    uint32_t GetNodeStream(size_t nodeIdx) const;
+
+    // on a failed launch the stream still waits for the work already queued on pool streams
+    Status Run(MkiRtStream stream);
+    StreamSchedulerStats GetStats() const;
+
+private:
+    struct Node {
+        std::string name;
+        LaunchParam launchParam;
+        std::unique_ptr<Kernel> kernel;
+        std::vector<size_t> deps;
+        uint32_t stream = 0;
+        uint32_t depth = 0;
+        std::vector<size_t> waits;  // nodes on other streams waited before the launch
+        bool waitFork = false;      // first node of a pool stream, waits for the work before Run
+        bool recordEvent = false;   // another stream waits for the node
+        MkiRtEvent event = nullptr;
+    };
+
+    bool DependsOn(const Node &node, const Node &other) const;
+    void Plan();
+    Status PrepareStreams();
+    Status PrepareEvents();
+    Status LaunchNode(Node &node, MkiRtStream stream) const;
+    Status LaunchNodes(std::vector<bool> &streamsTouched);
+    void JoinAfterFailure(MkiRtStream stream, const std::vector<bool> &streamsTouched);
+    Status WaitEvent(MkiRtStream stream, MkiRtEvent event);
+    void DestroyEvents();
+
+private:
+    uint32_t streamNum_ = DEFAULT_STREAM_NUM;
+    std::vector<Node> nodes_;
+    std::vector<size_t> joinWaits_; // tail nodes of pool streams waited by the stream given to Run
+    std::vector<MkiRtStream> streams_; // pool streams, index 0 is set by Run
+    MkiRtEvent forkEvent_ = nullptr;
+    std::vector<MkiRtEvent> failJoinEvents_; // per pool stream, only used when a launch fails
+    StreamSchedulerStats stats_;
+};
+} // namespace Mki
+
+#endif
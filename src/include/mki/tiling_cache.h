@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_TILING_CACHE_H
+#define MKI_TILING_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include "mki/launch_param.h"
+#include "mki/kernel_info.h"
+#include "mki/utils/any/any.h"
+#include "mki/utils/non_copyable/non_copyable.h"
+
+namespace Mki {
+// appends every field of specificParam that tiling reads to key, a launch param whose specificParam type has
+// no registered func is not cached
+using TilingCacheKeyFunc = std::function<void(const Any &, std::string &)>;
+
+class TilingCacheKey {
+public:
+    TilingCacheKey(size_t typeHashCode, TilingCacheKeyFunc func);
+    static bool Append(const Any &param, std::string &key);
+private:
+    static std::map<size_t, TilingCacheKeyFunc> &GetFuncMap();
+};
+
+// bytes of the value, floats are compared bitwise
+template <typename T> void AppendTilingCacheKey(std::string &key, const T &value)
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "append the fields one by one");
+    key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+inline void AppendTilingCacheKey(std::string &key, const std::string &value)
+{
+    AppendTilingCacheKey(key, value.size());
+    key.append(value);
+}
+
+struct TilingCacheStats {
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+    uint64_t bypassCount = 0; // launch param can not be used as cache key
+    uint64_t evictCount = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+// LRU cache of inited KernelInfo keyed by tensor descs and the registered key of specificParam,
+// shared by clones of one kernel
+class TilingCache : public NonCopyable {
+public:
+    TilingCache() = default;
+    ~TilingCache() = default;
+
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const;
+    bool GenerateKey(const LaunchParam &launchParam, std::string &key);
+    bool Get(const std::string &key, KernelInfo &kernelInfo);
+    void Put(const std::string &key, const KernelInfo &kernelInfo);
+    void Clear();
+    TilingCacheStats GetStats() const;
+    void ResetStats();
+
+private:
+    void EvictLocked(size_t capacity);
+
+private:
+    using Entry = std::pair<std::string, std::unique_ptr<KernelInfo>>;
+    mutable std::mutex mutex_;
+    std::atomic<size_t> capacity_{0};
+    std::list<Entry> lruList_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entryMap_;
+    TilingCacheStats stats_;
+};
+} // namespace Mki
+
+#define REG_TILING_CACHE_KEY(typename, func) \
+    static Mki::TilingCacheKey g_registerTilingCacheKey_##func(typeid(typename).hash_code(), func)
+
+#endif
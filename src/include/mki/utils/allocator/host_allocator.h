@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_ALLOCATOR_HOST_ALLOCATOR_H
+#define MKI_UTILS_ALLOCATOR_HOST_ALLOCATOR_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Mki {
+class HostAllocator {
+public:
+    HostAllocator() = default;
+    virtual ~HostAllocator() = default;
+    // return nullptr when fail, size passed to Deallocate must be the one passed to Allocate
+    virtual uint8_t *Allocate(uint64_t size) = 0;
+    virtual void Deallocate(uint8_t *addr, uint64_t size) = 0;
+};
+
+// power of 2 size classes from 256B to 64KB, larger sizes use new directly.
+// per thread free lists are only allowed for an allocator that lives until process exit
+class SlabHostAllocator : public HostAllocator {
+public:
+    static constexpr uint64_t MIN_CLASS_SIZE = 256;
+    static constexpr uint64_t MAX_CLASS_SIZE = 64 * 1024;
+    static constexpr size_t CLASS_NUM = 9;
+
+    explicit SlabHostAllocator(bool useThreadCache = false);
+    ~SlabHostAllocator() override;
+    uint8_t *Allocate(uint64_t size) override;
+    void Deallocate(uint8_t *addr, uint64_t size) override;
+    static size_t GetClassIdx(uint64_t size);
+
+private:
+    struct ThreadCache;
+    ThreadCache *GetThreadCache();
+    void FetchFromCentral(size_t classIdx, std::vector<uint8_t *> &freeList, size_t fetchNum);
+    void ReturnToCentral(size_t classIdx, std::vector<uint8_t *> &freeList, size_t keepNum);
+
+private:
+    bool useThreadCache_ = false;
+    std::mutex mutex_;
+    std::vector<uint8_t *> centralFreeLists_[CLASS_NUM];
+};
+
+// the default allocator lives until process exit, so kernels in static storage can free into it
+HostAllocator *GetDefaultHostAllocator();
+void SetDefaultHostAllocator(HostAllocator *allocator);
+} // namespace Mki
+
+#endif
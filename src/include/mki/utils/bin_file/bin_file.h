@@ -47,6 +47,19 @@ constexpr mode_t BIN_FILE_MODE = S_IRUSR | S_IWUSR | S_IRGRP;
 
  ps.Head is frome $Version to $End
 */
+enum class BinFileMapAdvice {
+    NONE = 0,   // pages are read on first access
+    POPULATE,   // MAP_POPULATE, read the whole file while mapping
+    WILLNEED,   // madvise MADV_WILLNEED on the binary data, read ahead asynchronously
+    SEQUENTIAL, // madvise MADV_SEQUENTIAL on the binary data
+};
+
+// non-owning view of an object, valid while the BinFile is alive
+struct BinObjectSpan {
+    const char *data = nullptr;
+    uint64_t length = 0;
+};
+
 class BinFile {
 struct Binary {
     uint64_t offset = 0;
@@ -56,21 +69,32 @@ struct Binary {
 public:
     BinFile();
     ~BinFile();
+    BinFile(const BinFile &) = delete;
+    BinFile &operator=(const BinFile &) = delete;
 
     Status AddAttr(const std::string &name, const std::string &value);
     Status AddObject(const std::string &name, char *binaryBuffer, uint64_t binaryLen);
 
     Status Write(const std::string &filePath, const mode_t mode = BIN_FILE_MODE);
     Status Read(const std::string &filePath);
+    // map the file privately and parse the head in place, objects point into the mapping instead of a copy,
+    // so they can be passed to MkiRtModuleCreate directly
+    Status ReadMapped(const std::string &filePath, BinFileMapAdvice advice = BinFileMapAdvice::NONE);
+    bool IsMapped() const;
 
     void GetAllAttrs(std::vector<std::pair<std::string, std::string>> &attrs);
     void GetAllObjects(std::vector<std::pair<std::string, std::pair<char *, uint64_t>>> &binaries);
+    void GetAllObjectSpans(std::vector<std::pair<std::string, BinObjectSpan>> &objects) const;
 
 private:
     bool WriteImpl(int &fd);
     bool WriteAttr(int &fd, const std::string &name, const std::string &value) const;
+    Status CheckReadPath(const std::string &filePath, std::string &realPath, int64_t &fileSize) const;
     Status ParseBinFile(std::ifstream &fd, size_t fileSize);
+    bool ParseHeadLine(const std::string &line, bool &foundAttrObjectLength, bool &matchAttrEnd);
     Status ParseSystemAttr(const std::string &attrName, const std::string &value);
+    char *GetBinariesData();
+    void Unmap();
 
 private:
     std::string version_ = "1.0";
@@ -81,6 +105,11 @@ private:
     std::set<std::string> binaryNames_;
     std::vector<std::pair<std::string, Binary>> binaries_; // <binaryName, {binaryOffset, binaryLength}>
     std::vector<char> binariesBuffer_;
+    uint64_t binariesLength_ = 0;
+
+    char *mapAddr_ = nullptr;
+    size_t mapSize_ = 0;
+    size_t mapDataOffset_ = 0; // binary data starts after the head
 };
 } // namespace Mki
 #endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_BINFILE_FUSIONBINFILE_H
+#define MKI_UTILS_BINFILE_FUSIONBINFILE_H
+#include <string>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+#include "mki/utils/status/status.h"
+#include "mki/utils/bin_file/bin_file.h"
+
+namespace Mki {
+constexpr char FUSION_BIN_MAGIC[8] = {'M', 'K', 'I', 'F', 'B', 'I', 'N', '\0'};
+constexpr uint32_t FUSION_BIN_VERSION = 1;
+constexpr uint32_t FUSION_BIN_ALIGNMENT = 64; // 64: object data alignment in the file
+
+/**
+ Composition of FusionBinFile, all fields are little endian:
+ Header (FusionBinHeader, 64 bytes)
+ Index (FusionBinEntry * entryCount), sorted by (nameHash, socHash, name, soc)
+ StringTable, names and socs of the entries, not null terminated
+ Padding to FUSION_BIN_ALIGNMENT
+ ObjectData, every object starts at an offset aligned to FUSION_BIN_ALIGNMENT
+
+ ps.headerCrc covers the header before itself, indexCrc covers index and string table,
+   every entry carries the crc32 of its object
+*/
+struct FusionBinHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint32_t reserved;
+    uint64_t indexOffset;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+    uint64_t dataOffset;
+    uint32_t indexCrc;
+    uint32_t headerCrc;
+};
+
+struct FusionBinEntry {
+    uint64_t nameHash;
+    uint64_t socHash;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t socOffset;
+    uint32_t socLength;
+    uint64_t dataOffset; // from the start of ObjectData
+    uint64_t dataLength;
+    uint32_t dataCrc;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FusionBinHeader) == 64, "FusionBinHeader layout changed"); // 64: header size of version 1
+static_assert(sizeof(FusionBinEntry) == 56, "FusionBinEntry layout changed"); // 56: entry size of version 1
+
+class FusionBinFile {
+struct Object {
+    std::string name;
+    std::string soc;
+    std::vector<char> data;
+};
+
+public:
+    FusionBinFile();
+    ~FusionBinFile();
+    FusionBinFile(const FusionBinFile &) = delete;
+    FusionBinFile &operator=(const FusionBinFile &) = delete;
+
+    Status AddObject(const std::string &name, const std::string &soc, const char *binaryBuffer, uint64_t binaryLen);
+    Status Write(const std::string &filePath, const mode_t mode = BIN_FILE_MODE);
+
+    // map the file and validate header and index, object data is only touched by Find
+    Status Read(const std::string &filePath);
+    // binary search in the index, the object crc is checked before it is returned
+    Status Find(const std::string &name, const std::string &soc, BinObjectSpan &object) const;
+    void GetSocObjects(const std::string &soc, std::vector<std::pair<std::string, BinObjectSpan>> &objects) const;
+    uint32_t GetObjectCount() const;
+
+    static uint64_t Hash(const std::string &str);
+
+private:
+    Status CheckIndex() const;
+    std::string GetEntryString(uint32_t offset, uint32_t length) const;
+    bool EntryStringEquals(uint32_t offset, uint32_t length, const std::string &str) const;
+    BinObjectSpan GetEntryObject(const FusionBinEntry &entry) const;
+    void Unmap();
+
+private:
+    std::vector<Object> objects_;
+    std::set<std::pair<std::string, std::string>> objectKeys_;
+
+    char *mapAddr_ = nullptr;
+    size_t mapSize_ = 0;
+    const FusionBinHeader *header_ = nullptr;
+    const FusionBinEntry *entries_ = nullptr;
+};
+} // namespace Mki
+#endif
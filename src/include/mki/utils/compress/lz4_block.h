@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_COMPRESS_LZ4_BLOCK_H
+#define MKI_UTILS_COMPRESS_LZ4_BLOCK_H
+#include <cstddef>
+#include <cstdint>
+
+namespace Mki {
+/**
+ Decode one LZ4 block (raw block format, no frame header) produced by scripts/build_util.py.
+ dstLen must be the exact decoded size, returns false on malformed input or size mismatch.
+*/
+bool Lz4BlockDecompress(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstLen);
+} // namespace Mki
+#endif
@@ -15,6 +15,16 @@
 #include "mki/utils/log/log_core.h"
 #include "mki/utils/log/log_sink.h"
 #include "mki/utils/log/log_entity.h"
+#include "mki/utils/log/log_rate_limiter.h"
+
+// statements below MKI_MIN_LOG_LEVEL (0 TRACE ... 5 FATAL) are compiled out
+#ifndef MKI_MIN_LOG_LEVEL
+#define MKI_MIN_LOG_LEVEL 0
+#endif
+
+#define MKI_LOG_ON(level)                                                                                        \
+    if constexpr (static_cast<int>(Mki::LogLevel::level) >= MKI_MIN_LOG_LEVEL)                                   \
+    if (Mki::LogCore::IsLogLevelEnabled(Mki::LogLevel::level))
 
 #define MKI_LOG(level) MKI_LOG_##level
 
@@ -24,42 +34,62 @@
     if (condition)                                                                                               \
     MKI_LOG(level)
 
+// log the 1st, (n+1)th, (2n+1)th ... time this callsite is reached
+#define MKI_LOG_EVERY_N(level, n)                                                                                \
+    MKI_LOG_ON(level)                                                                                            \
+    if (static std::atomic<uint64_t> mkiLogCounter{0}; Mki::LogEveryN(mkiLogCounter, (n)))                       \
+    MKI_LOG_STREAM(level)
+
+// log only the first n times this callsite is reached
+#define MKI_LOG_FIRST_N(level, n)                                                                                \
+    MKI_LOG_ON(level)                                                                                            \
+    if (static std::atomic<uint64_t> mkiLogCounter{0}; Mki::LogFirstN(mkiLogCounter, (n)))                       \
+    MKI_LOG_STREAM(level)
+
+// log at most once every ms milliseconds at this callsite
+#define MKI_LOG_EVERY_MS(level, ms)                                                                              \
+    MKI_LOG_ON(level)                                                                                            \
+    if (static std::atomic<int64_t> mkiLogLastMs{0}; Mki::LogEveryMs(mkiLogLastMs, (ms)))                        \
+    MKI_LOG_STREAM(level)
+
+#define MKI_LOG_STREAM(level) Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::level)
+
 #define MKI_LOG_TRACE                                                                                            \
-    if (Mki::LogLevel::TRACE >= Mki::LogCore::Instance().GetLogLevel())                                          \
+    MKI_LOG_ON(TRACE)                                                                                            \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::TRACE)
 #define MKI_LOG_DEBUG                                                                                            \
-    if (Mki::LogLevel::DEBUG >= Mki::LogCore::Instance().GetLogLevel())                                          \
+    MKI_LOG_ON(DEBUG)                                                                                            \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::DEBUG)
 #define MKI_LOG_INFO                                                                                             \
-    if (Mki::LogLevel::INFO >= Mki::LogCore::Instance().GetLogLevel())                                           \
+    MKI_LOG_ON(INFO)                                                                                             \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::INFO)
 #define MKI_LOG_WARN                                                                                             \
-    if (Mki::LogLevel::WARN >= Mki::LogCore::Instance().GetLogLevel())                                           \
+    MKI_LOG_ON(WARN)                                                                                             \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::WARN)
 #define MKI_LOG_ERROR                                                                                            \
-    if (Mki::LogLevel::ERROR >= Mki::LogCore::Instance().GetLogLevel())                                          \
+    MKI_LOG_ON(ERROR)                                                                                            \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::ERROR)
 #define MKI_LOG_FATAL                                                                                            \
-    if (Mki::LogLevel::FATAL >= Mki::LogCore::Instance().GetLogLevel())                                          \
+    MKI_LOG_ON(FATAL)                                                                                            \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::FATAL)
 
 #define MKI_FLOG_TRACE(format, ...)                                                                              \
-    if (Mki::LogLevel::TRACE >= Mki::LogCore::Instance().GetLogLevel())                                          \
+    MKI_LOG_ON(TRACE)                                                                                            \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::TRACE).Format(format, __VA_ARGS__)
 #define MKI_FLOG_DEBUG(format, ...)                                                                              \
-    if (Mki::LogLevel::DEBUG >= Mki::LogCore::Instance().GetLogLevel())                                          \
+    MKI_LOG_ON(DEBUG)                                                                                            \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::DEBUG).Format(format, __VA_ARGS__)
 #define MKI_FLOG_INFO(format, ...)                                                                               \
-    if (Mki::LogLevel::INFO >= Mki::LogCore::Instance().GetLogLevel())                                           \
+    MKI_LOG_ON(INFO)                                                                                             \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::INFO).Format(format, __VA_ARGS__)
 #define MKI_FLOG_WARN(format, ...)                                                                               \
-    if (Mki::LogLevel::WARN >= Mki::LogCore::Instance().GetLogLevel())                                           \
+    MKI_LOG_ON(WARN)                                                                                             \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::WARN).Format(format, __VA_ARGS__)
 #define MKI_FLOG_ERROR(format, ...)                                                                              \
-    if (Mki::LogLevel::ERROR >= Mki::LogCore::Instance().GetLogLevel())                                          \
+    MKI_LOG_ON(ERROR)                                                                                            \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::ERROR).Format(format, __VA_ARGS__)
 #define MKI_FLOG_FATAL(format, ...)                                                                              \
-    if (Mki::LogLevel::FATAL >= Mki::LogCore::Instance().GetLogLevel())                                          \
+    MKI_LOG_ON(FATAL)                                                                                            \
     Mki::LogStream(__FILE__, __LINE__, __FUNCTION__, Mki::LogLevel::FATAL).Format(format, __VA_ARGS__)
 
 #endif
@@ -11,10 +11,12 @@
  */
 #ifndef MKI_UTILS_LOG_LOG_CORE_H
 #define MKI_UTILS_LOG_LOG_CORE_H
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "mki/utils/log/log_entity.h"
 #include "mki/utils/log/log_sink.h"
+#include "mki/utils/log/log_rate_limiter.h"
 #include "mki/utils/SVector/SVector.h"
 
 namespace Mki {
@@ -24,15 +26,43 @@ public:
     virtual ~LogCore() = default;
     static LogCore &Instance();
     LogLevel GetLogLevel() const;
+    // level check of MKI_LOG, the level of Instance() is cached in an atomic
+    static bool IsLogLevelEnabled(LogLevel level)
+    {
+        int cachedLevel = cachedLogLevel_.load(std::memory_order_relaxed);
+        if (__builtin_expect(cachedLevel < 0, 0)) {
+            cachedLevel = static_cast<int>(Instance().GetLogLevel());
+        }
+        return __builtin_expect(static_cast<int>(level) >= cachedLevel, 0);
+    }
     void SetLogLevel(LogLevel level);
     void Log(const char *log, uint64_t logLen);
+    // rate limit check shared by one log written to both text and structured sinks
+    bool AcquireLogToken();
+    bool HasTextSink() const;
+    bool HasStructuredSink() const;
+    // write to non structured sinks only, the caller has acquired the log token
+    void LogText(const char *log, uint64_t logLen);
+    void LogStructured(const LogEntity &entity, const char *format, va_list args);
+    // at most ratePerSecond logs with bursts of burst logs are written, 0 means unlimited
+    void SetLogRateLimit(uint64_t ratePerSecond, uint64_t burst);
+    uint64_t GetSuppressedLogCount() const;
     void DeleteLogFileSink();
     void AddSink(std::shared_ptr<LogSink> sink);
     const std::vector<std::shared_ptr<LogSink>> &GetAllSinks() const;
 
+private:
+    static std::atomic<int> cachedLogLevel_;
+    void LogSuppressedCount(uint64_t suppressedCount);
+    void UpdateSinkFlags();
+
 private:
     std::vector<std::shared_ptr<LogSink>> sinks_;
+    LogRateLimiter rateLimiter_;
     LogLevel level_ = LogLevel::INFO;
+    bool isInstance_ = false;
+    bool hasTextSink_ = false;
+    bool hasStructuredSink_ = false;
 };
 } // namespace Mki
 #endif
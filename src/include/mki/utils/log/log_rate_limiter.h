@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_LOG_LOG_RATE_LIMITER_H
+#define MKI_UTILS_LOG_LOG_RATE_LIMITER_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace Mki {
+inline int64_t GetLogSteadyTimeMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// per callsite sampling used by MKI_LOG_EVERY_N, MKI_LOG_FIRST_N and MKI_LOG_EVERY_MS
+inline bool LogEveryN(std::atomic<uint64_t> &counter, uint64_t n)
+{
+    return n <= 1 || counter.fetch_add(1, std::memory_order_relaxed) % n == 0;
+}
+
+inline bool LogFirstN(std::atomic<uint64_t> &counter, uint64_t n)
+{
+    return counter.load(std::memory_order_relaxed) < n && counter.fetch_add(1, std::memory_order_relaxed) < n;
+}
+
+inline bool LogEveryMs(std::atomic<int64_t> &lastMs, int64_t intervalMs)
+{
+    int64_t nowMs = GetLogSteadyTimeMs();
+    int64_t last = lastMs.load(std::memory_order_relaxed);
+    return (last == 0 || nowMs - last >= intervalMs) &&
+           lastMs.compare_exchange_strong(last, nowMs, std::memory_order_relaxed);
+}
+
+// token bucket shared by all logs of LogCore, rate 0 means unlimited
+class LogRateLimiter {
+public:
+    LogRateLimiter() = default;
+    ~LogRateLimiter() = default;
+    void SetRate(uint64_t ratePerSecond, uint64_t burst);
+    uint64_t GetRate() const;
+    bool Enabled() const;
+    // suppressedCount is set to the number of suppressed logs to report, at most once per second
+    bool Acquire(uint64_t &suppressedCount);
+    uint64_t GetSuppressedTotal() const;
+
+private:
+    std::atomic<uint64_t> rate_{0};
+    std::mutex mutex_;
+    uint64_t burst_ = 0;
+    double tokens_ = 0;
+    int64_t lastRefillMs_ = 0;
+    int64_t lastReportMs_ = 0;
+    uint64_t unreportedCount_ = 0;
+    std::atomic<uint64_t> suppressedTotal_{0};
+};
+} // namespace Mki
+#endif
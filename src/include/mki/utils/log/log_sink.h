@@ -11,6 +11,8 @@
  */
 #ifndef MKI_UTILS_LOG_LOG_SINK_H
 #define MKI_UTILS_LOG_LOG_SINK_H
+#include <cstdarg>
+#include <sys/uio.h>
 #include "mki/utils/log/log_entity.h"
 
 namespace Mki {
@@ -19,6 +21,23 @@ public:
     LogSink() = default;
     virtual ~LogSink() = default;
     virtual void Log(const char *log, uint64_t logLen) = 0;
+    // write several logs at once, each iov_base is a null terminated log
+    virtual void LogBatch(const struct iovec *iov, int iovCnt)
+    {
+        for (int i = 0; i < iovCnt; ++i) {
+            Log(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+        }
+    }
+    // fd that logs can be written to with write(2) from a crash signal handler, -1 when the sink has none
+    virtual int GetCrashFd() const { return -1; }
+    // structured sinks receive MKI_FLOG calls unrendered, other logs still go through Log
+    virtual bool IsStructured() const { return false; }
+    virtual void LogStructured(const LogEntity &entity, const char *format, va_list args)
+    {
+        (void)entity;
+        (void)format;
+        (void)args;
+    }
 };
 } // namespace Mki
 #endif
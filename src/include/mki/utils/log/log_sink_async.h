@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_LOG_LOG_SINK_ASYNC_H
+#define MKI_UTILS_LOG_LOG_SINK_ASYNC_H
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "mki/utils/log/log_sink.h"
+
+namespace Mki {
+enum class LogOverflowPolicy {
+    BLOCK = 0, // wait until the flusher frees a slot
+    DROP,      // discard the log
+    COUNT,     // discard the log and write how many logs are dropped once there is room
+};
+
+struct LogAsyncStats {
+    uint64_t enqueueCount = 0;
+    uint64_t dropCount = 0;
+    uint64_t blockCount = 0;
+    uint64_t batchCount = 0;
+};
+
+// Logs are copied into a lock-free MPSC ring and written to the inner sinks by a background thread with LogBatch.
+class LogSinkAsync : public LogSink {
+public:
+    LogSinkAsync(std::vector<std::shared_ptr<LogSink>> sinks, LogOverflowPolicy policy, size_t capacity = 4096,
+                 bool flushOnCrash = true);
+    ~LogSinkAsync() override;
+    void Log(const char *log, uint64_t logLen) override;
+    // wait until all logs enqueued before the call are written
+    void Flush();
+    LogOverflowPolicy GetOverflowPolicy() const;
+    size_t GetCapacity() const;
+    LogAsyncStats GetStats() const;
+
+private:
+    LogSinkAsync(const LogSinkAsync &) = delete;
+    const LogSinkAsync &operator=(const LogSinkAsync &) = delete;
+    bool TryEnqueue(const char *log, uint64_t logLen);
+    size_t Drain();
+    void WriteOnCrash();
+    void WriteDropReport();
+    void FlushThread();
+    static void InstallCrashHandler();
+    static void CrashHandler(int sig);
+
+private:
+    static constexpr size_t SLOT_SIZE = 512;
+    static constexpr size_t SLOT_DATA_SIZE = SLOT_SIZE - sizeof(uint64_t) * 2 - sizeof(char *);
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};
+        uint64_t len = 0;
+        char *largeData = nullptr; // logs longer than SLOT_DATA_SIZE
+        char data[SLOT_DATA_SIZE];
+    };
+
+    std::vector<std::shared_ptr<LogSink>> sinks_;
+    LogOverflowPolicy policy_ = LogOverflowPolicy::BLOCK;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> enqueuePos_{0};
+    alignas(64) std::atomic<uint64_t> dequeuePos_{0};
+    std::atomic<uint64_t> enqueueCount_{0};
+    std::atomic<uint64_t> dropCount_{0};
+    std::atomic<uint64_t> unreportedDropCount_{0};
+    std::atomic<uint64_t> blockCount_{0};
+    std::atomic<uint64_t> batchCount_{0};
+    std::mutex drainMutex_; // Flush and the flusher thread both drain
+    // held by Drain, the crash handler takes it without locks and keeps it once it writes the ring itself
+    std::atomic_flag drainBusy_ = ATOMIC_FLAG_INIT;
+    std::mutex mutex_;
+    std::condition_variable flushCv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+} // namespace Mki
+#endif
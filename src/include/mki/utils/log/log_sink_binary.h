@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_LOG_LOG_SINK_BINARY_H
+#define MKI_UTILS_LOG_LOG_SINK_BINARY_H
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mki/utils/log/log_sink.h"
+
+namespace Mki {
+// Binary log layout, all integers are little endian:
+//   file header:   "MKIBLOG\0", u32 version
+//   CALLSITE:      u8 type, u32 id, u8 level, u32 line, str16 file, str16 func, str16 format, u8 argc, u8 argTypes[]
+//   FORMAT:        u8 type, u32 id, u64 time(us), u32 tid, raw args
+//   TEXT:          u8 type, u32 len, text with header and '\n'
+//   RENDERED:      u8 type, u32 id, u64 time(us), u32 tid, str16 content, used when the format can not be encoded
+// str16 is u16 len followed by the bytes. Every file starts with all callsites defined so far, so a rotated file
+// can be decoded alone by scripts/mki_log_decoder.py.
+enum class LogRecordType : uint8_t { CALLSITE = 1, FORMAT, TEXT, RENDERED };
+
+enum class LogArgType : uint8_t {
+    INT = 0, // 4 bytes, int/short/char after promotion
+    LONG,    // 8 bytes, l/ll/j/z/t length modifiers
+    DOUBLE,  // 8 bytes
+    STRING,  // str16
+    POINTER, // 8 bytes
+};
+
+constexpr char BINARY_LOG_MAGIC[8] = {'M', 'K', 'I', 'B', 'L', 'O', 'G', '\0'};
+constexpr uint32_t BINARY_LOG_VERSION = 1;
+
+// MKI_FLOG calls are written as a callsite id plus raw arguments, the format string, file and line are written
+// once per callsite. Records are buffered and written to the output sink in chunks, at least once per second with
+// the default file output, whose maintenance thread flushes idle buffers. Other outputs are written when records
+// arrive or on Flush. Calls past the callsite limit are written as TEXT records with the text log header.
+class LogSinkFile;
+
+class LogSinkBinary : public LogSink {
+public:
+    // write to <log dir>/<boost type>_<pid>_<time>.binlog
+    LogSinkBinary();
+    explicit LogSinkBinary(std::shared_ptr<LogSink> output, size_t bufferSize = 65536);
+    ~LogSinkBinary() override;
+    bool IsStructured() const override { return true; }
+    void Log(const char *log, uint64_t logLen) override;
+    void LogStructured(const LogEntity &entity, const char *format, va_list args) override;
+    void Flush();
+    // magic, version and all callsite records
+    std::string GetFileHeader() const;
+    size_t GetCallsiteCount() const;
+
+private:
+    LogSinkBinary(const LogSinkBinary &) = delete;
+    const LogSinkBinary &operator=(const LogSinkBinary &) = delete;
+
+    struct CallsiteKey {
+        const char *format = nullptr;
+        const char *fileName = nullptr;
+        int line = 0;
+        bool operator==(const CallsiteKey &other) const
+        {
+            return format == other.format && fileName == other.fileName && line == other.line;
+        }
+    };
+    struct CallsiteKeyHash {
+        size_t operator()(const CallsiteKey &key) const
+        {
+            return std::hash<const void *>()(key.format) ^ (std::hash<const void *>()(key.fileName) << 1) ^
+                   static_cast<size_t>(key.line);
+        }
+    };
+    struct Callsite {
+        uint32_t id = 0;
+        bool encodable = false;
+        std::vector<uint8_t> argTypes; // parsed types, LONG_DOUBLE is kept apart from DOUBLE for va_arg
+    };
+
+    const Callsite *GetCallsite(const LogEntity &entity, const char *format);
+    bool NeedFlush(LogLevel level);
+
+private:
+    std::shared_ptr<LogSink> output_;
+    LogSinkFile *fileOutput_ = nullptr; // output_ of the default constructor, it calls back into this sink
+    size_t bufferSize_ = 0;
+    mutable std::mutex mutex_;
+    std::string buffer_;
+    std::unordered_map<CallsiteKey, Callsite, CallsiteKeyHash> callsites_;
+    int64_t lastFlushMs_ = 0;
+    mutable std::mutex defsMutex_;
+    std::string defs_;
+    size_t defCount_ = 0;
+    std::mutex writeMutex_;
+    std::string writeBuffer_;
+};
+} // namespace Mki
+#endif
@@ -12,24 +12,50 @@
 #ifndef MKI_UTILS_LOG_LOG_SINK_FILE_H
 #define MKI_UTILS_LOG_LOG_SINK_FILE_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <mutex>
+#include <string>
+#include <thread>
 #include "mki/utils/log/log_sink.h"
 
 namespace Mki {
+// Files are rotated by swapping to a spare file prepared by a maintenance thread, which also deletes the oldest
+// files and refreshes the free disk space, so logging threads never scan the log dir.
 class LogSinkFile : public LogSink {
 public:
-    LogSinkFile();
+    explicit LogSinkFile(const std::string &fileSuffix = ".log");
     ~LogSinkFile() override;
+    // the returned bytes are written at the beginning of every new log file
+    void SetFileHeaderGenerator(std::function<std::string()> generator);
+    // rotate when a file reaches maxFileSize bytes and keep at most maxFileCount files in the log dir
+    void SetRotation(uint64_t maxFileSize, size_t maxFileCount);
+    // task run by the maintenance thread about every intervalMs, it may log to this sink. When the call returns
+    // the previous task is not running, so an owner clears its task with nullptr before it is destructed.
+    void SetPeriodicTask(std::function<void()> task, int64_t intervalMs);
     void Log(const char *log, uint64_t logLen) override;
+    void LogBatch(const struct iovec *iov, int iovCnt) override;
+    int GetCrashFd() const override;
 
 private:
     LogSinkFile(const LogSinkFile &) = delete;
     const LogSinkFile &operator=(const LogSinkFile &) = delete;
+    bool PrepareFile(uint64_t logLen);
     void Init();
     void OpenFile();
-    void DeleteOldestFile();
+    void SwapToSpareFile();
+    void WriteFileHeader();
+    int CreateLogFile(std::string &filePath);
     std::string GetNewLogFilePath();
+    void StartMaintainThread();
+    void MaintainThread();
+    void ScanLogDir();
+    void DeleteOldestFile();
+    void PrepareSpareFile();
+    void UpdateDiskAvailable();
     bool IsDiskAvailable();
     void MakeLogDir();
     void CloseFile();
@@ -38,10 +64,32 @@ private:
 private:
     std::string boostType_;
     std::string logDir_;
+    std::string fileSuffix_;
+    std::function<std::string()> fileHeaderGenerator_;
     bool isFlush_ = false;
     int currentFd_ = -1;
+    std::atomic<int> crashFd_{-1}; // copy of currentFd_ read by the crash handler without mutex_
     uint64_t currentFileSize_ = 0;
+    std::atomic<uint64_t> maxFileSize_{0};
+    std::atomic<size_t> maxFileCount_{0};
     std::mutex mutex_;
+
+    // state shared with the maintenance thread, lock order is mutex_ then maintainMutex_
+    std::mutex maintainMutex_;
+    std::condition_variable maintainCond_;
+    std::thread maintainThread_;
+    bool stopMaintain_ = false;
+    bool maintainRequested_ = false;
+    bool logDirScanned_ = false;
+    std::atomic<int64_t> periodicIntervalMs_{0};
+    std::mutex periodicTaskMutex_; // held while the task runs, taken before mutex_
+    std::function<void()> periodicTask_;
+    int spareFd_ = -1;
+    std::string spareFilePath_;
+    uint64_t lastFileStamp_ = 0;
+    std::deque<std::string> fileIndex_; // oldest first, the current file is the last one
+    std::atomic<uint64_t> availableSize_{0};
+    std::atomic<uint64_t> writtenSinceStat_{0};
 };
 } // namespace Mki
 #endif
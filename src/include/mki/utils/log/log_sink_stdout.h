@@ -20,6 +20,7 @@ public:
     LogSinkStdout() = default;
     ~LogSinkStdout() override = default;
     void Log(const char *log, uint64_t logLen) override;
+    int GetCrashFd() const override;
 
 private:
     std::mutex mtx_;
@@ -15,20 +15,33 @@
 #include "mki/utils/log/log_entity.h"
 
 namespace Mki {
+constexpr size_t MAX_LOG_HEADER_LEN = 256;
+
+// "[time] [level] [tid] [file:line] " of a text log written by the calling thread, returns the length
+size_t FormatLogHeader(const LogEntity &entity, char *buf, size_t bufLen);
+
 class LogStream {
 public:
     LogStream(const char *filePath, int line, const char *funcName, LogLevel level);
     ~LogStream();
     template <typename T> LogStream &operator<<(const T &value)
     {
+        if (!headerWritten_) {
+            WriteHeader();
+        }
         stream_ << value;
         return *this;
     }
     void Format(const char *format, ...);
 
+private:
+    // the header is only rendered when text is produced, Format to structured sinks does not need it
+    void WriteHeader();
+
 private:
     LogEntity logEntity_;
     bool useStream_ = true;
+    bool headerWritten_ = false;
     std::ostringstream &stream_;
 };
 } // namespace Mki
@@ -17,6 +17,8 @@
 #include "mki/utils/status/status.h"
 
 namespace Mki {
+// false when no memset kernel binary is registered for the soc, ClearTensors uses aclrtMemset then
+bool HasMemsetKernel();
 Status ClearTensors(void **args, uint64_t argsNum, const MiniVector<KernelInfo::MemsetInfo> &memsetInfo, void *stream);
 } // namespace Mki
 
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_PLATFORM_PLATFORM_CONFIG_TABLE_H
+#define MKI_UTILS_PLATFORM_PLATFORM_CONFIG_TABLE_H
+
+#include <cstddef>
+
+namespace Mki {
+struct PlatformConfigItem {
+    const char *label;
+    const char *key;
+    const char *value;
+};
+
+// content of one configs/platform_configs/*.ini, items are sorted by label and key
+struct PlatformConfigTable {
+    const char *socVersion;
+    const char *fileName;
+    const PlatformConfigItem *items;
+    size_t itemCount;
+};
+
+// generated from configs/platform_configs at build time by scripts/gen_platform_config_table.py
+const PlatformConfigTable *GetBuiltinPlatformConfigTables(size_t &count);
+} // namespace Mki
+
+#endif
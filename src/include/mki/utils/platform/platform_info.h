@@ -32,9 +32,37 @@ enum class CoreType : int {
     CORE_TYPE_CUBE = 1,
 };
 
+// hardware capabilities parsed once from the platform config, read by tiling without locks or allocations
+struct PlatformCaps {
+    PlatformType platformType = PlatformType::PLATFORM_INVALID;
+    uint32_t aiCoreNum = 0;     // SoCInfo ai_core_cnt
+    uint32_t cubeCoreNum = 0;   // SoCInfo cube_core_cnt
+    uint32_t vectorCoreNum = 0; // SoCInfo vector_core_cnt
+    uint32_t coreNum[2] = {0};  // GetCoreNum result indexed by CoreType
+    uint64_t l2Size = 0;
+    uint64_t l1Size = 0;
+    uint64_t l0ASize = 0;
+    uint64_t l0BSize = 0;
+    uint64_t l0CSize = 0;
+    uint64_t ubSize = 0;
+    uint64_t hbmSize = 0;
+    bool supportL0c2out = false;
+    bool supportFixpipe = false;
+    bool cubeVectorSplit = false; // cube and vector cores are separated, such as 910B
+
+    uint32_t GetCoreNum(CoreType type) const
+    {
+        return type == CoreType::CORE_TYPE_VECTOR ? coreNum[static_cast<int>(CoreType::CORE_TYPE_VECTOR)]
+                                                  : coreNum[static_cast<int>(CoreType::CORE_TYPE_CUBE)];
+    }
+};
+
+void ParsePlatformCaps(PlatformConfigs &platformConfigs, PlatformType platformType, PlatformCaps &caps);
+
 class PlatformInfo {
 public:
     static PlatformInfo &Instance();
+    const PlatformCaps &GetPlatformCaps() const;
 
     uint32_t GetCoreNum(CoreType type);
 
@@ -56,8 +84,6 @@ private:
     void Init();
     bool Inited() const;
 
-    bool GetAicoreIntrinsic(const std::string &intrinsicName);
-
     bool inited_ = false;
 
     // platform
@@ -65,6 +91,7 @@ private:
     std::string platformName_;
 
     PlatformConfigs platformConfigs_;
+    PlatformCaps caps_;
 };
 } // namespace Mki
 
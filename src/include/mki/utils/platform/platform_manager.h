@@ -39,6 +39,7 @@ private:
     ~PlatformManager();
 
     uint32_t LoadConfigFile(std::string filePath);
+    uint32_t LoadBuiltinConfig(const std::string &socVersion);
     uint32_t LoadIniFile(std::string iniFileRealPath);
 
     void ParseVersion(PlatMapType &versionMap, std::string &socVersion) const;
@@ -56,6 +57,7 @@ private:
 
 private:
     bool initFlag_;
+    bool useBuiltinConfig_ = false;
     std::map<std::string, PlatformConfigs> platformConfigsMap_;
 };
 } // namespace Mki
@@ -35,6 +35,17 @@ public:
     virtual int StreamDestroy(MkiRtStream stream) = 0;
     virtual int StreamSynchronize(MkiRtStream stream) = 0;
     virtual int StreamGetId(MkiRtStream stream, int32_t *streamId) = 0;
+    virtual int EventCreate(MkiRtEvent *event) = 0;
+    virtual int EventDestroy(MkiRtEvent event) = 0;
+    virtual int EventRecord(MkiRtEvent event, MkiRtStream stream) = 0;
+    virtual int EventQuery(MkiRtEvent event, bool *completed) = 0;
+    virtual int EventSynchronize(MkiRtEvent event) = 0;
+    virtual int StreamWaitEvent(MkiRtStream stream, MkiRtEvent event) = 0;
+    // tasks launched on a capturing stream are recorded into the model instead of being executed
+    virtual int StreamBeginCapture(MkiRtStream stream) = 0;
+    virtual int StreamEndCapture(MkiRtStream stream, MkiRtModel *model) = 0;
+    virtual int ModelExecute(MkiRtModel model, MkiRtStream stream) = 0;
+    virtual int ModelDestroy(MkiRtModel model) = 0;
 
 public:
     virtual int MemMallocDevice(void **devPtr, uint64_t size, MkiRtMemType memType = MKIRT_MEM_DEFAULT) = 0;
@@ -62,6 +73,7 @@ public:
                                          const RtTaskCfgInfoT *cfgInfo) = 0;
     virtual int FunctionLaunchWithFlag(const void *func, const MkiRtKernelParam *param, MkiRtStream stream,
                                        const RtTaskCfgInfoT *cfgInfo) = 0;
+    virtual int FunctionLaunchBatch(const MkiRtLaunchItem *items, uint32_t count, MkiRtStream stream) = 0;
 
 public:
     virtual int GetC2cCtrlAddr(uint64_t *addr, uint32_t *len) = 0;
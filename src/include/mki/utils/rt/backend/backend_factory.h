@@ -13,11 +13,21 @@
 #define MKI_UTILS_RT_BACKEND_BACKEND_FACTORY_H
 
 #include "mki/utils/rt/backend/backend.h"
+#include "mki/utils/rt/backend/mock_backend.h"
 
 namespace Mki {
+enum class BackendType {
+    RT = 0, // npu runtime
+    MOCK,   // host only, see MockBackend
+};
+
 class BackendFactory {
 public:
     static Backend *GetBackend();
+    // default type comes from env ASDOPS_RT_BACKEND, "mock" selects the mock backend
+    static void SetBackendType(BackendType type);
+    static BackendType GetBackendType();
+    static MockBackend *GetMockBackend();
 };
 }
 
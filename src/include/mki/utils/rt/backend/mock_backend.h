@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_RT_BACKEND_MOCK_BACKEND_H
+#define MKI_UTILS_RT_BACKEND_MOCK_BACKEND_H
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "mki/utils/rt/backend/backend.h"
+
+namespace Mki {
+struct MockLaunchRecord {
+    uint64_t seq = 0;
+    std::string kernelName; // empty when func is not bound by this backend
+    const void *func = nullptr;
+    MkiRtStream stream = nullptr;
+    uint64_t tilingId = 0;
+    uint32_t blockDim = 0;
+    std::vector<uint8_t> args; // args image at launch time, includes host input data appended by KernelBase
+    uint64_t timestampNs = 0;  // steady clock when the launch is submitted
+    uint64_t launchCostNs = 0; // time spent inside the backend launch, excluded from host overhead
+};
+
+// hardware free backend, device memory is host memory, streams are synchronous and launches are only recorded,
+// launches on a capturing stream go to the model and are recorded when the model is executed
+class MockBackend : public Backend {
+public:
+    MockBackend();
+    ~MockBackend() override;
+
+public:
+    int DeviceGetCount(int32_t *devCount) override;
+    int DeviceGetIds(int32_t *devIds, int32_t devIdNum) override;
+    int DeviceGetCurrent(int32_t *devId) override;
+    int DeviceSetCurrent(int32_t devId) override;
+    int DeviceResetCurrent(int32_t devId) override;
+    int DeviceSetSocVersion(const char *version) override;
+    int DeviceGetSocVersion(char *version, uint32_t maxLen) override;
+    int DeviceGetBareTgid(uint32_t *pid) override;
+    int DeviceGetPairDevicesInfo(uint32_t devId, uint32_t otherDevId, int32_t infoType, int64_t *val) override;
+
+public:
+    int StreamCreate(MkiRtStream *stream, int32_t priority) override;
+    int StreamDestroy(MkiRtStream stream) override;
+    int StreamSynchronize(MkiRtStream stream) override;
+    int StreamGetId(MkiRtStream stream, int32_t *streamId) override;
+    int EventCreate(MkiRtEvent *event) override;
+    int EventDestroy(MkiRtEvent event) override;
+    int EventRecord(MkiRtEvent event, MkiRtStream stream) override;
+    int EventQuery(MkiRtEvent event, bool *completed) override;
+    int EventSynchronize(MkiRtEvent event) override;
+    int StreamWaitEvent(MkiRtStream stream, MkiRtEvent event) override;
+    int StreamBeginCapture(MkiRtStream stream) override;
+    int StreamEndCapture(MkiRtStream stream, MkiRtModel *model) override;
+    int ModelExecute(MkiRtModel model, MkiRtStream stream) override;
+    int ModelDestroy(MkiRtModel model) override;
+
+public:
+    int MemMallocDevice(void **devPtr, uint64_t size, MkiRtMemType memType) override;
+    int MemFreeDevice(void *devPtr) override;
+    int MemMallocHost(void **hostPtr, uint64_t size) override;
+    int MemFreeHost(void *hostPtr) override;
+    int MemCopy(void *dst, uint64_t dstLen, const void *srcPtr, uint64_t srcLen,
+                MkiRtMemCopyType copyType) override;
+    int MemCopyAsync(void *dst, uint64_t dstLen, const void *srcPtr, uint64_t srcLen,
+                     MkiRtMemCopyType copyType, void *stream) override;
+    int MemSetAsync(void *dst, uint64_t destMax, uint32_t value, uint64_t count, void *stream) override;
+    int IpcSetMemoryName(const void *ptr, uint64_t byteCount, const char *name, uint32_t len) override;
+    int IpcOpenMemory(void **ptr, const char *name) override;
+    int SetIpcMemPid(const char *name, int32_t pid[], int num) override;
+
+public:
+    int ModuleCreate(MkiRtModuleInfo *moduleInfo, MkiRtModule *module) override;
+    int ModuleCreateFromFile(const char *moduleFilePath, MkiRtModuleType type, int version,
+                             MkiRtModule *module) override;
+    int ModuleDestory(MkiRtModule *module) override;
+    int ModuleBindFunction(MkiRtModule module, const char *funcName, void *func) override;
+    int RegisterAllFunction(MkiRtModuleInfo *moduleInfo, void **handle) override;
+    int FunctionLaunch(const void *func, const MkiRtKernelParam *param, MkiRtStream stream) override;
+    int FunctionLaunchWithHandle(void *handle, const MkiRtKernelParam *param, MkiRtStream stream,
+                                 const RtTaskCfgInfoT *cfgInfo) override;
+    int FunctionLaunchWithFlag(const void *func, const MkiRtKernelParam *param, MkiRtStream stream,
+                               const RtTaskCfgInfoT *cfgInfo) override;
+    int FunctionLaunchBatch(const MkiRtLaunchItem *items, uint32_t count, MkiRtStream stream) override;
+
+public:
+    int GetC2cCtrlAddr(uint64_t *addr, uint32_t *len) override;
+
+public:
+    void SetRecordLimit(size_t limit);
+    void SetRecordArgs(bool flag);
+    uint64_t GetLaunchCount() const;
+    // FunctionLaunchBatch calls, the launches in them are counted by GetLaunchCount
+    uint64_t GetBatchLaunchCount() const;
+    std::vector<MockLaunchRecord> GetLaunchRecords() const;
+    void ClearLaunchRecords();
+    uint64_t GetDeviceMemoryUsed() const;
+    size_t GetHostMemoryCount() const;
+    // streams are synchronous, so recorded events complete at once unless deferred for tests
+    void SetEventDeferred(bool flag);
+    void CompleteEvents();
+    // events destroyed before they completed, a real runtime may still signal them
+    uint64_t GetIncompleteEventDestroyCount() const;
+
+private:
+    MockBackend(const MockBackend &) = delete;
+    const MockBackend &operator=(const MockBackend &) = delete;
+    const std::string *AddFunction(const void *func, const std::string &name);
+    int RecordLaunch(const void *func, const MkiRtKernelParam *param, MkiRtStream stream);
+    void AddLaunchRecord(const void *func, const MkiRtKernelParam *param, MkiRtStream stream, uint64_t startTime);
+
+private:
+    mutable std::mutex mutex_;
+    int32_t currentDevId_ = 0;
+    std::string socVersion_;
+    int32_t nextStreamId_ = 0;
+    std::unordered_map<MkiRtStream, int32_t> streams_;
+    std::unordered_map<void *, uint64_t> deviceMems_;
+    uint64_t deviceMemoryUsed_ = 0;
+    std::unordered_set<void *> hostMems_;
+    std::unordered_map<std::string, void *> ipcMems_;
+    std::unordered_set<MkiRtModule> modules_;
+    std::unordered_map<MkiRtEvent, bool> events_; // event -> completed
+    // a model is the list of launches captured on a stream, executing it records them again
+    std::unordered_map<MkiRtStream, std::vector<MockLaunchRecord> *> capturingStreams_;
+    std::unordered_set<MkiRtModel> models_;
+    bool eventDeferred_ = false;
+    uint64_t incompleteEventDestroyCount_ = 0;
+    std::deque<std::string> functionNames_;
+    std::unordered_map<const void *, const std::string *> functions_;
+    std::atomic<uint64_t> launchCount_{0};
+    std::atomic<uint64_t> batchLaunchCount_{0};
+    size_t recordLimit_ = 4096;
+    bool recordArgs_ = true;
+    std::vector<MockLaunchRecord> launchRecords_;
+};
+}
+
+#endif
@@ -36,6 +36,28 @@ int rtStreamDestroy(rtStream_t stm);
 int rtStreamSynchronize(rtStream_t stm);
 int rtGetStreamId(rtStream_t stm, int32_t *streamId);
 
+// rt event
+typedef void *rtEvent_t;
+typedef enum {
+    RT_EVENT_INIT = 0,
+    RT_EVENT_RECORDED = 1,
+} rtEventStatus_t;
+
+int rtEventCreate(rtEvent_t *evt);
+int rtEventDestroy(rtEvent_t evt);
+int rtEventRecord(rtEvent_t evt, rtStream_t stm);
+int rtEventQueryStatus(rtEvent_t evt, rtEventStatus_t *status);
+int rtEventSynchronize(rtEvent_t evt);
+int rtStreamWaitEvent(rtStream_t stm, rtEvent_t evt);
+
+// rt stream capture, looked up at runtime because older runtime libraries do not export it
+typedef void *rtModel_t;
+typedef enum {
+    RT_STREAM_CAPTURE_MODE_GLOBAL = 0,
+    RT_STREAM_CAPTURE_MODE_THREAD_LOCAL = 1,
+    RT_STREAM_CAPTURE_MODE_RELAXED = 2,
+} rtStreamCaptureMode;
+
 // rt mem
 int rtMalloc(void **devPtr, uint64_t size, uint32_t type);
 int rtFree(void *devPtr);
@@ -100,6 +122,16 @@ public:
     int StreamDestroy(MkiRtStream stream) override;
     int StreamSynchronize(MkiRtStream stream) override;
     int StreamGetId(MkiRtStream stream, int32_t *streamId) override;
+    int EventCreate(MkiRtEvent *event) override;
+    int EventDestroy(MkiRtEvent event) override;
+    int EventRecord(MkiRtEvent event, MkiRtStream stream) override;
+    int EventQuery(MkiRtEvent event, bool *completed) override;
+    int EventSynchronize(MkiRtEvent event) override;
+    int StreamWaitEvent(MkiRtStream stream, MkiRtEvent event) override;
+    int StreamBeginCapture(MkiRtStream stream) override;
+    int StreamEndCapture(MkiRtStream stream, MkiRtModel *model) override;
+    int ModelExecute(MkiRtModel model, MkiRtStream stream) override;
+    int ModelDestroy(MkiRtModel model) override;
 
 public:
     int MemMallocDevice(void **devPtr, uint64_t size, MkiRtMemType memType) override;
@@ -127,6 +159,7 @@ public:
                                  const RtTaskCfgInfoT *cfgInfo) override;
     int FunctionLaunchWithFlag(const void *func, const MkiRtKernelParam *param, MkiRtStream stream,
                                const RtTaskCfgInfoT *cfgInfo) override;
+    int FunctionLaunchBatch(const MkiRtLaunchItem *items, uint32_t count, MkiRtStream stream) override;
 
 public:
     int GetC2cCtrlAddr(uint64_t *addr, uint32_t *len) override;
@@ -20,6 +20,8 @@ extern "C" {
 
 typedef void *MkiDevice;
 typedef void *MkiRtStream;
+typedef void *MkiRtEvent;
+typedef void *MkiRtModel;
 
 enum MkiRtDevBinaryMagic : uint32_t {
     MKIRT_DEV_BINARY_MAGIC_ELF = 0x43554245U,
@@ -36,6 +38,7 @@ typedef enum {
     MKIRT_ERROR_FUNC_NOT_EXIST = -5,
     MKIRT_ERROR_OPEN_BIN_FILE_FAIL = -6,
     MKIRT_ERROR_PARA_CHECK_FAIL = -7,
+    MKIRT_ERROR_OUT_OF_MEMORY = -8,
 } MkiRtError;
 
 typedef enum {
@@ -80,6 +83,7 @@ typedef struct {
     const void *data = nullptr;
     uint64_t dataLen = 0;
     uint32_t magic = MKIRT_DEV_BINARY_MAGIC_ELF_AICUBE;
+    const char *name = nullptr; // kernel or binary name, only for debug and the mock backend
 } MkiRtModuleInfo;
 
 typedef struct {
@@ -114,6 +118,12 @@ typedef struct {
     RtArgsExT *argsEx = nullptr;
 } MkiRtKernelParam;
 
+typedef struct {
+    void *handle = nullptr;     // handle of RegisterAllFunction, launched with handle when not nullptr
+    const void *func = nullptr; // stub function launched with flag when handle is nullptr
+    const MkiRtKernelParam *param = nullptr;
+} MkiRtLaunchItem;
+
 #ifdef __cplusplus
 }
 #endif
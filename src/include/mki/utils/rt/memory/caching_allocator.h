@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_RT_MEMORY_CACHING_ALLOCATOR_H
+#define MKI_UTILS_RT_MEMORY_CACHING_ALLOCATOR_H
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "mki/utils/rt/base/types.h"
+#include "mki/utils/non_copyable/non_copyable.h"
+
+namespace Mki {
+class Backend;
+
+struct DeviceAllocatorStats {
+    uint64_t allocatedBytes = 0; // bytes of blocks handed out, rounded to the block granularity
+    uint64_t reservedBytes = 0;  // bytes of segments held from the backend
+    uint64_t peakAllocatedBytes = 0;
+    uint64_t peakReservedBytes = 0;
+    uint64_t cachedFreeBytes = 0; // reserved bytes that are free, including blocks waiting for events
+    uint64_t largestFreeBlock = 0;
+    uint64_t pendingFreeBytes = 0; // freed blocks still used by other streams
+    uint64_t segmentCount = 0;
+    uint64_t allocCount = 0;
+    uint64_t cacheHitCount = 0; // allocations served without calling the backend
+    uint64_t backendMallocCount = 0;
+    uint64_t backendFreeCount = 0;
+    uint64_t oomCount = 0;
+
+    double CacheHitRate() const;
+    // 1 - largest free block / free bytes, 0 when nothing is cached
+    double Fragmentation() const;
+};
+
+/**
+ Caching allocator for device memory on top of one Backend.
+ Memory is taken from the backend in segments, small requests (<= 1MB) share 2MB segments and large
+ requests get their own segment rounded to 2MB. Segments are split into blocks, free blocks are kept
+ in size class bins per stream and coalesced with free neighbours, so a block is only reused by the
+ stream it was allocated on without any synchronization. A block used by other streams (RecordStream)
+ is held until events recorded on those streams complete.
+*/
+class DeviceCachingAllocator : public NonCopyable {
+public:
+    static constexpr uint64_t BLOCK_ALIGN = 512;
+    static constexpr uint64_t SMALL_SIZE = 1048576;
+    static constexpr uint64_t SMALL_SEGMENT_SIZE = 2097152;
+    static constexpr uint64_t LARGE_SEGMENT_ALIGN = 2097152;
+    static constexpr size_t BIN_NUM = 64;
+
+    explicit DeviceCachingAllocator(Backend *backend);
+    ~DeviceCachingAllocator();
+
+    // size 0 gives nullptr, returns MKIRT_ERROR_OUT_OF_MEMORY when backend or limit is exhausted
+    int Allocate(void **devPtr, uint64_t size, MkiRtStream stream = nullptr);
+    int Free(void *devPtr);
+    // devPtr is also used by stream, the block is reused only after work queued on stream so far is done
+    int RecordStream(void *devPtr, MkiRtStream stream);
+    // limit of reserved bytes, 0 means no limit
+    void SetMemoryLimit(uint64_t limit);
+    uint64_t GetMemoryLimit() const;
+    // release entirely free segments to the backend until reserved bytes <= keepBytes
+    void Trim(uint64_t keepBytes = 0);
+    // called before stream is destroyed: waits for it, frees its cached segments and moves the segments
+    // still in use to the default stream, so a new stream reusing the handle starts without blocks
+    void ReleaseStream(MkiRtStream stream);
+    DeviceAllocatorStats GetStats() const;
+    void ResetPeakStats();
+
+private:
+    struct Block;
+    struct BlockLess {
+        bool operator()(const Block *lhs, const Block *rhs) const;
+    };
+    using BlockSet = std::set<Block *, BlockLess>;
+    struct StreamPool {
+        BlockSet bins[BIN_NUM];
+    };
+    struct PendingFree {
+        Block *block = nullptr;
+        std::vector<MkiRtEvent> events;
+    };
+
+    static size_t GetBinIdx(uint64_t size);
+    StreamPool &GetPool(MkiRtStream stream, bool small);
+    Block *FindFreeBlock(MkiRtStream stream, bool small, uint64_t size);
+    Block *AllocSegment(MkiRtStream stream, bool small, uint64_t size);
+    void SplitBlock(Block *block, uint64_t size);
+    void FreeBlock(Block *block);
+    void InsertFreeBlock(Block *block);
+    void EraseFreeBlock(Block *block);
+    void ReleaseSegment(Block *block);
+    void ReleaseCachedSegments(uint64_t keepBytes);
+    void ProcessEvents(bool synchronize);
+    MkiRtEvent GetEvent();
+
+private:
+    Backend *backend_ = nullptr;
+    mutable std::mutex mutex_;
+    uint64_t limit_ = 0;
+    std::unordered_map<MkiRtStream, StreamPool> pools_[2]; // 0: large, 1: small
+    std::unordered_map<void *, Block *> allocatedBlocks_;
+    std::unordered_set<Block *> segments_; // first block of every segment
+    std::vector<PendingFree> pendingFrees_;
+    std::vector<MkiRtEvent> eventPool_;
+    DeviceAllocatorStats stats_;
+};
+
+// allocator of the current backend, created on first use and never destructed,
+// env ASDOPS_DEVICE_CACHE_LIMIT sets the limit of reserved device memory in MB
+DeviceCachingAllocator *GetDeviceCachingAllocator();
+} // namespace Mki
+#endif
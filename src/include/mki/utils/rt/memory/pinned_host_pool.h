@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_RT_MEMORY_PINNED_HOST_POOL_H
+#define MKI_UTILS_RT_MEMORY_PINNED_HOST_POOL_H
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "mki/utils/allocator/host_allocator.h"
+#include "mki/utils/non_copyable/non_copyable.h"
+
+namespace Mki {
+class Backend;
+
+struct PinnedHostPoolStats {
+    uint64_t reservedBytes = 0;  // page-locked bytes held from the backend
+    uint64_t allocatedBytes = 0; // bytes handed out, rounded to the size class
+    uint64_t peakAllocatedBytes = 0;
+    uint64_t chunkCount = 0;
+    uint64_t largeBlockCount = 0;
+    uint64_t allocCount = 0;
+    uint64_t cacheHitCount = 0; // allocations served from a free list
+    uint64_t backendMallocCount = 0;
+    uint64_t failCount = 0;
+};
+
+/**
+ Pool of page-locked host memory taken from Backend::MemMallocHost, H2D copies from it can be real
+ async DMA. Power of 2 size classes from 256B to 1MB are carved from 2MB chunks and kept in free lists,
+ larger sizes are allocated from the backend directly. Chunks are only returned to the backend when
+ the pool is destructed. A buffer must stay alive until the async copies reading it are completed.
+*/
+class PinnedHostPool : public HostAllocator, public NonCopyable {
+public:
+    static constexpr uint64_t MIN_CLASS_SIZE = 256;
+    static constexpr uint64_t MAX_CLASS_SIZE = 1048576;
+    static constexpr uint64_t CHUNK_SIZE = 2097152;
+    static constexpr size_t CLASS_NUM = 13;
+
+    explicit PinnedHostPool(Backend *backend);
+    ~PinnedHostPool() override;
+    // return nullptr when fail, size passed to Deallocate must be the one passed to Allocate
+    uint8_t *Allocate(uint64_t size) override;
+    void Deallocate(uint8_t *addr, uint64_t size) override;
+    // addr points into memory held by this pool
+    bool IsPinned(const void *addr) const;
+    PinnedHostPoolStats GetStats() const;
+    static size_t GetClassIdx(uint64_t size);
+
+private:
+    uint8_t *AllocateFromClass(size_t classIdx);
+    uint8_t *MallocPinned(uint64_t size);
+    void RecycleChunkTail();
+
+private:
+    Backend *backend_ = nullptr;
+    mutable std::mutex mutex_;
+    std::vector<uint8_t *> freeLists_[CLASS_NUM];
+    uint8_t *cursor_ = nullptr; // unused tail of the last chunk, shared by all size classes
+    uint8_t *end_ = nullptr;
+    std::map<uintptr_t, uint64_t> pinnedRanges_; // start address -> size of chunks and large blocks
+    PinnedHostPoolStats stats_;
+};
+
+// pool of the current backend, created on first use and never destructed
+PinnedHostPool *GetPinnedHostPool();
+} // namespace Mki
+#endif
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UTILS_RT_MEMORY_TILING_RING_BUFFER_H
+#define MKI_UTILS_RT_MEMORY_TILING_RING_BUFFER_H
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "mki/utils/rt/base/types.h"
+#include "mki/utils/non_copyable/non_copyable.h"
+
+namespace Mki {
+class Backend;
+
+struct TilingRingStats {
+    uint64_t capacity = 0; // bytes of the ring of every stream
+    uint64_t streamCount = 0;
+    uint64_t uploadCount = 0;
+    uint64_t uploadBytes = 0;
+    uint64_t wrapCount = 0;
+    uint64_t waitCount = 0; // uploads blocked until the stream released old slots
+};
+
+/**
+ Device ring buffer for tiling data, one ring per stream.
+ Upload copies the host tiling into the pinned host mirror of the ring and queues an async H2D copy on
+ the stream, so no host sync is needed per launch. Commit records an event after the work that reads the
+ uploaded slots, the slots are reused once the event completes. Upload only blocks when the ring of the
+ stream is full of slots that are still in use.
+*/
+class TilingRingBuffer : public NonCopyable {
+public:
+    static constexpr uint64_t SLOT_ALIGN = 512;
+    static constexpr uint64_t DEFAULT_CAPACITY = 4194304;
+
+    explicit TilingRingBuffer(Backend *backend, uint64_t capacity = DEFAULT_CAPACITY);
+    ~TilingRingBuffer();
+
+    // deviceAddr is valid for work queued on stream until the next Commit of that stream
+    int Upload(MkiRtStream stream, const void *hostData, uint64_t size, uint8_t **deviceAddr);
+    // call after the work reading the uploaded slots is queued on stream
+    int Commit(MkiRtStream stream);
+    // wait for the work of stream and free its ring, called by MkiRtStreamDestroy
+    void ReleaseStream(MkiRtStream stream);
+    TilingRingStats GetStats() const;
+
+private:
+    struct Marker {
+        MkiRtEvent event = nullptr;
+        uint64_t end = 0;
+    };
+    struct StreamRing {
+        uint8_t *deviceBase = nullptr;
+        uint8_t *hostBase = nullptr;
+        // offsets only grow, the offset in the buffers is offset % capacity
+        uint64_t head = 0;
+        uint64_t tail = 0;
+        uint64_t committed = 0;
+        std::deque<Marker> markers;
+    };
+
+    StreamRing *GetRing(MkiRtStream stream);
+    int WaitForSpace(StreamRing &ring, uint64_t newHead);
+    void RetireMarkers(StreamRing &ring);
+    void FreeRing(StreamRing &ring);
+    MkiRtEvent GetEvent();
+
+private:
+    Backend *backend_ = nullptr;
+    uint64_t capacity_ = 0;
+    mutable std::mutex mutex_;
+    std::unordered_map<MkiRtStream, StreamRing> rings_;
+    std::vector<MkiRtEvent> eventPool_;
+    TilingRingStats stats_;
+};
+
+// ring buffer of the current backend, created on first use and never destructed,
+// env ASDOPS_TILING_RING_SIZE sets the ring size of every stream in MB
+TilingRingBuffer *GetTilingRingBuffer();
+} // namespace Mki
+#endif
@@ -28,6 +28,7 @@ int MkiRtFunctionLaunchWithHandle(void *handle, const MkiRtKernelParam *launchPa
     const RtTaskCfgInfoT *cfgInfo);
 int MkiRtFunctionLaunchWithFlag(const void *func, const MkiRtKernelParam *launchParam, MkiRtStream stream,
     const RtTaskCfgInfoT *cfgInfo);
+int MkiRtFunctionLaunchBatch(const MkiRtLaunchItem *items, uint32_t count, MkiRtStream stream);
 }
 #ifdef __cplusplus
 }
@@ -21,6 +21,19 @@ int MkiRtStreamCreate(MkiRtStream *stream, int32_t priority = 0);
 int MkiRtStreamDestroy(MkiRtStream stream);
 int MkiRtStreamSynchronize(MkiRtStream stream);
 int MkiRtStreamGetId(MkiRtStream stream, int32_t *streamId);
+int MkiRtEventCreate(MkiRtEvent *event);
+int MkiRtEventDestroy(MkiRtEvent event);
+int MkiRtEventRecord(MkiRtEvent event, MkiRtStream stream);
+// completed is true once all work captured by the last record has finished
+int MkiRtEventQuery(MkiRtEvent event, bool *completed);
+int MkiRtEventSynchronize(MkiRtEvent event);
+// work queued on stream after the wait starts once the last record of event has completed
+int MkiRtStreamWaitEvent(MkiRtStream stream, MkiRtEvent event);
+// MKIRT_ERROR_FUNC_NOT_EXIST when the runtime has no task capture
+int MkiRtStreamBeginCapture(MkiRtStream stream);
+int MkiRtStreamEndCapture(MkiRtStream stream, MkiRtModel *model);
+int MkiRtModelExecute(MkiRtModel model, MkiRtStream stream);
+int MkiRtModelDestroy(MkiRtModel model);
 }
 #ifdef __cplusplus
 }
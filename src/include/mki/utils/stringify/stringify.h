@@ -24,6 +24,7 @@ class Stringify {
 public:
     Stringify(size_t typeHashCode, StringifyFunc func);
     static std::string ToString(const Any &param);
+    static bool IsRegistered(const Any &param);
 private:
     static std::map<size_t, StringifyFunc> converterMap_;
 };
@@ -12,7 +12,9 @@
 #ifndef MKI_LOADER_OP_REGISTER_H
 #define MKI_LOADER_OP_REGISTER_H
 
+#include <deque>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include "mki/base/kernel_base.h"
 #include "mki/base/operation_base.h"
@@ -75,20 +77,90 @@ public:
 
 class KernelBinaryRegister {
 public:
+    struct KernelBinary {
+        std::string kernelName;
+        Mki::BinaryBasicInfo basicInfo;
+    };
+
+    // flat binary table of one soc, deque keeps BinaryBasicInfo addresses stable while registering
+    struct SocKernelBinarys {
+        std::string soc;
+        std::deque<KernelBinary> binarys;
+        std::vector<int32_t> kernelIndex; // kernel id -> index in binarys, -1 if not registered for this soc
+    };
+
     KernelBinaryRegister(const char *soc, const char *kernelName, const uint8_t *binary, uint32_t binaryLen) noexcept
     {
         MKI_CHECK(kernelName != nullptr, "kernelName is nullptr", return);
         MKI_CHECK(soc != nullptr, "target soc is nullptr", return);
         MKI_CHECK(binary != nullptr, "binary addr is nullptr", return);
-        auto &binaryMap = GetKernelBinaryMap();
-        binaryMap[std::string(kernelName)].push_back({ binary, binaryLen, soc });
+        SocKernelBinarys &socBinarys = GetSocKernelBinarys(soc);
+        uint32_t kernelId = GetKernelId(kernelName);
+        if (socBinarys.kernelIndex.size() <= kernelId) {
+            socBinarys.kernelIndex.resize(kernelId + 1, -1);
+        }
+        MKI_CHECK(socBinarys.kernelIndex[kernelId] < 0,
+                  "kernel binary " << kernelName << "-" << soc << " is registered repeatedly", return);
+        socBinarys.kernelIndex[kernelId] = static_cast<int32_t>(socBinarys.binarys.size());
+        socBinarys.binarys.push_back({ kernelName, { binary, binaryLen, socBinarys.soc } });
         MKI_NAMESPACE_LOG(DEBUG, OpSpace) << " register kernel binary " << kernelName << "-" << soc << " success";
     }
 
-    static std::map<std::string, std::vector<Mki::BinaryBasicInfo>> &GetKernelBinaryMap()
+    static const SocKernelBinarys *FindSocKernelBinarys(const std::string &soc)
+    {
+        auto &socIds = GetSocIds();
+        auto it = socIds.find(soc);
+        return it == socIds.end() ? nullptr : &GetSocKernelBinarysList()[it->second];
+    }
+
+    static const Mki::BinaryBasicInfo *FindKernelBinary(const std::string &soc, const std::string &kernelName)
+    {
+        const SocKernelBinarys *socBinarys = FindSocKernelBinarys(soc);
+        if (socBinarys == nullptr) {
+            return nullptr;
+        }
+        auto &kernelIds = GetKernelIds();
+        auto it = kernelIds.find(kernelName);
+        if (it == kernelIds.end() || it->second >= socBinarys->kernelIndex.size() ||
+            socBinarys->kernelIndex[it->second] < 0) {
+            return nullptr;
+        }
+        return &socBinarys->binarys[socBinarys->kernelIndex[it->second]].basicInfo;
+    }
+
+private:
+    static std::unordered_map<std::string, uint32_t> &GetSocIds()
+    {
+        static std::unordered_map<std::string, uint32_t> socIds;
+        return socIds;
+    }
+
+    static std::unordered_map<std::string, uint32_t> &GetKernelIds()
+    {
+        static std::unordered_map<std::string, uint32_t> kernelIds;
+        return kernelIds;
+    }
+
+    static std::deque<SocKernelBinarys> &GetSocKernelBinarysList()
+    {
+        static std::deque<SocKernelBinarys> socBinarysList;
+        return socBinarysList;
+    }
+
+    static SocKernelBinarys &GetSocKernelBinarys(const char *soc)
+    {
+        auto &socBinarysList = GetSocKernelBinarysList();
+        auto [it, inserted] = GetSocIds().emplace(soc, static_cast<uint32_t>(socBinarysList.size()));
+        if (inserted) {
+            socBinarysList.push_back({ soc, {}, {} });
+        }
+        return socBinarysList[it->second];
+    }
+
+    static uint32_t GetKernelId(const char *kernelName)
     {
-        static std::map<std::string, std::vector<Mki::BinaryBasicInfo>> binaryMap;
-        return binaryMap;
+        auto &kernelIds = GetKernelIds();
+        return kernelIds.emplace(kernelName, static_cast<uint32_t>(kernelIds.size())).first->second;
     }
 };
 
@@ -51,6 +51,13 @@ public:
      * @return Kernel*
      */
     Kernel *GetKernelInstance(const std::string &kernelName) const;
+    /**
+     * @brief Acquire a Kernel Instance By Name from the kernel pool, it goes back to the pool when released
+     *
+     * @param[const std::string&] kernelName
+     * @return PooledKernel
+     */
+    PooledKernel AcquireKernelInstance(const std::string &kernelName) const;
 
 private:
     Ops();
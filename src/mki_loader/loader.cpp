@@ -10,15 +10,57 @@
  * See the Mulan PSL v2 for more details.
  */
 #include "loader.h"
+#include <algorithm>
+#include <thread>
 #include "mki/base/operation_base.h"
 #include "mki/base/kernel_base.h"
 #include "mki/bin_handle.h"
 #include "mki/utils/assert/assert.h"
+#include "mki/utils/env/env.h"
 #include "mki/utils/log/log.h"
+#include "mki/utils/time/timer.h"
 #include "mki_loader/op_register.h"
 #include "mki/utils/platform/platform_info.h"
 
 namespace OpSpace {
+constexpr uint32_t MAX_LOAD_THREAD_NUM = 64;
+constexpr size_t LOAD_COST_REPORT_TOP_NUM = 10;
+static const char *LOAD_MODE_NAMES[] = {"EAGER", "LAZY", "PARALLEL"};
+
+static KernelLoadMode GetKernelLoadModeFromEnv()
+{
+    const char *env = std::getenv("ASDOPS_KERNEL_LOAD_MODE");
+    if (env == nullptr || strlen(env) > Mki::MAX_ENV_STRING_LEN) {
+        return KernelLoadMode::EAGER;
+    }
+    std::string envLoadMode(env);
+    std::transform(envLoadMode.begin(), envLoadMode.end(), envLoadMode.begin(), ::toupper);
+    static std::unordered_map<std::string, KernelLoadMode> loadModeMap{
+        {"EAGER", KernelLoadMode::EAGER}, {"LAZY", KernelLoadMode::LAZY}, {"PARALLEL", KernelLoadMode::PARALLEL}};
+    auto modeIt = loadModeMap.find(envLoadMode);
+    if (modeIt == loadModeMap.end()) {
+        MKI_LOG(WARN) << "ASDOPS_KERNEL_LOAD_MODE " << envLoadMode << " is invalid, use EAGER";
+        return KernelLoadMode::EAGER;
+    }
+    return modeIt->second;
+}
+
+static uint32_t GetKernelLoadThreadNumFromEnv()
+{
+    uint32_t defaultThreadNum = std::min(std::max(std::thread::hardware_concurrency(), 1U), MAX_LOAD_THREAD_NUM);
+    const char *env = std::getenv("ASDOPS_KERNEL_LOAD_THREADS");
+    if (env == nullptr || strlen(env) > Mki::MAX_ENV_STRING_LEN) {
+        return defaultThreadNum;
+    }
+    char *end = nullptr;
+    unsigned long threadNum = std::strtoul(env, &end, 10); // 10: decimal
+    if (end == env || *end != '\0' || threadNum == 0 || threadNum > MAX_LOAD_THREAD_NUM) {
+        MKI_LOG(WARN) << "ASDOPS_KERNEL_LOAD_THREADS " << env << " is invalid, use " << defaultThreadNum;
+        return defaultThreadNum;
+    }
+    return static_cast<uint32_t>(threadNum);
+}
+
 Loader::Loader() { Load(); }
 
 Loader::~Loader() {}
@@ -55,6 +97,9 @@ bool Loader::CreateOperations()
 
 bool Loader::CreateKernels()
 {
+    Mki::Timer totalTimer;
+    std::vector<KernelLoadCost> loadCosts;
+    bool lazyRegister = loadMode_ != KernelLoadMode::EAGER;
     auto &kernelCreators = KernelRegister::GetKernelCreators();
     for (const auto &creatorInfo : kernelCreators) {
         const auto &kernelName = creatorInfo.kernelName;
@@ -64,7 +109,9 @@ bool Loader::CreateKernels()
             continue;
         }
         auto &handle = it->second;
-        MKI_CHECK(handle.Init(kernelName), kernelName << " init handle fail", continue);
+        Mki::Timer initTimer;
+        MKI_CHECK(handle.Init(kernelName, lazyRegister), kernelName << " init handle fail", continue);
+        loadCosts.push_back({kernelName, &handle, initTimer.ElapsedMicroSecond()});
 
         auto kernelCreator = creatorInfo.func;
         MKI_CHECK(kernelCreator, kernelName << " creator function is null", continue);
@@ -75,24 +122,71 @@ bool Loader::CreateKernels()
         auto &opKernel = opKernelMap_[opName];
         opKernel[kernelName] = kernel;
     }
+    if (loadMode_ == KernelLoadMode::PARALLEL) {
+        RegisterKernelsParallel(loadCosts);
+    }
+    ReportLoadCost(loadCosts, totalTimer.ElapsedMicroSecond());
     return true;
 }
 
+void Loader::RegisterKernelsParallel(std::vector<KernelLoadCost> &loadCosts) const
+{
+    std::atomic<size_t> nextIdx{0};
+    auto registerFunc = [&loadCosts, &nextIdx]() {
+        for (size_t i = nextIdx++; i < loadCosts.size(); i = nextIdx++) {
+            MKI_CHECK(loadCosts[i].handle->EnsureRegistered(), loadCosts[i].kernelName << " register kernel fail",
+                      continue);
+        }
+    };
+    size_t threadNum = std::min(static_cast<size_t>(loadThreadNum_), loadCosts.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadNum; ++i) {
+        threads.emplace_back(registerFunc);
+    }
+    registerFunc();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void Loader::ReportLoadCost(std::vector<KernelLoadCost> &loadCosts, uint64_t totalCostUs) const
+{
+    uint64_t registerCostUs = 0;
+    for (auto &loadCost : loadCosts) {
+        // with eager mode register cost is part of init cost, with parallel mode it is spent in the pool
+        if (loadMode_ == KernelLoadMode::PARALLEL) {
+            loadCost.initCostUs += loadCost.handle->GetRegisterCostUs();
+        }
+        registerCostUs += loadCost.handle->GetRegisterCostUs();
+        MKI_LOG(DEBUG) << "kernel " << loadCost.kernelName << " load cost " << loadCost.initCostUs << "us";
+    }
+    MKI_LOG(INFO) << "load " << loadCosts.size() << " kernels, mode " << LOAD_MODE_NAMES[static_cast<int>(loadMode_)]
+                  << ", threads " << (loadMode_ == KernelLoadMode::PARALLEL ? loadThreadNum_ : 1) << ", total cost "
+                  << totalCostUs << "us, register cost "
+                  << (loadMode_ == KernelLoadMode::LAZY ? "logged on first use"
+                                                        : std::to_string(registerCostUs) + "us");
+    size_t topNum = std::min(LOAD_COST_REPORT_TOP_NUM, loadCosts.size());
+    std::partial_sort(loadCosts.begin(), loadCosts.begin() + topNum, loadCosts.end(),
+                      [](const KernelLoadCost &a, const KernelLoadCost &b) { return a.initCostUs > b.initCostUs; });
+    for (size_t i = 0; i < topNum; ++i) {
+        MKI_LOG(INFO) << "top " << i << " load cost kernel " << loadCosts[i].kernelName << ": "
+                      << loadCosts[i].initCostUs << "us";
+    }
+}
+
 bool Loader::LoadKernelBinarys()
 {
     std::string deviceVersion = Mki::PlatformInfo::Instance().GetPlatformName();
     MKI_CHECK(deviceVersion != "unrecognized", "Get device soc version fail: " << deviceVersion, return false);
 
-    const auto &kernelBinaryMap = KernelBinaryRegister::GetKernelBinaryMap();
-    for (auto &item : kernelBinaryMap) {
-        auto &binaryList = item.second;
-        for (auto &binary : binaryList) {
-            if (binary.targetSoc == deviceVersion) {
-                binHandles_.emplace(item.first, &binary);
-                MKI_LOG(DEBUG) << "Kernel " << deviceVersion << " find basic information success";
-                break;
-            }
-        }
+    const auto *socBinarys = KernelBinaryRegister::FindSocKernelBinarys(deviceVersion);
+    if (socBinarys == nullptr) {
+        MKI_LOG(WARN) << "No kernel binary is registered for " << deviceVersion;
+        return true;
+    }
+    binHandles_.reserve(socBinarys->binarys.size());
+    for (const auto &binary : socBinarys->binarys) {
+        binHandles_.emplace(binary.kernelName, &binary.basicInfo);
     }
     MKI_LOG(DEBUG) << "Loaded kernel Count: " << binHandles_.size();
     return true;
@@ -121,6 +215,8 @@ void Loader::Load()
 {
     loadSuccess_ = false;
     MKI_LOG(INFO) << "register flag: " << g_opsRegisterFlag << " is set";
+    loadMode_ = GetKernelLoadModeFromEnv();
+    loadThreadNum_ = GetKernelLoadThreadNumFromEnv();
 
     MKI_CHECK(LoadKernelBinarys(), "Load kernel binarys fail", return);
     MKI_CHECK(CreateOperations(), "Load operations fail", return);
@@ -14,12 +14,25 @@
 #include <unordered_map>
 #include <memory>
 #include <atomic>
+#include <vector>
 #include "mki/utils/non_copyable/non_copyable.h"
 #include "mki/operation.h"
 #include "mki/kernel.h"
 #include "mki/bin_handle.h"
 
 namespace OpSpace {
+enum class KernelLoadMode {
+    EAGER = 0, // register every kernel binary while loading
+    LAZY,      // register a kernel binary on its first init or launch
+    PARALLEL,  // register kernel binaries while loading with a thread pool
+};
+
+struct KernelLoadCost {
+    std::string kernelName;
+    Mki::BinHandle *handle = nullptr;
+    uint64_t initCostUs = 0;
+};
+
 class Loader : public Mki::NonCopyable {
 public:
     Loader();
@@ -33,10 +46,14 @@ private:
     bool LoadKernelBinarys();
     bool CreateOperations();
     bool CreateKernels();
+    void RegisterKernelsParallel(std::vector<KernelLoadCost> &loadCosts) const;
+    void ReportLoadCost(std::vector<KernelLoadCost> &loadCosts, uint64_t totalCostUs) const;
     bool OpBaseAddKernels() const;
 
 private:
     std::atomic_bool loadSuccess_{false};
+    KernelLoadMode loadMode_ = KernelLoadMode::EAGER;
+    uint32_t loadThreadNum_ = 1;
     std::unordered_map<std::string, Mki::Operation *> opMap_;
     std::unordered_map<std::string, Mki::KernelMap> opKernelMap_;
     std::unordered_map<std::string, Mki::BinHandle> binHandles_;
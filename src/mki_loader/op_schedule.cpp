@@ -44,6 +44,16 @@ Kernel *OpSchedule::GetKernelInstance(const std::string &kernelName) const
     return it == kernelMap_.end() ? nullptr : (it->second)->Clone();
 }
 
+PooledKernel OpSchedule::AcquireKernelInstance(const std::string &kernelName) const
+{
+    auto it = kernelMap_.find(kernelName);
+    if (it == kernelMap_.end()) {
+        return nullptr;
+    }
+    KernelPool *pool = (it->second)->GetKernelPool();
+    return pool != nullptr ? pool->AcquireScoped() : PooledKernel((it->second)->Clone());
+}
+
 void OpSchedule::AddAllOperations()
 {
     std::unordered_map<std::string, Operation *> ops;
@@ -28,6 +28,7 @@ public:
     std::vector<Operation *> GetAllOperations() const;
     Operation *GetOperationByName(const std::string &opName) const;
     Kernel *GetKernelInstance(const std::string &kernelName) const;
+    PooledKernel AcquireKernelInstance(const std::string &kernelName) const;
 
 private:
     void AddAllOperations();
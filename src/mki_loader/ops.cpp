@@ -38,4 +38,9 @@ Kernel *Ops::GetKernelInstance(const std::string &kernelName) const
     return opSchedule_->GetKernelInstance(kernelName);
 }
 
+PooledKernel Ops::AcquireKernelInstance(const std::string &kernelName) const
+{
+    return opSchedule_->AcquireKernelInstance(kernelName);
+}
+
 } // namespace OpSpace
@@ -12,7 +12,9 @@
 
 #include "mki/bin_handle.h"
 #include "mki/utils/assert/assert.h"
+#include "mki/utils/compress/lz4_block.h"
 #include "mki/utils/rt/rt.h"
+#include "mki/utils/time/timer.h"
 
 namespace Mki {
 constexpr uint32_t BYTE_SIZE = 8;
@@ -21,6 +23,9 @@ constexpr uint32_t UINT32_TYPE_LENGTH = sizeof(uint32_t);
 constexpr uint32_t MASK_LOWER16 = 0xFFFFU;
 constexpr uint32_t MASK_HIGHER16 = 0xFFFF0000U;
 constexpr uint32_t SHIFT16 = 16U;
+constexpr uint32_t KERNEL_COMPRESS_NONE = 0;
+constexpr uint32_t KERNEL_COMPRESS_LZ4 = 1;
+constexpr uint32_t MAX_KERNEL_CODE_LEN = 1073741824; // 1G
 
 struct KernelHeaderInfo {
     uint32_t version = 0;
@@ -33,6 +38,8 @@ struct KernelHeaderInfo {
     uint32_t kernelBinOffset = 0;
     uint32_t intercoreSync = 0;
     uint32_t taskRation = 0;
+    uint32_t compressType = 0;
+    uint32_t rawBinSize = 0;
 };
 
 BinHandle::BinHandle(const BinaryBasicInfo *binInfo) : basicInfo_(binInfo) {}
@@ -45,7 +52,46 @@ BinHandle::~BinHandle()
     }
 }
 
-KernelHandle BinHandle::GetHandle() const { return &handle_; }
+KernelHandle BinHandle::GetHandle() const
+{
+    if (lazyRegister_ && !registered_.load(std::memory_order_acquire)) {
+        (void)EnsureRegistered();
+    }
+    return &handle_;
+}
+
+bool BinHandle::EnsureRegistered() const
+{
+    if (!lazyRegister_ || registered_.load(std::memory_order_acquire)) {
+        return true;
+    }
+    // a failed register is not retried, later calls return without taking the lock
+    if (registerFailed_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(registerMutex_);
+    if (registered_ || registerFailed_) {
+        return registered_;
+    }
+    bool ret = codeLoadSuccess_ && TimedRegisterBin();
+    MKI_LOG_IF(!codeLoadSuccess_, ERROR) << kernelName_ << " meta info is not loaded";
+    MKI_LOG_IF(ret, INFO) << kernelName_ << " register bin on first use cost " << registerCostUs_ << "us";
+    registered_.store(ret, std::memory_order_release);
+    registerFailed_.store(!ret, std::memory_order_release);
+    return ret;
+}
+
+bool BinHandle::IsRegistered() const { return registered_; }
+
+uint64_t BinHandle::GetRegisterCostUs() const { return registerCostUs_; }
+
+bool BinHandle::TimedRegisterBin() const
+{
+    Timer timer;
+    bool ret = RegisterBin(kernelName_);
+    registerCostUs_ = timer.ElapsedMicroSecond();
+    return ret;
+}
 
 bool BinHandle::CheckBinaryValid() const
 {
@@ -68,9 +114,11 @@ bool BinHandle::CheckKernelInfo(const std::string &kernelName) const
     return true;
 }
 
-bool BinHandle::Init(const std::string &kernelName)
+bool BinHandle::Init(const std::string &kernelName, bool lazyRegister)
 {
     codeLoadSuccess_ = false;
+    kernelName_ = kernelName;
+    lazyRegister_ = lazyRegister;
 
     MKI_CHECK(CheckBinaryValid(), "basicInfo is invalid", return false);
 
@@ -109,9 +157,17 @@ bool BinHandle::Init(const std::string &kernelName)
     MKI_CHECK(kernelBinStart + UINT32_TYPE_LENGTH + kernelBinSize == maxAddr, "length error", return false);
     metaInfo_.codeBuf = static_cast<const void *>(kernelBinStart + UINT32_TYPE_LENGTH);
     metaInfo_.codeBufLen = kernelBinSize;
+    metaInfo_.compressType = header.compressType;
+    metaInfo_.rawCodeBufLen = header.compressType == KERNEL_COMPRESS_NONE ? kernelBinSize : header.rawBinSize;
+    MKI_CHECK(header.compressType == KERNEL_COMPRESS_NONE || header.compressType == KERNEL_COMPRESS_LZ4,
+              kernelName << " unsupported compress type " << header.compressType, return false);
+    MKI_CHECK(metaInfo_.rawCodeBufLen <= MAX_KERNEL_CODE_LEN, kernelName << " raw code length error", return false);
 
     MKI_CHECK(CheckKernelInfo(kernelName), kernelName << " check kernel info error", return false);
-    MKI_CHECK(RegisterBin(kernelName), kernelName << " register kernel fail", return false);
+    if (!lazyRegister) {
+        MKI_CHECK(TimedRegisterBin(), kernelName << " register kernel fail", return false);
+        registered_ = true;
+    }
 
     codeLoadSuccess_ = true;
     return true;
@@ -166,7 +222,7 @@ const char *BinHandle::GetKernelCompileInfo() const
     return metaInfo_.compileInfo.c_str();
 }
 
-bool BinHandle::RegisterBin(const std::string &kernelName)
+bool BinHandle::RegisterBin(const std::string &kernelName) const
 {
     size_t kernelNum = metaInfo_.kernelList.size();
     MKI_CHECK(kernelNum != 0, "Get Binary Kernel Num empty, op: " << kernelName, return false);
@@ -176,7 +232,15 @@ bool BinHandle::RegisterBin(const std::string &kernelName)
     moduleInfo.version = 0;
     moduleInfo.data = metaInfo_.codeBuf;
     moduleInfo.dataLen = metaInfo_.codeBufLen;
+    // the runtime copies the code when it is registered, decompressed code is released when this returns
+    std::vector<uint8_t> code;
+    if (metaInfo_.compressType != KERNEL_COMPRESS_NONE) {
+        MKI_CHECK(DecompressCode(code), kernelName << " decompress kernel code fail", return false);
+        moduleInfo.data = code.data();
+        moduleInfo.dataLen = code.size();
+    }
     moduleInfo.magic = metaInfo_.magic;
+    moduleInfo.name = kernelName.c_str();
 
     if (metaInfo_.kernelList.size() == 1) {
         MKI_LOG(DEBUG) << "single kernel register bin start, opName:" << kernelName;
@@ -201,4 +265,17 @@ bool BinHandle::RegisterBin(const std::string &kernelName)
     MKI_LOG(DEBUG) << "kernel register bin finish";
     return true;
 }
+
+bool BinHandle::DecompressCode(std::vector<uint8_t> &code) const
+{
+    code.resize(metaInfo_.rawCodeBufLen);
+    bool ret = Lz4BlockDecompress(static_cast<const uint8_t *>(metaInfo_.codeBuf), metaInfo_.codeBufLen,
+                                  code.data(), code.size());
+    if (!ret) {
+        return false;
+    }
+    MKI_LOG(DEBUG) << kernelName_ << " decompress code from " << metaInfo_.codeBufLen << " to "
+                   << metaInfo_.rawCodeBufLen << " bytes";
+    return true;
+}
 }
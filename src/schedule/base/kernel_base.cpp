@@ -11,27 +11,51 @@
  */
 #include "mki/base/kernel_base.h"
 #include <securec.h>
+#include "mki/launch_graph.h"
 #include "mki/utils/assert/assert.h"
 #include "mki/utils/checktensor/check_tensor.h"
 #include "mki/utils/file_system/file_system.h"
 #include "mki/utils/log/log.h"
 #include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/memory/tiling_ring_buffer.h"
 #include "mki/utils/math/tensor_utils.h"
 #include "mki/utils/memset/clear_tensors.h"
 
 namespace Mki {
 
 static const int TENSORLEN = 0;
+static constexpr int64_t FAILURE_LOG_INTERVAL_MS = 1000;
 
 class KernelParamBuilder {
 public:
-    Status Init(const LaunchParam &launchParam, const RunInfo &runInfo, uint64_t argsNum, const KernelInfo &kernelInfo)
+    explicit KernelParamBuilder(KernelInfo::FrozenArgsInfo *frozenArgsInfo = nullptr)
+        : frozenArgsInfo_(frozenArgsInfo)
     {
-        uint8_t *argsPtr = kernelInfo.GetArgs();
+        if (frozenArgsInfo_ != nullptr) {
+            frozenArgsInfo_->valid = false;
+            frozenArgsInfo_->argsEx = RtArgsExT();
+            frozenArgsInfo_->patchInfos.clear();
+            argsEx_ = &frozenArgsInfo_->argsEx;
+        }
+    }
+
+    // argsPtr is where the args are built, nullptr means the args of kernelInfo
+    Status Init(const LaunchParam &launchParam, const RunInfo &runInfo, uint64_t argsNum, const KernelInfo &kernelInfo,
+                uint8_t *argsPtr = nullptr)
+    {
+        uint8_t *kernelArgs = kernelInfo.GetArgs();
         uint64_t argsSize = kernelInfo.GetArgsSize();
-        MKI_CHECK(argsPtr != nullptr, "args size invalid", return Status::FailStatus(-1));
+        MKI_CHECK(kernelArgs != nullptr, "args size invalid", return Status::FailStatus(-1));
         MKI_CHECK(argsNum * sizeof(void *) <= argsSize, "args size invalid", return Status::FailStatus(-1));
-        auto ret = memset_s(argsPtr, argsSize, 0, argsNum * sizeof(void *));
+        uint64_t addrSize = argsNum * sizeof(void *);
+        if (argsPtr == nullptr) {
+            argsPtr = kernelArgs;
+        } else if (argsSize > addrSize) {
+            // tiling, const tensors and tensor list appended by Init follow the addresses
+            auto copyRet = memcpy_s(argsPtr + addrSize, argsSize - addrSize, kernelArgs + addrSize, argsSize - addrSize);
+            MKI_CHECK(copyRet == EOK, "failed to copy args data", return Status::FailStatus(ERROR_INVALID_VALUE));
+        }
+        auto ret = memset_s(argsPtr, argsSize, 0, addrSize);
         MKI_CHECK(ret == EOK, "memory set failed", return Status::FailStatus(ERROR_INVALID_VALUE));
         void **args = reinterpret_cast<void **>(static_cast<void *>(argsPtr));
         // set hwsync
@@ -48,16 +72,16 @@ public:
             if (constTensorCount > 0) {
                 MKI_CHECK(constTensorCount < maxConstTensorCount, "const tensor size check failed, is "
                           << constTensorCount, return Status::FailStatus(-1));
-                hostInfo_.reset(new (std::nothrow) RtHostInputInfoT[constTensorCount]);
-                MKI_CHECK(hostInfo_ != nullptr, "hostInfo size nullptr", return Status::FailStatus(-1));
+                RtHostInputInfoT *hostInfo = AllocHostInfo(constTensorCount);
+                MKI_CHECK(hostInfo != nullptr, "hostInfo size nullptr", return Status::FailStatus(-1));
                 uint64_t constTensorOffset =
                     Utils::GetTensorAlignedSize(kernelInfo.GetTilingUsedSize()) + argsNum * sizeof(void *);
-                status = UpdateConstTensorArgs(args, hostInfo_.get(), constTensorOffset, constTensorInfos);
+                status = UpdateConstTensorArgs(args, hostInfo, constTensorOffset, constTensorInfos);
                 MKI_CHECK(status.Ok(), "failed to update const tensor args, tiling flag: " << launchWithTiling,
                           return status);
+                argsEx_->hostInputInfoPtr = hostInfo;
             }
-            argsEx_.hostInputInfoPtr = hostInfo_.get();
-            argsEx_.hostInputInfoNum = constTensorCount;
+            argsEx_->hostInputInfoNum = constTensorCount;
         } else {
             uint64_t constTensorOffset = kernelInfo.GetConstTensorOffset();
             status = UpdateConstTensorArgs(args, runInfo.GetTilingDeviceAddr(), constTensorOffset, constTensorInfos);
@@ -78,7 +102,7 @@ public:
             MKI_CHECK(status.Ok(), "failed to update input output wksp args", return status);
         }
         // set tiling
-        status = launchWithTiling ? UpdateTilingArgs(argsEx_, argsNum)
+        status = launchWithTiling ? UpdateTilingArgs(*argsEx_, argsNum)
                                   : UpdateTilingArgs(args, argsNum, runInfo.GetTilingDeviceAddr());
         MKI_CHECK(status.Ok(), "failed to get launch with tiling", return status);
         // Memset
@@ -88,9 +112,16 @@ public:
         // launch
         kernelParam_.tilingId = kernelInfo.GetTilingId();
         kernelParam_.blockDim = kernelInfo.GetBlockDim();
-        kernelParam_.argsEx = &argsEx_;
-        argsEx_.args = argsPtr;
-        argsEx_.argsSize = argsSize;
+        kernelParam_.argsEx = argsEx_;
+        argsEx_->args = argsPtr;
+        argsEx_->argsSize = argsSize;
+        if (frozenArgsInfo_ != nullptr) {
+            frozenArgsInfo_->argsNum = argsNum;
+            frozenArgsInfo_->inTensorCount = launchParam.GetInTensorCount();
+            frozenArgsInfo_->outTensorCount = launchParam.GetOutTensorCount();
+            frozenArgsInfo_->valid = true;
+            MKI_LOG(DEBUG) << "args frozen, patch slot num " << frozenArgsInfo_->patchInfos.size();
+        }
         return status;
     }
 
@@ -100,6 +131,25 @@ public:
     }
 
 private:
+    RtHostInputInfoT *AllocHostInfo(size_t num)
+    {
+        if (frozenArgsInfo_ != nullptr) {
+            frozenArgsInfo_->hostInputInfos.assign(num, RtHostInputInfoT());
+            return frozenArgsInfo_->hostInputInfos.data();
+        }
+        hostInfo_.reset(new (std::nothrow) RtHostInputInfoT[num]);
+        return hostInfo_.get();
+    }
+
+    void SetArg(void **args, uint64_t idx, void *addr, KernelInfo::ArgsPatchType type, uint64_t tensorIdx,
+                uint64_t addrOffset) const
+    {
+        args[idx] = addr;
+        if (frozenArgsInfo_ != nullptr) {
+            frozenArgsInfo_->patchInfos.push_back({idx * sizeof(void *), type, tensorIdx, addrOffset});
+        }
+    }
+
     Status UpdateHwsyncArgs(void **args, uint64_t argsNum, int64_t hwsyncIdx) const
     {
         if (hwsyncIdx >= 0 && static_cast<uint64_t>(hwsyncIdx) < argsNum) {
@@ -124,7 +174,8 @@ private:
                 continue;
             }
             MKI_LOG(DEBUG) << "args info: input tensor " << idx;
-            args[idx] = launchParam.GetInTensor(i++).data;
+            SetArg(args, idx, launchParam.GetInTensor(i).data, KernelInfo::ArgsPatchType::INPUT, i, 0);
+            i++;
         }
         size_t outputNum = launchParam.GetOutTensorCount();
         for (size_t i = 0; i < outputNum && idx < argsNum; idx++) {
@@ -132,7 +183,8 @@ private:
                 continue;
             }
             MKI_LOG(DEBUG) << "args info: output tensor " << idx;
-            args[idx] = launchParam.GetOutTensor(i++).data;
+            SetArg(args, idx, launchParam.GetOutTensor(i).data, KernelInfo::ArgsPatchType::OUTPUT, i, 0);
+            i++;
         }
         size_t workspaceNum = workspaces.size();
         uint64_t offset = 0;
@@ -141,7 +193,7 @@ private:
                 continue;
             }
             MKI_LOG(DEBUG) << "args info: workspace " << idx << " offset " << offset;
-            args[idx] = workspaceAddr + offset;
+            SetArg(args, idx, workspaceAddr + offset, KernelInfo::ArgsPatchType::WORKSPACE, 0, offset);
             offset += workspaces.at(i++);
         }
         return Status::OkStatus();
@@ -178,7 +230,8 @@ private:
         uint64_t offset = constTensorOffset;
         for (size_t i = 0; i < constTensorInfos.size(); i++) {
             auto &constTensorInfo = constTensorInfos.at(i);
-            args[constTensorInfo.argIdx] = tilingDeviceAddr + offset;
+            SetArg(args, constTensorInfo.argIdx, tilingDeviceAddr + offset, KernelInfo::ArgsPatchType::TILING, 0,
+                   offset);
             MKI_LOG(DEBUG) << "args info: const tensor " << constTensorInfo.argIdx << " offset in tiling " << offset;
             offset += constTensorInfo.size;
         }
@@ -198,12 +251,12 @@ private:
     Status UpdateTilingArgs(void **args, uint64_t argsNum, uint8_t *tilingDeviceAddr) const
     {
         MKI_LOG(DEBUG) << "args info: tiling " << (argsNum - 1);
-        args[argsNum - 1] = tilingDeviceAddr;
+        SetArg(args, argsNum - 1, tilingDeviceAddr, KernelInfo::ArgsPatchType::TILING, 0, 0);
         return Status::OkStatus();
     }
 
     Status UpdateArgsWithTensorList(void **args, uint64_t argsNum, const MiniVector<uint64_t> &workspaces,
-                            const LaunchParam &launchParam, uint8_t *workspaceAddr)
+                            const LaunchParam &launchParam, uint8_t *workspaceAddr) const
     {
         size_t inputNum =
             launchParam.GetInputLenCount() > 0 ? launchParam.GetInputLenCount() : launchParam.GetInTensorCount();
@@ -222,7 +275,9 @@ private:
                 tensorId += static_cast<size_t>(len);
             } else if (len == TENSORLEN) {
                 MKI_LOG(DEBUG) << "args info: input " << i << " tensorId: " << tensorId;
-                args[argsIdx++] = launchParam.GetInTensor(tensorId++).data;
+                SetArg(args, argsIdx++, launchParam.GetInTensor(tensorId).data, KernelInfo::ArgsPatchType::INPUT,
+                       tensorId, 0);
+                tensorId++;
             }
             i++;
         }
@@ -238,7 +293,9 @@ private:
                 tensorId += static_cast<size_t>(len);
             } else if (len == TENSORLEN) {
                 MKI_LOG(DEBUG) << "args info: output " << i + inputNum << " tensorId: " << tensorId;
-                args[argsIdx++] = launchParam.GetOutTensor(tensorId++).data;
+                SetArg(args, argsIdx++, launchParam.GetOutTensor(tensorId).data, KernelInfo::ArgsPatchType::OUTPUT,
+                       tensorId, 0);
+                tensorId++;
             }
             i++;
         }
@@ -249,19 +306,23 @@ private:
                 continue;
             }
             MKI_LOG(DEBUG) << "args info: workspace " << argsIdx << " offset " << workspaceOffset;
-            args[argsIdx] = workspaceAddr + workspaceOffset;
+            SetArg(args, argsIdx, workspaceAddr + workspaceOffset, KernelInfo::ArgsPatchType::WORKSPACE, 0,
+                   workspaceOffset);
             workspaceOffset += workspaces.at(i++);
         }
         return Status::OkStatus();
     }
 
 private:
-    RtArgsExT argsEx_;
+    KernelInfo::FrozenArgsInfo *frozenArgsInfo_{nullptr};
+    RtArgsExT ownArgsEx_;
+    RtArgsExT *argsEx_{&ownArgsEx_};
     std::unique_ptr<RtHostInputInfoT[]> hostInfo_{nullptr};
     MkiRtKernelParam kernelParam_;
 };
 
-KernelBase::KernelBase(const std::string &opName, const BinHandle *handle) : kernelName_(opName), handle_(handle)
+KernelBase::KernelBase(const std::string &opName, const BinHandle *handle)
+    : kernelName_(opName), handle_(handle), tilingCache_(std::make_shared<TilingCache>())
 {
     if (handle_ != nullptr) {
         launchBufferSize_ = handle_->GetKernelTilingSize();
@@ -296,6 +357,20 @@ void KernelBase::SetLaunchWithTiling(bool flag) { kernelInfo_.SetLaunchWithTilin
 
 void KernelBase::SetTilingHostAddr(uint8_t *addr, uint64_t len) { kernelInfo_.SetTilingHostAddr(addr, len); }
 
+void KernelBase::SetHostAllocator(HostAllocator *allocator) { kernelInfo_.SetHostAllocator(allocator); }
+
+void KernelBase::SetArgsFrozen(bool flag) { kernelInfo_.SetArgsFrozen(flag); }
+
+void KernelBase::SetTilingCacheCapacity(size_t capacity) { tilingCache_->SetCapacity(capacity); }
+
+TilingCacheStats KernelBase::GetTilingCacheStats() const { return tilingCache_->GetStats(); }
+
+KernelPool *KernelBase::GetKernelPool() const
+{
+    std::call_once(kernelPoolFlag_, [this]() { kernelPool_ = std::make_unique<KernelPool>(this); });
+    return kernelPool_.get();
+}
+
 void KernelBase::Reset()
 {
     kernelInfo_.Reset();
@@ -303,8 +378,33 @@ void KernelBase::Reset()
 
 Status KernelBase::Init(const LaunchParam &launchParam)
 {
-    MKI_CHECK(CheckInTensors(launchParam), "Not supported in tensors", return Status::FailStatus(1));
-    MKI_CHECK(CanSupport(launchParam), "Not supported op", return Status::FailStatus(1));
+    std::string cacheKey;
+    bool useTilingCache = tilingCache_->GetCapacity() > 0 && kernelInfo_.GetLaunchWithTiling() &&
+                          tilingCache_->GenerateKey(launchParam, cacheKey);
+    if (useTilingCache && tilingCache_->Get(cacheKey, kernelInfo_)) {
+        MKI_LOG(DEBUG) << kernelName_ << " init with cached tiling";
+        return Status::OkStatus();
+    }
+    Status status = InitKernelInfo(launchParam);
+    if (useTilingCache && status.Ok()) {
+        tilingCache_->Put(cacheKey, kernelInfo_);
+    }
+    return status;
+}
+
+Status KernelBase::InitKernelInfo(const LaunchParam &launchParam)
+{
+    MKI_CHECK(handle_ == nullptr || handle_->EnsureRegistered(), kernelName_ << " register kernel binary fail",
+              return Status::FailStatus(1));
+    // bad shapes from one client can hit these on every launch, so the logs are rate limited
+    if (!CheckInTensors(launchParam)) {
+        MKI_LOG_EVERY_MS(ERROR, FAILURE_LOG_INTERVAL_MS) << kernelName_ << " not supported in tensors";
+        return Status::FailStatus(1);
+    }
+    if (!CanSupport(launchParam)) {
+        MKI_LOG_EVERY_MS(ERROR, FAILURE_LOG_INTERVAL_MS) << kernelName_ << " not supported op";
+        return Status::FailStatus(1);
+    }
 
     kernelInfo_.Reset();
 
@@ -315,9 +415,8 @@ Status KernelBase::Init(const LaunchParam &launchParam)
         MKI_CHECK(st.Ok(), "Failed to alloc host tiling buffer " << st.ToString(), return st);
     }
 
-    if (launchParam.GetInputLenCount() > 0 || launchParam.GetOutputLenCount()) {
-        kernelInfo_.SetLaunchWithTensorlist(true);
-    }
+    // derived from every launchParam, so a recycled kernel does not keep the mode of its last user
+    kernelInfo_.SetLaunchWithTensorlist(launchParam.GetInputLenCount() > 0 || launchParam.GetOutputLenCount() > 0);
     bool launchWithTensorlist = kernelInfo_.GetLaunchWithTensorlist();
     auto tensorListSize = Utils::GetTensorAlignedSize(GetTensorListSize(launchParam));
     if (launchWithTensorlist) {
@@ -380,21 +479,147 @@ uint64_t KernelBase::GetKernelArgsNum(const LaunchParam &launchParam)
 
 Status KernelBase::Run(const LaunchParam &launchParam, RunInfo &runInfo)
 {
-    KernelParamBuilder paramBuilder;
+    bool uploadTiling = !kernelInfo_.GetLaunchWithTiling() && runInfo.GetTilingDeviceAddr() == nullptr &&
+                        kernelInfo_.GetTilingSize() > 0;
+    LaunchGraph *graph = LaunchGraph::GetCapturing();
+    if (graph != nullptr) {
+        return RunWithCapture(*graph, launchParam, runInfo, uploadTiling);
+    }
+    if (uploadTiling) {
+        return RunWithTilingRing(launchParam, runInfo);
+    }
+    return RunKernel(launchParam, runInfo);
+}
+
+Status KernelBase::RunWithCapture(LaunchGraph &graph, const LaunchParam &launchParam, const RunInfo &runInfo,
+                                  bool uploadTiling)
+{
+    RunInfo captureRunInfo;
+    captureRunInfo.Copy(runInfo);
+    if (uploadTiling) {
+        // ring slots are recycled, the graph keeps its own tiling for replays
+        MKI_CHECK(kernelInfo_.GetTilingHostAddr() != nullptr, kernelName_ << " tiling host addr is nullptr",
+                  return Status::FailStatus(ERROR_INVALID_VALUE));
+        uint8_t *tilingDeviceAddr =
+            graph.AddTiling(kernelInfo_.GetTilingHostAddr(), kernelInfo_.GetTilingSize(), runInfo.GetStream());
+        MKI_CHECK(tilingDeviceAddr != nullptr, kernelName_ << " capture tiling fail",
+                  return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "capture tiling fail"));
+        captureRunInfo.SetTilingDeviceAddr(tilingDeviceAddr);
+    }
+    // args are built from scratch so that every address slot is recorded
+    KernelInfo::FrozenArgsInfo captureArgsInfo;
+    KernelParamBuilder paramBuilder(&captureArgsInfo);
+    uint64_t argsNum = GetKernelArgsNum(launchParam);
+    Status status = paramBuilder.Init(launchParam, captureRunInfo, argsNum, kernelInfo_);
+    MKI_CHECK(status.Ok(), "failed to build kernel params", return status);
+    status = LaunchKernel(paramBuilder.GetKernelParam(), runInfo.GetStream());
+    MKI_CHECK(status.Ok(), kernelName_ << " launch in capture fail", return status);
+    graph.AddNode(handle_, kernelName_, paramBuilder.GetKernelParam(), captureArgsInfo, kernelInfo_.GetMemsetInfo(),
+                  launchParam, captureRunInfo);
+    return status;
+}
+
+Status KernelBase::RunWithTilingRing(const LaunchParam &launchParam, const RunInfo &runInfo)
+{
+    // no tiling device memory from the caller, the tiling is uploaded to the ring of the stream asynchronously
+    MKI_CHECK(kernelInfo_.GetTilingHostAddr() != nullptr, kernelName_ << " tiling host addr is nullptr",
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    TilingRingBuffer *tilingRing = GetTilingRingBuffer();
+    uint8_t *tilingDeviceAddr = nullptr;
+    int st = tilingRing->Upload(runInfo.GetStream(), kernelInfo_.GetTilingHostAddr(), kernelInfo_.GetTilingSize(),
+                                &tilingDeviceAddr);
+    MKI_CHECK(st == MKIRT_SUCCESS, kernelName_ << " upload tiling to ring fail, ret " << st,
+              return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "upload tiling fail"));
+    RunInfo ringRunInfo;
+    ringRunInfo.Copy(runInfo);
+    ringRunInfo.SetTilingDeviceAddr(tilingDeviceAddr);
+    Status status = RunKernel(launchParam, ringRunInfo);
+    // the slot is committed even when launch fails, so it is recycled with the work queued before
+    st = tilingRing->Commit(runInfo.GetStream());
+    MKI_CHECK(st == MKIRT_SUCCESS, kernelName_ << " commit tiling ring fail, ret " << st,
+              return Status::FailStatus(ERROR_SYNC_STREAM_ERROR, "commit tiling ring fail"));
+    return status;
+}
+
+Status KernelBase::BuildBatchLaunch(const LaunchParam &launchParam, const RunInfo &runInfo, uint8_t *args,
+                                    KernelInfo::FrozenArgsInfo &argsInfo, MkiRtKernelParam &kernelParam,
+                                    MkiRtLaunchItem &launchItem)
+{
+    MKI_CHECK(handle_ != nullptr, kernelName_ << " handle is nullptr", return Status::FailStatus(ERROR_INVALID_VALUE));
+    MKI_CHECK(args != nullptr, kernelName_ << " batch args is nullptr",
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    KernelParamBuilder paramBuilder(&argsInfo);
+    uint64_t argsNum = GetKernelArgsNum(launchParam);
+    Status status = paramBuilder.Init(launchParam, runInfo, argsNum, kernelInfo_, args);
+    MKI_CHECK(status.Ok(), "failed to build kernel params", return status);
+    kernelParam = paramBuilder.GetKernelParam();
+    launchItem.handle = *handle_->GetHandle();
+    launchItem.func = handle_->GetHandle();
+    launchItem.param = &kernelParam;
+    return status;
+}
+
+Status KernelBase::RunKernel(const LaunchParam &launchParam, const RunInfo &runInfo)
+{
+    bool argsFrozen = kernelInfo_.GetArgsFrozen();
+    KernelInfo::FrozenArgsInfo &frozenArgsInfo = kernelInfo_.GetFrozenArgsInfo();
+    if (argsFrozen && frozenArgsInfo.valid && frozenArgsInfo.inTensorCount == launchParam.GetInTensorCount() &&
+        frozenArgsInfo.outTensorCount == launchParam.GetOutTensorCount()) {
+        return RunWithFrozenArgs(launchParam, runInfo);
+    }
+
+    KernelParamBuilder paramBuilder(argsFrozen ? &frozenArgsInfo : nullptr);
     uint64_t argsNum = GetKernelArgsNum(launchParam);
     Status status = paramBuilder.Init(launchParam, runInfo, argsNum, kernelInfo_);
     MKI_CHECK(status.Ok(), "failed to build kernel params", return status);
-    const MkiRtKernelParam &kernelParam = paramBuilder.GetKernelParam();
     MKI_LOG(INFO) << "Ready to run, KernelInfo:\n" << kernelInfo_.ToString();
+    return LaunchKernel(paramBuilder.GetKernelParam(), runInfo.GetStream());
+}
+
+Status KernelBase::RunWithFrozenArgs(const LaunchParam &launchParam, const RunInfo &runInfo)
+{
+    KernelInfo::FrozenArgsInfo &frozenArgsInfo = kernelInfo_.GetFrozenArgsInfo();
+    uint8_t *argsPtr = kernelInfo_.GetArgs();
+    MKI_CHECK(argsPtr != nullptr, "args is nullptr", return Status::FailStatus(-1));
+    for (const auto &patchInfo : frozenArgsInfo.patchInfos) {
+        void *addr = nullptr;
+        switch (patchInfo.type) {
+            case KernelInfo::ArgsPatchType::INPUT: addr = launchParam.GetInTensor(patchInfo.tensorIdx).data; break;
+            case KernelInfo::ArgsPatchType::OUTPUT: addr = launchParam.GetOutTensor(patchInfo.tensorIdx).data; break;
+            case KernelInfo::ArgsPatchType::WORKSPACE:
+                addr = runInfo.GetScratchDeviceAddr() + patchInfo.addrOffset; break;
+            case KernelInfo::ArgsPatchType::TILING:
+                addr = runInfo.GetTilingDeviceAddr() + patchInfo.addrOffset; break;
+            default: break;
+        }
+        *reinterpret_cast<void **>(static_cast<void *>(argsPtr + patchInfo.argOffset)) = addr;
+    }
+
+    const auto &memsetInfo = kernelInfo_.GetMemsetInfo();
+    if (memsetInfo.size() != 0) {
+        Status status = ClearTensors(reinterpret_cast<void **>(static_cast<void *>(argsPtr)), frozenArgsInfo.argsNum,
+                                     memsetInfo, runInfo.GetStream());
+        MKI_CHECK(status.Ok(), "failed to clear tensors", return status);
+    }
+
+    MkiRtKernelParam kernelParam;
+    kernelParam.tilingId = kernelInfo_.GetTilingId();
+    kernelParam.blockDim = kernelInfo_.GetBlockDim();
+    kernelParam.argsEx = &frozenArgsInfo.argsEx;
+    return LaunchKernel(kernelParam, runInfo.GetStream());
+}
+
+Status KernelBase::LaunchKernel(const MkiRtKernelParam &kernelParam, void *stream) const
+{
     if (*handle_->GetHandle() != nullptr) {
         MKI_LOG(DEBUG) << "launch function with handle";
-        int st = MkiRtFunctionLaunchWithHandle(*handle_->GetHandle(), &kernelParam, runInfo.GetStream(), nullptr);
+        int st = MkiRtFunctionLaunchWithHandle(*handle_->GetHandle(), &kernelParam, stream, nullptr);
         MKI_CHECK(
             st == MKIRT_SUCCESS, "Mki RtFunction LaunchWithHandle fail",
             return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "Mki RtFunction LaunchWithHandle fail"));
     } else {
         MKI_LOG(DEBUG) << "launch function with flag";
-        int st = MkiRtFunctionLaunchWithFlag(handle_->GetHandle(), &kernelParam, runInfo.GetStream(), nullptr);
+        int st = MkiRtFunctionLaunchWithFlag(handle_->GetHandle(), &kernelParam, stream, nullptr);
         MKI_CHECK(st == MKIRT_SUCCESS, "Mki RtFunction LaunchWithFlag fail",
                     return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "Mki RtFunction Launch fail"));
     }
@@ -414,6 +639,7 @@ void KernelBase::Copy(const KernelBase &other)
     handle_ = other.handle_;
     kernelType_ = other.kernelType_;
     creator_ = other.creator_;
+    tilingCache_ = other.tilingCache_;
     kernelInfo_.Copy(other.kernelInfo_);
 }
 
@@ -81,6 +81,17 @@ Kernel *OperationBase::GetKernelByName(const std::string &kernelName) const
     return (it->second)->Clone();
 }
 
+PooledKernel OperationBase::AcquireKernelByName(const std::string &kernelName) const
+{
+    auto it = kernelMap_.find(kernelName);
+    if (it == kernelMap_.end()) {
+        MKI_LOG(ERROR) << "Kernel " << kernelName << " is not found, maybe it's not supported in this soc";
+        return nullptr;
+    }
+    KernelPool *pool = (it->second)->GetKernelPool();
+    return pool != nullptr ? pool->AcquireScoped() : PooledKernel((it->second)->Clone());
+}
+
 void OperationBase::AddKernel(const std::string &kernelName, Kernel const *kernel)
 {
     MKI_CHECK(kernel != nullptr, "kernel is nullptr", return);
@@ -20,13 +20,9 @@
 namespace Mki {
 KernelInfo::~KernelInfo()
 {
-    ResetArgs();
-    if (launchWithTiling_ && tilingExtInfo_.hostTilingAddr != nullptr) {
-        delete[] tilingExtInfo_.hostTilingAddr;
-    }
-    if (launchWithTensorlist_ && tensorListExtInfo_.tensorListAddr != nullptr) {
-        delete[] tensorListExtInfo_.tensorListAddr;
-    }
+    ReleaseHostBuffer(argsBuffer_);
+    ReleaseHostBuffer(tilingBuffer_);
+    ReleaseHostBuffer(tensorListBuffer_);
 }
 
 void KernelInfo::Reset()
@@ -40,12 +36,47 @@ void KernelInfo::Reset()
     ResetMemsetInfo();
 }
 
+void KernelInfo::SetHostAllocator(HostAllocator *allocator)
+{
+    MKI_CHECK(allocator != nullptr, "host allocator is nullptr", return);
+    if (allocator == hostAllocator_) {
+        return;
+    }
+    Reset();
+    ReleaseHostBuffer(argsBuffer_);
+    ReleaseHostBuffer(tilingBuffer_);
+    ReleaseHostBuffer(tensorListBuffer_);
+    hostAllocator_ = allocator;
+}
+
+HostAllocator *KernelInfo::GetHostAllocator() const { return hostAllocator_; }
+
+uint8_t *KernelInfo::AcquireHostBuffer(HostBuffer &buffer, uint64_t len)
+{
+    if (buffer.addr != nullptr && buffer.capacity >= len) {
+        return buffer.addr;
+    }
+    ReleaseHostBuffer(buffer);
+    buffer.addr = hostAllocator_->Allocate(len);
+    buffer.capacity = buffer.addr == nullptr ? 0 : len;
+    return buffer.addr;
+}
+
+void KernelInfo::ReleaseHostBuffer(HostBuffer &buffer)
+{
+    if (buffer.addr != nullptr) {
+        hostAllocator_->Deallocate(buffer.addr, buffer.capacity);
+        buffer.addr = nullptr;
+    }
+    buffer.capacity = 0;
+}
+
 Status KernelInfo::InitArgs(uint64_t len)
 {
     constexpr uint64_t maxArgsSize = 1024 * 1024; // 1mb
     MKI_CHECK(len > 0 && len <= maxArgsSize, "failed to check args len " << len, return Status::FailStatus(-1));
 
-    args_ = new (std::nothrow) uint8_t[len];
+    args_ = AcquireHostBuffer(argsBuffer_, len);
     MKI_CHECK(args_ != nullptr, "failed to new args, len " << len, return Status::FailStatus(-1));
     (void)memset_s(args_, len, 0, len);
 
@@ -120,7 +151,7 @@ Status KernelInfo::AllocTilingHost(uint64_t len)
     MKI_CHECK(tilingExtInfo_.hostTilingAddr == nullptr,
         "Tiling is already alloced", return Status::FailStatus(-1));
 
-    tilingExtInfo_.hostTilingAddr = new (std::nothrow) uint8_t[len];
+    tilingExtInfo_.hostTilingAddr = AcquireHostBuffer(tilingBuffer_, len);
     MKI_CHECK(tilingExtInfo_.hostTilingAddr != nullptr,
         "failed to new tiling, len " << len, return Status::FailStatus(-1));
     (void)memset_s(tilingExtInfo_.hostTilingAddr, len, 0, len);
@@ -157,7 +188,7 @@ Status KernelInfo::AllocTensorListHost(uint64_t len) {
     MKI_CHECK(tensorListExtInfo_.tensorListAddr == nullptr,
         "TensorList is already alloced", return Status::FailStatus(-1));
 
-    tensorListExtInfo_.tensorListAddr = new (std::nothrow) uint8_t[len];
+    tensorListExtInfo_.tensorListAddr = AcquireHostBuffer(tensorListBuffer_, len);
     MKI_CHECK(tensorListExtInfo_.tensorListAddr != nullptr,
         "failed to new tensorList, len " << len, return Status::FailStatus(-1));
     (void)memset_s(tensorListExtInfo_.tensorListAddr, len, 0, len);
@@ -209,6 +240,21 @@ const MiniVector<KernelInfo::MemsetInfo> &KernelInfo::GetMemsetInfo() const
     return memsetInfo_;
 }
 
+void KernelInfo::SetArgsFrozen(bool flag)
+{
+    if (argsFrozen_ == flag) {
+        return;
+    }
+    ResetFrozenArgsInfo();
+    argsFrozen_ = flag;
+}
+
+bool KernelInfo::GetArgsFrozen() const { return argsFrozen_; }
+
+KernelInfo::FrozenArgsInfo &KernelInfo::GetFrozenArgsInfo() { return frozenArgsInfo_; }
+
+const KernelInfo::FrozenArgsInfo &KernelInfo::GetFrozenArgsInfo() const { return frozenArgsInfo_; }
+
 uint64_t KernelInfo::GetConstTensorOffset() const
 {
     return tilingExtInfo_.constTensorOffset;
@@ -350,6 +396,7 @@ std::string KernelInfo::ToString() const
 void KernelInfo::Copy(const KernelInfo &other)
 {
     launchWithTiling_ = other.launchWithTiling_;
+    argsFrozen_ = other.argsFrozen_;
     if (!other.initFlag_) {
         MKI_LOG(WARN) << "copy blank kernel info";
         initFlag_ = false;
@@ -389,18 +436,26 @@ void KernelInfo::Copy(const KernelInfo &other)
 
 void KernelInfo::ResetArgs()
 {
-    if (args_ != nullptr) {
-        delete[] args_;
-        args_ = nullptr;
-    }
+    args_ = nullptr; // buffer is kept in argsBuffer_ for the next InitArgs
     argsSize_ = 0;
+    ResetFrozenArgsInfo();
+}
+
+void KernelInfo::ResetFrozenArgsInfo()
+{
+    frozenArgsInfo_.valid = false;
+    frozenArgsInfo_.argsNum = 0;
+    frozenArgsInfo_.inTensorCount = 0;
+    frozenArgsInfo_.outTensorCount = 0;
+    frozenArgsInfo_.argsEx = RtArgsExT();
+    frozenArgsInfo_.hostInputInfos.clear();
+    frozenArgsInfo_.patchInfos.clear();
 }
 
 void KernelInfo::ResetTilingInfo()
 {
     // No checking return value is ok
     if (launchWithTiling_ && tilingExtInfo_.hostTilingAddr != nullptr) {
-        delete[] tilingExtInfo_.hostTilingAddr;
         tilingExtInfo_.hostTilingAddr = nullptr;
         tilingExtInfo_.hostTilingSize = 0;
         tilingExtInfo_.constTensorOffset = 0;
@@ -413,7 +468,6 @@ void KernelInfo::ResetTilingInfo()
 void KernelInfo::ResetTensorListExtInfo()
 {
     if (launchWithTensorlist_ && tensorListExtInfo_.tensorListAddr != nullptr) {
-        delete[] tensorListExtInfo_.tensorListAddr;
         tensorListExtInfo_.tensorListAddr = nullptr;
         tensorListExtInfo_.tensorListSize = 0;
     }
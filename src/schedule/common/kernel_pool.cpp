@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/kernel_pool.h"
+#include "mki/kernel.h"
+#include "mki/utils/assert/assert.h"
+#include "mki/utils/log/log.h"
+
+namespace Mki {
+constexpr size_t DEFAULT_KERNEL_POOL_CAPACITY = 64;
+constexpr size_t MAX_KERNEL_POOL_CAPACITY = 4096;
+
+void KernelPoolDeleter::operator()(Kernel *kernel) const
+{
+    if (pool != nullptr) {
+        pool->Release(kernel);
+    } else {
+        delete kernel;
+    }
+}
+
+KernelPool::KernelPool(const Kernel *prototype) : prototype_(prototype), capacity_(DEFAULT_KERNEL_POOL_CAPACITY) {}
+
+KernelPool::~KernelPool() { Clear(); }
+
+size_t KernelPool::GetThreadShardIdx()
+{
+    static std::atomic<size_t> nextShardIdx{0};
+    thread_local size_t shardIdx = nextShardIdx++ % SHARD_NUM;
+    return shardIdx;
+}
+
+void KernelPool::UpdateHighWater(std::atomic<size_t> &highWater, size_t value)
+{
+    size_t current = highWater.load(std::memory_order_relaxed);
+    while (value > current && !highWater.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+Kernel *KernelPool::PopIdle(size_t shardIdx)
+{
+    Shard &shard = shards_[shardIdx];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.idleKernels.empty()) {
+        return nullptr;
+    }
+    Kernel *kernel = shard.idleKernels.back();
+    shard.idleKernels.pop_back();
+    idleCount_--;
+    return kernel;
+}
+
+Kernel *KernelPool::Acquire()
+{
+    MKI_CHECK(prototype_ != nullptr, "kernel pool prototype is nullptr", return nullptr);
+    acquireCount_++;
+    size_t homeIdx = GetThreadShardIdx();
+    Kernel *kernel = PopIdle(homeIdx);
+    if (kernel != nullptr) {
+        localHitCount_++;
+    }
+    for (size_t i = 1; kernel == nullptr && idleCount_ > 0 && i < SHARD_NUM; ++i) {
+        kernel = PopIdle((homeIdx + i) % SHARD_NUM);
+    }
+    if (kernel == nullptr) {
+        kernel = prototype_->Clone();
+        MKI_CHECK(kernel != nullptr, prototype_->GetName() << " clone kernel fail", return nullptr);
+        createCount_++;
+        MKI_LOG(DEBUG) << prototype_->GetName() << " kernel pool create instance, total " << createCount_;
+    }
+    UpdateHighWater(inUseHighWater_, ++inUseCount_);
+    return kernel;
+}
+
+void KernelPool::RecycleKernel(Kernel *kernel) const
+{
+    // drop the args, frozen args and tiling of the last user and restore the launch mode of the prototype,
+    // host buffers are kept for the next Init
+    kernel->Reset();
+    const KernelInfo &prototypeInfo = prototype_->GetKernelInfo();
+    kernel->SetLaunchWithTiling(prototypeInfo.GetLaunchWithTiling());
+    kernel->SetArgsFrozen(prototypeInfo.GetArgsFrozen());
+}
+
+void KernelPool::Release(Kernel *kernel)
+{
+    if (kernel == nullptr) {
+        return;
+    }
+    releaseCount_++;
+    inUseCount_--;
+    // reserve an idle slot first, so concurrent releases can not exceed the capacity
+    size_t idleCount = idleCount_.load(std::memory_order_relaxed);
+    do {
+        if (idleCount >= capacity_) {
+            dropCount_++;
+            delete kernel;
+            return;
+        }
+    } while (!idleCount_.compare_exchange_weak(idleCount, idleCount + 1, std::memory_order_relaxed));
+    UpdateHighWater(idleHighWater_, idleCount + 1);
+    RecycleKernel(kernel);
+    Shard &shard = shards_[GetThreadShardIdx()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.idleKernels.push_back(kernel);
+}
+
+PooledKernel KernelPool::AcquireScoped() { return PooledKernel(Acquire(), KernelPoolDeleter{this}); }
+
+void KernelPool::SetCapacity(size_t capacity)
+{
+    MKI_CHECK(capacity <= MAX_KERNEL_POOL_CAPACITY, "kernel pool capacity " << capacity << " is too large",
+              return);
+    capacity_ = capacity;
+}
+
+size_t KernelPool::GetCapacity() const { return capacity_; }
+
+void KernelPool::Clear()
+{
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (Kernel *kernel : shard.idleKernels) {
+            delete kernel;
+        }
+        idleCount_ -= shard.idleKernels.size();
+        shard.idleKernels.clear();
+    }
+}
+
+KernelPoolStats KernelPool::GetStats() const
+{
+    KernelPoolStats stats;
+    stats.acquireCount = acquireCount_;
+    stats.createCount = createCount_;
+    stats.localHitCount = localHitCount_;
+    stats.releaseCount = releaseCount_;
+    stats.dropCount = dropCount_;
+    stats.idleCount = idleCount_;
+    stats.inUseCount = inUseCount_;
+    stats.idleHighWater = idleHighWater_;
+    stats.inUseHighWater = inUseHighWater_;
+    stats.capacity = capacity_;
+    return stats;
+}
+} // namespace Mki
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/launch_batch.h"
+#include "mki/base/kernel_base.h"
+#include "mki/launch_graph.h"
+#include "mki/types.h"
+#include "mki/utils/assert/assert.h"
+#include "mki/utils/log/log.h"
+#include "mki/utils/math/math.h"
+#include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/memory/tiling_ring_buffer.h"
+
+namespace Mki {
+namespace {
+constexpr size_t BATCH_ARGS_ALIGN = 64; // 64: the args of every kernel start on a cache line
+
+struct BatchContext {
+    std::vector<uint8_t> args;
+    std::vector<KernelInfo::FrozenArgsInfo> argsInfos;
+    std::vector<MkiRtKernelParam> kernelParams;
+    std::vector<MkiRtLaunchItem> launchItems;
+};
+
+struct BatchState {
+    MkiRtStream stream = nullptr;
+    uint32_t submitted = 0; // launch items before it are submitted
+    uint32_t built = 0;
+    bool ringUsed = false;  // tiling slots are uploaded since the last commit
+};
+
+// buffers are kept by the thread, so launching batches of the same shape does not allocate
+thread_local BatchContext g_batchContext;
+
+Status FlushBatch(BatchContext &context, BatchState &state)
+{
+    int st = MKIRT_SUCCESS;
+    if (state.built > state.submitted) {
+        st = MkiRtFunctionLaunchBatch(context.launchItems.data() + state.submitted, state.built - state.submitted,
+                                      state.stream);
+        MKI_LOG(DEBUG) << "launch batch of " << (state.built - state.submitted) << ", ret " << st;
+        state.submitted = state.built;
+    }
+    if (state.ringUsed) {
+        // the slots are committed even when launch fails, so they are recycled with the work queued before
+        state.ringUsed = false;
+        int commitSt = GetTilingRingBuffer()->Commit(state.stream);
+        MKI_CHECK(commitSt == MKIRT_SUCCESS, "commit tiling ring fail, ret " << commitSt,
+                  return Status::FailStatus(ERROR_SYNC_STREAM_ERROR, "commit tiling ring fail"));
+    }
+    MKI_CHECK(st == MKIRT_SUCCESS, "Mki RtFunction LaunchBatch fail, ret " << st,
+              return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "Mki RtFunction LaunchBatch fail"));
+    return Status::OkStatus();
+}
+
+Status UploadTiling(BatchContext &context, BatchState &state, const KernelBase &kernel, RunInfo &runInfo)
+{
+    const KernelInfo &kernelInfo = kernel.GetKernelInfo();
+    MKI_CHECK(kernelInfo.GetTilingHostAddr() != nullptr, kernel.GetName() << " tiling host addr is nullptr",
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    TilingRingBuffer *tilingRing = GetTilingRingBuffer();
+    uint8_t *tilingDeviceAddr = nullptr;
+    int st = tilingRing->Upload(state.stream, kernelInfo.GetTilingHostAddr(), kernelInfo.GetTilingSize(),
+                                &tilingDeviceAddr);
+    if (st == MKIRT_ERROR_OUT_OF_MEMORY && state.ringUsed) {
+        // the ring is full of slots of this batch, submit them so that the slots can be recycled
+        Status status = FlushBatch(context, state);
+        MKI_CHECK(status.Ok(), "failed to flush launch batch", return status);
+        st = tilingRing->Upload(state.stream, kernelInfo.GetTilingHostAddr(), kernelInfo.GetTilingSize(),
+                                &tilingDeviceAddr);
+    }
+    MKI_CHECK(st == MKIRT_SUCCESS, kernel.GetName() << " upload tiling to ring fail, ret " << st,
+              return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "upload tiling fail"));
+    state.ringUsed = true;
+    runInfo.SetTilingDeviceAddr(tilingDeviceAddr);
+    return Status::OkStatus();
+}
+
+Status RunKernel(Kernel &kernel, const LaunchParam &launchParam, const RunInfo &runInfo)
+{
+    RunInfo kernelRunInfo;
+    kernelRunInfo.Copy(runInfo);
+    Status status = kernel.Run(launchParam, kernelRunInfo);
+    MKI_CHECK(status.Ok(), kernel.GetName() << " run in launch batch fail", return status);
+    return status;
+}
+
+Status AddKernel(BatchContext &context, BatchState &state, KernelBase &kernel, const LaunchBatchItem &item,
+                 uint64_t argsOffset)
+{
+    const KernelInfo &kernelInfo = kernel.GetKernelInfo();
+    if (kernelInfo.GetMemsetInfo().size() != 0) {
+        // tensors are cleared on the stream while the args are built, the launches before go first
+        Status status = FlushBatch(context, state);
+        MKI_CHECK(status.Ok(), "failed to flush launch batch", return status);
+    }
+    RunInfo runInfo;
+    runInfo.Copy(*item.runInfo);
+    if (!kernelInfo.GetLaunchWithTiling() && runInfo.GetTilingDeviceAddr() == nullptr &&
+        kernelInfo.GetTilingSize() > 0) {
+        Status status = UploadTiling(context, state, kernel, runInfo);
+        MKI_CHECK(status.Ok(), "failed to upload tiling", return status);
+    }
+    uint32_t idx = state.built;
+    Status status = kernel.BuildBatchLaunch(*item.launchParam, runInfo, context.args.data() + argsOffset,
+                                            context.argsInfos[idx], context.kernelParams[idx],
+                                            context.launchItems[idx]);
+    MKI_CHECK(status.Ok(), kernel.GetName() << " build launch in batch fail", return status);
+    state.built++;
+    return status;
+}
+} // namespace
+
+Status LaunchBatch(const std::vector<LaunchBatchItem> &items)
+{
+    MKI_CHECK(!items.empty(), "launch batch is empty", return Status::FailStatus(ERROR_INVALID_VALUE));
+    for (const auto &item : items) {
+        MKI_CHECK(item.kernel != nullptr && item.launchParam != nullptr && item.runInfo != nullptr,
+                  "launch batch item is invalid", return Status::FailStatus(ERROR_INVALID_VALUE));
+        MKI_CHECK(item.runInfo->GetStream() == items[0].runInfo->GetStream(),
+                  "launch batch items use different streams", return Status::FailStatus(ERROR_INVALID_VALUE));
+    }
+    if (LaunchGraph::GetCapturing() != nullptr) {
+        // every kernel becomes a node of its own in the graph
+        for (const auto &item : items) {
+            Status status = RunKernel(*item.kernel, *item.launchParam, *item.runInfo);
+            MKI_CHECK_NO_LOG(status.Ok(), return status);
+        }
+        return Status::OkStatus();
+    }
+
+    size_t argsSize = 0;
+    for (const auto &item : items) {
+        if (dynamic_cast<KernelBase *>(item.kernel) != nullptr) {
+            argsSize += Utils::RoundUp(item.kernel->GetKernelInfo().GetArgsSize(), BATCH_ARGS_ALIGN);
+        }
+    }
+    BatchContext &context = g_batchContext;
+    if (context.args.size() < argsSize) {
+        context.args.resize(argsSize);
+    }
+    if (context.launchItems.size() < items.size()) {
+        context.argsInfos.resize(items.size());
+        context.kernelParams.resize(items.size());
+        context.launchItems.resize(items.size());
+    }
+
+    BatchState state;
+    state.stream = items[0].runInfo->GetStream();
+    uint64_t argsOffset = 0;
+    Status status = Status::OkStatus();
+    for (const auto &item : items) {
+        KernelBase *kernel = dynamic_cast<KernelBase *>(item.kernel);
+        if (kernel == nullptr) {
+            status = FlushBatch(context, state);
+            if (status.Ok()) {
+                status = RunKernel(*item.kernel, *item.launchParam, *item.runInfo);
+            }
+        } else {
+            status = AddKernel(context, state, *kernel, item, argsOffset);
+            argsOffset += Utils::RoundUp(kernel->GetKernelInfo().GetArgsSize(), BATCH_ARGS_ALIGN);
+        }
+        if (!status.Ok()) {
+            break;
+        }
+    }
+    // kernels built before a failure are still launched, as if they were run one by one
+    Status flushStatus = FlushBatch(context, state);
+    return status.Ok() ? flushStatus : status;
+}
+} // namespace Mki
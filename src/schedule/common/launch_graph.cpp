@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/launch_graph.h"
+#include <algorithm>
+#include <securec.h>
+#include "mki/types.h"
+#include "mki/utils/assert/assert.h"
+#include "mki/utils/log/log.h"
+#include "mki/utils/memset/clear_tensors.h"
+#include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/memory/caching_allocator.h"
+
+namespace Mki {
+static thread_local LaunchGraph *g_capturingGraph = nullptr;
+
+LaunchGraph::~LaunchGraph()
+{
+    if (g_capturingGraph == this) {
+        g_capturingGraph = nullptr;
+    }
+    Clear();
+}
+
+Status LaunchGraph::BeginCapture()
+{
+    MKI_CHECK(g_capturingGraph == nullptr, "another launch graph is capturing on this thread",
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    Clear();
+    capturing_ = true;
+    g_capturingGraph = this;
+    return Status::OkStatus();
+}
+
+Status LaunchGraph::EndCapture()
+{
+    MKI_CHECK(capturing_ && g_capturingGraph == this, "launch graph is not capturing on this thread",
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    capturing_ = false;
+    g_capturingGraph = nullptr;
+    MKI_LOG(INFO) << "launch graph captured " << nodes_.size() << " nodes";
+    return Status::OkStatus();
+}
+
+bool LaunchGraph::IsCapturing() const { return capturing_; }
+
+void LaunchGraph::Clear()
+{
+    // replays on other streams than the one the tiling was allocated on may still read it
+    WaitReplays();
+    DestroyNativeModel();
+    nodes_.clear();
+    hostMemset_ = false;
+    for (auto &buffer : tilingBuffers_) {
+        (void)GetDeviceCachingAllocator()->Free(buffer.first);
+    }
+    tilingBuffers_.clear();
+    for (auto &replayEvent : replayEvents_) {
+        (void)MkiRtEventDestroy(replayEvent.second);
+    }
+    replayEvents_.clear();
+}
+
+size_t LaunchGraph::GetNodeCount() const { return nodes_.size(); }
+
+const std::string &LaunchGraph::GetNodeName(size_t nodeIdx) const
+{
+    static const std::string emptyName;
+    return nodeIdx < nodes_.size() ? nodes_[nodeIdx].name : emptyName;
+}
+
+LaunchGraph *LaunchGraph::GetCapturing() { return g_capturingGraph; }
+
+uint8_t *LaunchGraph::AddTiling(const uint8_t *hostTiling, uint64_t size, MkiRtStream stream)
+{
+    MKI_CHECK(hostTiling != nullptr && size > 0, "invalid tiling to capture", return nullptr);
+    void *deviceTiling = nullptr;
+    int st = GetDeviceCachingAllocator()->Allocate(&deviceTiling, size, stream);
+    MKI_CHECK(st == MKIRT_SUCCESS, "launch graph alloc tiling fail, ret " << st, return nullptr);
+    tilingBuffers_.push_back({static_cast<uint8_t *>(deviceTiling), size});
+    // uploaded once in capture, kept for every replay
+    st = MkiRtMemCopy(deviceTiling, size, hostTiling, size, MKIRT_MEMCOPY_HOST_TO_DEVICE);
+    MKI_CHECK(st == MKIRT_SUCCESS, "launch graph copy tiling fail, ret " << st, return nullptr);
+    return static_cast<uint8_t *>(deviceTiling);
+}
+
+void LaunchGraph::AddNode(const BinHandle *handle, const std::string &name, const MkiRtKernelParam &kernelParam,
+                          const KernelInfo::FrozenArgsInfo &argsInfo,
+                          const MiniVector<KernelInfo::MemsetInfo> &memsetInfo, const LaunchParam &launchParam,
+                          const RunInfo &runInfo)
+{
+    Node node;
+    node.handle = handle;
+    node.name = name;
+    node.stream = runInfo.GetStream();
+    node.tilingId = kernelParam.tilingId;
+    node.blockDim = kernelParam.blockDim;
+    node.argsNum = argsInfo.argsNum;
+    node.argsEx = argsInfo.argsEx;
+    const uint8_t *args = static_cast<const uint8_t *>(argsInfo.argsEx.args);
+    node.args.assign(args, args + argsInfo.argsEx.argsSize);
+    node.hostInputInfos = argsInfo.hostInputInfos;
+    node.memsetInfo = memsetInfo;
+    if (memsetInfo.size() != 0 && !hostMemset_ && !HasMemsetKernel()) {
+        MKI_LOG(INFO) << name << " clears tensors by aclrtMemset, launch graph replays node by node";
+        hostMemset_ = true;
+    }
+    for (const auto &patchInfo : argsInfo.patchInfos) {
+        AddrSlot slot;
+        slot.argOffset = patchInfo.argOffset;
+        slot.addrOffset = patchInfo.addrOffset;
+        switch (patchInfo.type) {
+            case KernelInfo::ArgsPatchType::INPUT:
+                slot.base = static_cast<uint8_t *>(launchParam.GetInTensor(patchInfo.tensorIdx).data); break;
+            case KernelInfo::ArgsPatchType::OUTPUT:
+                slot.base = static_cast<uint8_t *>(launchParam.GetOutTensor(patchInfo.tensorIdx).data); break;
+            case KernelInfo::ArgsPatchType::WORKSPACE: slot.base = runInfo.GetScratchDeviceAddr(); break;
+            case KernelInfo::ArgsPatchType::TILING: slot.base = runInfo.GetTilingDeviceAddr(); break;
+            default: break;
+        }
+        node.addrSlots.push_back(slot);
+    }
+    if (node.argsEx.hasTiling) {
+        node.tilingSize = node.args.size() - node.argsEx.tilingDataOffset;
+    } else if (!tilingBuffers_.empty() && runInfo.GetTilingDeviceAddr() == tilingBuffers_.back().first) {
+        // AddTiling is called right before AddNode of the same kernel
+        node.tilingDeviceAddr = tilingBuffers_.back().first;
+        node.tilingSize = tilingBuffers_.back().second;
+    }
+    MKI_LOG(DEBUG) << "launch graph node " << nodes_.size() << ": " << name << ", addr slot num "
+                   << node.addrSlots.size();
+    nodes_.push_back(std::move(node));
+}
+
+size_t LaunchGraph::UpdateAddress(const void *oldAddr, void *newAddr)
+{
+    size_t count = 0;
+    for (auto &node : nodes_) {
+        for (auto &slot : node.addrSlots) {
+            if (slot.base != oldAddr) {
+                continue;
+            }
+            slot.base = static_cast<uint8_t *>(newAddr);
+            uint8_t *addr = slot.base + slot.addrOffset;
+            (void)memcpy_s(node.args.data() + slot.argOffset, node.args.size() - slot.argOffset, &addr,
+                           sizeof(void *));
+            count++;
+        }
+    }
+    nativeModelDirty_ = nativeModelDirty_ || count > 0;
+    return count;
+}
+
+Status LaunchGraph::UpdateTiling(size_t nodeIdx, uint64_t offset, const void *data, uint64_t size)
+{
+    MKI_CHECK(nodeIdx < nodes_.size(), "node index " << nodeIdx << " out of range",
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    Node &node = nodes_[nodeIdx];
+    if (node.argsEx.hasTiling) {
+        MKI_CHECK(offset <= node.tilingSize && size <= node.tilingSize - offset, "tiling update out of range",
+                  return Status::FailStatus(ERROR_INVALID_VALUE));
+        auto ret = memcpy_s(node.args.data() + node.argsEx.tilingDataOffset + offset, size, data, size);
+        MKI_CHECK(ret == EOK, "copy tiling update fail", return Status::FailStatus(ERROR_INVALID_VALUE));
+        nativeModelDirty_ = true;
+        return Status::OkStatus();
+    }
+    MKI_CHECK(node.tilingDeviceAddr != nullptr, node.name << " tiling device memory is owned by the caller",
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    MKI_CHECK(offset <= node.tilingSize && size <= node.tilingSize - offset, "tiling update out of range",
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    // device tiling is read when the node runs, so a native model stays valid
+    int st = MkiRtMemCopy(node.tilingDeviceAddr + offset, size, data, size, MKIRT_MEMCOPY_HOST_TO_DEVICE);
+    MKI_CHECK(st == MKIRT_SUCCESS, "copy tiling update fail, ret " << st,
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    return Status::OkStatus();
+}
+
+Status LaunchGraph::LaunchNode(Node &node, MkiRtStream stream) const
+{
+    node.argsEx.args = node.args.data();
+    node.argsEx.hostInputInfoPtr = node.hostInputInfos.empty() ? nullptr : node.hostInputInfos.data();
+    if (node.memsetInfo.size() != 0) {
+        Status status = ClearTensors(reinterpret_cast<void **>(static_cast<void *>(node.args.data())),
+                                     node.argsNum, node.memsetInfo, stream);
+        MKI_CHECK(status.Ok(), "failed to clear tensors of " << node.name, return status);
+    }
+    MkiRtKernelParam kernelParam;
+    kernelParam.tilingId = node.tilingId;
+    kernelParam.blockDim = node.blockDim;
+    kernelParam.argsEx = &node.argsEx;
+    KernelHandle handle = node.handle->GetHandle();
+    int st = *handle != nullptr ? MkiRtFunctionLaunchWithHandle(*handle, &kernelParam, stream, nullptr)
+                                : MkiRtFunctionLaunchWithFlag(handle, &kernelParam, stream, nullptr);
+    MKI_CHECK(st == MKIRT_SUCCESS, "launch graph node " << node.name << " fail, ret " << st,
+              return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "launch graph node fail"));
+    return Status::OkStatus();
+}
+
+Status LaunchGraph::LaunchNodes(MkiRtStream stream)
+{
+    for (auto &node : nodes_) {
+        Status status = LaunchNode(node, stream != nullptr ? stream : node.stream);
+        if (!status.Ok()) {
+            return status;
+        }
+    }
+    return Status::OkStatus();
+}
+
+Status LaunchGraph::BuildNativeModel(MkiRtStream stream)
+{
+    DestroyNativeModel();
+    int st = MkiRtStreamBeginCapture(stream);
+    if (st != MKIRT_SUCCESS) {
+        MKI_LOG(WARN) << "stream capture is not available, ret " << st << ", launch graph replays node by node";
+        nativeUnsupported_ = true;
+        return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "stream capture not available");
+    }
+    Status status = LaunchNodes(stream);
+    MkiRtModel model = nullptr;
+    st = MkiRtStreamEndCapture(stream, &model);
+    if (!status.Ok() || st != MKIRT_SUCCESS) {
+        if (model != nullptr) {
+            (void)MkiRtModelDestroy(model);
+        }
+        MKI_LOG(ERROR) << "launch graph capture model fail, ret " << st;
+        return status.Ok() ? Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "capture model fail") : status;
+    }
+    nativeModel_ = model;
+    nativeModelDirty_ = false;
+    return Status::OkStatus();
+}
+
+void LaunchGraph::DestroyNativeModel()
+{
+    if (nativeModel_ != nullptr) {
+        WaitReplays();
+        (void)MkiRtModelDestroy(nativeModel_);
+        nativeModel_ = nullptr;
+    }
+}
+
+void LaunchGraph::RecordReplay(MkiRtStream stream)
+{
+    std::vector<MkiRtStream> replayStreams;
+    for (const auto &node : nodes_) {
+        MkiRtStream replayStream = stream != nullptr ? stream : node.stream;
+        if (std::find(replayStreams.begin(), replayStreams.end(), replayStream) == replayStreams.end()) {
+            replayStreams.push_back(replayStream);
+        }
+    }
+    for (MkiRtStream replayStream : replayStreams) {
+        auto it = std::find_if(replayEvents_.begin(), replayEvents_.end(),
+            [replayStream](const std::pair<MkiRtStream, MkiRtEvent> &replayEvent) {
+                return replayEvent.first == replayStream;
+            });
+        int st = MKIRT_SUCCESS;
+        if (it == replayEvents_.end()) {
+            MkiRtEvent event = nullptr;
+            st = MkiRtEventCreate(&event);
+            it = st == MKIRT_SUCCESS ? replayEvents_.insert(replayEvents_.end(), {replayStream, event}) : it;
+        }
+        st = st == MKIRT_SUCCESS ? MkiRtEventRecord(it->second, replayStream) : st;
+        if (st != MKIRT_SUCCESS) {
+            MKI_LOG(WARN) << "launch graph record replay event fail, ret " << st << ", synchronize instead";
+            (void)MkiRtStreamSynchronize(replayStream);
+        }
+    }
+}
+
+void LaunchGraph::WaitReplays()
+{
+    for (const auto &replayEvent : replayEvents_) {
+        int st = MkiRtEventSynchronize(replayEvent.second);
+        MKI_LOG_IF(st != MKIRT_SUCCESS, ERROR) << "launch graph wait replay fail, ret " << st;
+    }
+}
+
+Status LaunchGraph::Replay(MkiRtStream stream)
+{
+    MKI_CHECK(!capturing_, "launch graph is capturing", return Status::FailStatus(ERROR_INVALID_VALUE));
+    if (nodes_.empty()) {
+        return Status::OkStatus();
+    }
+    MkiRtStream replayStream = stream != nullptr ? stream : nodes_[0].stream;
+    bool singleStream = stream != nullptr || std::all_of(nodes_.begin(), nodes_.end(),
+        [replayStream](const Node &node) { return node.stream == replayStream; });
+    if (nativeCapture_ && !nativeUnsupported_ && !hostMemset_ && singleStream) {
+        if (nativeModel_ == nullptr || nativeModelDirty_) {
+            (void)BuildNativeModel(replayStream);
+        }
+        if (nativeModel_ != nullptr) {
+            int st = MkiRtModelExecute(nativeModel_, replayStream);
+            MKI_CHECK(st == MKIRT_SUCCESS, "launch graph execute model fail, ret " << st,
+                      return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "execute model fail"));
+            RecordReplay(replayStream);
+            return Status::OkStatus();
+        }
+    }
+    // nodes launched before a failure still run, so the replay is recorded either way
+    Status status = LaunchNodes(stream);
+    RecordReplay(stream);
+    return status;
+}
+
+void LaunchGraph::SetNativeCapture(bool flag)
+{
+    nativeCapture_ = flag;
+    if (!flag) {
+        DestroyNativeModel();
+    }
+}
+
+bool LaunchGraph::IsNativeModelReady() const { return nativeModel_ != nullptr && !nativeModelDirty_; }
+} // namespace Mki
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/stream_scheduler.h"
+#include <algorithm>
+#include "mki/run_info.h"
+#include "mki/types.h"
+#include "mki/utils/assert/assert.h"
+#include "mki/utils/log/log.h"
+#include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/memory/caching_allocator.h"
+
+namespace Mki {
+static const std::vector<size_t> EMPTY_DEPS;
+
+static uint64_t GetTensorBytes(const Tensor &tensor)
+{
+    uint64_t size = tensor.dataSize > 0 ? tensor.dataSize :
+        static_cast<uint64_t>(std::max<int64_t>(tensor.Numel(), 0)) * GetTensorElementSize(tensor.desc.dtype);
+    return std::max<uint64_t>(size, 1); // 1: a tensor without size still covers its first byte
+}
+
+static bool TensorsOverlap(const SVector<Tensor> &lhs, const SVector<Tensor> &rhs)
+{
+    for (const auto &lhsTensor : lhs) {
+        if (lhsTensor.data == nullptr) {
+            continue;
+        }
+        uintptr_t lhsBegin = reinterpret_cast<uintptr_t>(lhsTensor.data);
+        uintptr_t lhsEnd = lhsBegin + GetTensorBytes(lhsTensor);
+        for (const auto &rhsTensor : rhs) {
+            if (rhsTensor.data == nullptr) {
+                continue;
+            }
+            uintptr_t rhsBegin = reinterpret_cast<uintptr_t>(rhsTensor.data);
+            uintptr_t rhsEnd = rhsBegin + GetTensorBytes(rhsTensor);
+            if (lhsBegin < rhsEnd && rhsBegin < lhsEnd) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void SyncAndDestroyEvent(MkiRtEvent &event)
+{
+    if (event == nullptr) {
+        return;
+    }
+    // the last Run may still have the event recorded or waited on its streams
+    int st = MkiRtEventSynchronize(event);
+    MKI_LOG_IF(st != MKIRT_SUCCESS, ERROR) << "synchronize scheduler event fail, ret " << st;
+    (void)MkiRtEventDestroy(event);
+    event = nullptr;
+}
+
+double StreamSchedulerStats::Parallelism() const
+{
+    return criticalPathLength == 0 ? 0.0 : static_cast<double>(nodeCount) / criticalPathLength;
+}
+
+StreamScheduler::StreamScheduler(uint32_t streamNum) : streamNum_(std::max<uint32_t>(streamNum, 1))
+{
+    streams_.assign(streamNum_, nullptr);
+}
+
+StreamScheduler::~StreamScheduler()
+{
+    DestroyEvents();
+    for (size_t i = 1; i < streams_.size(); i++) {
+        if (streams_[i] == nullptr) {
+            continue;
+        }
+        int st = MkiRtStreamSynchronize(streams_[i]);
+        MKI_LOG_IF(st != MKIRT_SUCCESS, ERROR) << "synchronize scheduler stream fail, ret " << st;
+        st = MkiRtStreamDestroy(streams_[i]);
+        MKI_LOG_IF(st != MKIRT_SUCCESS, ERROR) << "destroy scheduler stream fail, ret " << st;
+    }
+}
+
+Status StreamScheduler::AddNode(const Operation &op, const LaunchParam &launchParam, size_t *nodeIdx)
+{
+    std::unique_ptr<Kernel> kernel(op.GetBestKernel(launchParam));
+    MKI_CHECK(kernel != nullptr, op.GetName() << " get best kernel fail",
+              return Status::FailStatus(ERROR_KERNEL_NOT_EXIST, "get best kernel fail"));
+    Status status = kernel->Init(launchParam);
+    MKI_CHECK(status.Ok(), kernel->GetName() << " init fail " << status.ToString(), return status);
+
+    Node node;
+    node.name = kernel->GetName();
+    node.launchParam = launchParam;
+    node.kernel = std::move(kernel);
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        if (DependsOn(node, nodes_[i])) {
+            node.deps.push_back(i);
+        }
+    }
+    MKI_LOG(DEBUG) << "stream scheduler node " << nodes_.size() << " " << node.name << ", " << node.deps.size()
+                   << " dependencies";
+    if (nodeIdx != nullptr) {
+        *nodeIdx = nodes_.size();
+    }
+    nodes_.push_back(std::move(node));
+    Plan();
+    return Status::OkStatus();
+}
+
+Status StreamScheduler::AddDependency(size_t from, size_t to)
+{
+    MKI_CHECK(from < to && to < nodes_.size(), "invalid dependency from " << from << " to " << to,
+              return Status::FailStatus(ERROR_INVALID_VALUE));
+    std::vector<size_t> &deps = nodes_[to].deps;
+    auto it = std::lower_bound(deps.begin(), deps.end(), from);
+    if (it == deps.end() || *it != from) {
+        deps.insert(it, from);
+        Plan();
+    }
+    return Status::OkStatus();
+}
+
+void StreamScheduler::Clear()
+{
+    DestroyEvents();
+    nodes_.clear();
+    Plan();
+}
+
+size_t StreamScheduler::GetNodeCount() const { return nodes_.size(); }
+
+const std::vector<size_t> &StreamScheduler::GetNodeDependencies(size_t nodeIdx) const
+{
+    MKI_CHECK(nodeIdx < nodes_.size(), "node index " << nodeIdx << " out of range", return EMPTY_DEPS);
+    return nodes_[nodeIdx].deps;
+}
+
+uint32_t StreamScheduler::GetNodeStream(size_t nodeIdx) const
+{
+    MKI_CHECK(nodeIdx < nodes_.size(), "node index " << nodeIdx << " out of range", return 0);
+    return nodes_[nodeIdx].stream;
+}
+
+StreamSchedulerStats StreamScheduler::GetStats() const { return stats_; }
+
+bool StreamScheduler::DependsOn(const Node &node, const Node &other) const
+{
+    // read after write, write after write and write after read
+    const LaunchParam &param = node.launchParam;
+    const LaunchParam &otherParam = other.launchParam;
+    return TensorsOverlap(param.GetInTensors(), otherParam.GetOutTensors()) ||
+           TensorsOverlap(param.GetOutTensors(), otherParam.GetOutTensors()) ||
+           TensorsOverlap(param.GetOutTensors(), otherParam.GetInTensors());
+}
+
+void StreamScheduler::Plan()
+{
+    // nodes are in program order, so a node is planned after all of its dependencies
+    std::vector<uint32_t> streamCounts(streamNum_, 0);
+    std::vector<size_t> streamTails(streamNum_, 0);
+    // streamClocks[s][t]: nodes of stream t that stream s has waited for so far, nodeClocks likewise at a node
+    std::vector<std::vector<uint32_t>> streamClocks(streamNum_, std::vector<uint32_t>(streamNum_, 0));
+    std::vector<std::vector<uint32_t>> nodeClocks(nodes_.size());
+    stats_.criticalPathLength = 0;
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        Node &node = nodes_[i];
+        node.depth = 1;
+        node.waits.clear();
+        node.waitFork = false;
+        node.recordEvent = false;
+        // continue the longest chain that ends at the tail of a stream, otherwise take the least loaded stream
+        size_t chainDep = nodes_.size();
+        for (size_t dep : node.deps) {
+            const Node &depNode = nodes_[dep];
+            node.depth = std::max(node.depth, depNode.depth + 1);
+            if (streamCounts[depNode.stream] > 0 && streamTails[depNode.stream] == dep &&
+                (chainDep == nodes_.size() || depNode.depth > nodes_[chainDep].depth)) {
+                chainDep = dep;
+            }
+        }
+        uint32_t stream = 0;
+        if (chainDep != nodes_.size()) {
+            stream = nodes_[chainDep].stream;
+        } else {
+            for (uint32_t s = 1; s < streamNum_; s++) {
+                stream = streamCounts[s] < streamCounts[stream] ? s : stream;
+            }
+        }
+        node.stream = stream;
+        node.waitFork = stream != 0 && streamCounts[stream] == 0;
+
+        // the latest dependencies first, waiting for a node covers all that node has waited for
+        std::vector<uint32_t> &clock = streamClocks[stream];
+        for (auto it = node.deps.rbegin(); it != node.deps.rend(); ++it) {
+            Node &depNode = nodes_[*it];
+            if (depNode.stream == stream || clock[depNode.stream] >= nodeClocks[*it][depNode.stream]) {
+                continue;
+            }
+            node.waits.push_back(*it);
+            depNode.recordEvent = true;
+            for (uint32_t s = 0; s < streamNum_; s++) {
+                clock[s] = std::max(clock[s], nodeClocks[*it][s]);
+            }
+        }
+        clock[stream] = ++streamCounts[stream];
+        nodeClocks[i] = clock;
+        streamTails[stream] = i;
+        stats_.criticalPathLength = std::max(stats_.criticalPathLength, node.depth);
+    }
+
+    // the stream given to Run joins every pool stream it has not waited for
+    joinWaits_.clear();
+    std::vector<uint32_t> &mainClock = streamClocks[0];
+    for (uint32_t s = 1; s < streamNum_; s++) {
+        if (streamCounts[s] == 0 || mainClock[s] >= streamCounts[s]) {
+            continue;
+        }
+        size_t tail = streamTails[s];
+        joinWaits_.push_back(tail);
+        nodes_[tail].recordEvent = true;
+        for (uint32_t t = 0; t < streamNum_; t++) {
+            mainClock[t] = std::max(mainClock[t], nodeClocks[tail][t]);
+        }
+    }
+    stats_.nodeCount = static_cast<uint32_t>(nodes_.size());
+    stats_.streamsUsed = static_cast<uint32_t>(
+        std::count_if(streamCounts.begin(), streamCounts.end(), [](uint32_t count) { return count > 0; }));
+    MKI_LOG(DEBUG) << "stream scheduler planned " << stats_.nodeCount << " nodes on " << stats_.streamsUsed
+                  << " streams, critical path " << stats_.criticalPathLength;
+}
+
+Status StreamScheduler::PrepareStreams()
+{
+    // the least loaded stream with the lowest index is taken first, so the used streams are a prefix
+    for (uint32_t s = 1; s < stats_.streamsUsed; s++) {
+        if (streams_[s] != nullptr) {
+            continue;
+        }
+        int st = MkiRtStreamCreate(&streams_[s], 0);
+        MKI_CHECK(st == MKIRT_SUCCESS, "create scheduler stream fail, ret " << st,
+                  return Status::FailStatus(ERROR_SYNC_STREAM_ERROR, "create stream fail"));
+    }
+    return Status::OkStatus();
+}
+
+Status StreamScheduler::PrepareEvents()
+{
+    if (forkEvent_ == nullptr && stats_.streamsUsed > 1) {
+        int st = MkiRtEventCreate(&forkEvent_);
+        MKI_CHECK(st == MKIRT_SUCCESS, "create scheduler event fail, ret " << st,
+                  return Status::FailStatus(ERROR_SYNC_STREAM_ERROR, "create event fail"));
+    }
+    for (auto &node : nodes_) {
+        if (!node.recordEvent || node.event != nullptr) {
+            continue;
+        }
+        int st = MkiRtEventCreate(&node.event);
+        MKI_CHECK(st == MKIRT_SUCCESS, "create scheduler event fail, ret " << st,
+                  return Status::FailStatus(ERROR_SYNC_STREAM_ERROR, "create event fail"));
+    }
+    return Status::OkStatus();
+}
+
+void StreamScheduler::DestroyEvents()
+{
+    for (auto &node : nodes_) {
+        SyncAndDestroyEvent(node.event);
+    }
+    SyncAndDestroyEvent(forkEvent_);
+    for (auto &event : failJoinEvents_) {
+        SyncAndDestroyEvent(event);
+    }
+}
+
+Status StreamScheduler::WaitEvent(MkiRtStream stream, MkiRtEvent event)
+{
+    int st = MkiRtStreamWaitEvent(stream, event);
+    MKI_CHECK(st == MKIRT_SUCCESS, "stream wait event fail, ret " << st,
+              return Status::FailStatus(ERROR_SYNC_STREAM_ERROR, "stream wait event fail"));
+    stats_.eventWaitCount++;
+    return Status::OkStatus();
+}
+
+Status StreamScheduler::LaunchNode(Node &node, MkiRtStream stream) const
+{
+    RunInfo runInfo;
+    runInfo.SetStream(stream);
+    uint64_t scratchSize = node.kernel->GetKernelInfo().GetTotalScratchSize();
+    void *scratch = nullptr;
+    if (scratchSize > 0) {
+        // freed after the launch, the block is only reused by later work of the same stream
+        int st = GetDeviceCachingAllocator()->Allocate(&scratch, scratchSize, stream);
+        MKI_CHECK(st == MKIRT_SUCCESS, node.name << " allocate workspace fail, ret " << st,
+                  return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "allocate workspace fail"));
+        runInfo.SetScratchDeviceAddr(static_cast<uint8_t *>(scratch));
+    }
+    Status status = node.kernel->Run(node.launchParam, runInfo);
+    if (scratch != nullptr) {
+        (void)GetDeviceCachingAllocator()->Free(scratch);
+    }
+    MKI_CHECK(status.Ok(), node.name << " run fail " << status.ToString(), return status);
+    return status;
+}
+
+void StreamScheduler::JoinAfterFailure(MkiRtStream stream, const std::vector<bool> &streamsTouched)
+{
+    // work already queued on pool streams must not outlive a failed Run unjoined, the planned tail events
+    // may not have been recorded, so every touched pool stream records its own event
+    failJoinEvents_.resize(streamNum_, nullptr);
+    for (uint32_t s = 1; s < streamNum_; s++) {
+        if (!streamsTouched[s]) {
+            continue;
+        }
+        int st = failJoinEvents_[s] != nullptr ? MKIRT_SUCCESS : MkiRtEventCreate(&failJoinEvents_[s]);
+        st = st == MKIRT_SUCCESS ? MkiRtEventRecord(failJoinEvents_[s], streams_[s]) : st;
+        if (st != MKIRT_SUCCESS || !WaitEvent(stream, failJoinEvents_[s]).Ok()) {
+            MKI_LOG(ERROR) << "join scheduler stream " << s << " fail, ret " << st << ", synchronize it instead";
+            (void)MkiRtStreamSynchronize(streams_[s]);
+        }
+    }
+}
+
+Status StreamScheduler::LaunchNodes(std::vector<bool> &streamsTouched)
+{
+    for (auto &node : nodes_) {
+        MkiRtStream nodeStream = streams_[node.stream];
+        streamsTouched[node.stream] = true;
+        Status status;
+        if (node.waitFork) {
+            status = WaitEvent(nodeStream, forkEvent_);
+            MKI_CHECK(status.Ok(), node.name << " wait fork fail", return status);
+        }
+        for (size_t wait : node.waits) {
+            status = WaitEvent(nodeStream, nodes_[wait].event);
+            MKI_CHECK(status.Ok(), node.name << " wait dependency fail", return status);
+        }
+        status = LaunchNode(node, nodeStream);
+        MKI_CHECK_NO_LOG(status.Ok(), return status);
+        if (node.recordEvent) {
+            int st = MkiRtEventRecord(node.event, nodeStream);
+            MKI_CHECK(st == MKIRT_SUCCESS, node.name << " record event fail, ret " << st,
+                      return Status::FailStatus(ERROR_SYNC_STREAM_ERROR, "record event fail"));
+        }
+        stats_.launchCount++;
+        stats_.sideLaunchCount += node.stream != 0 ? 1 : 0;
+    }
+    return Status::OkStatus();
+}
+
+Status StreamScheduler::Run(MkiRtStream stream)
+{
+    MKI_CHECK(!nodes_.empty(), "stream scheduler has no node", return Status::FailStatus(ERROR_INVALID_VALUE));
+    Status status = PrepareStreams();
+    MKI_CHECK(status.Ok(), "failed to prepare scheduler streams", return status);
+    status = PrepareEvents();
+    MKI_CHECK(status.Ok(), "failed to prepare scheduler events", return status);
+    streams_[0] = stream;
+    if (stats_.streamsUsed > 1) {
+        // pool streams start after the work queued on stream before Run
+        int st = MkiRtEventRecord(forkEvent_, stream);
+        MKI_CHECK(st == MKIRT_SUCCESS, "record fork event fail, ret " << st,
+                  return Status::FailStatus(ERROR_SYNC_STREAM_ERROR, "record event fail"));
+    }
+    std::vector<bool> streamsTouched(streamNum_, false);
+    status = LaunchNodes(streamsTouched);
+    if (!status.Ok()) {
+        JoinAfterFailure(stream, streamsTouched);
+        return status;
+    }
+    for (size_t tail : joinWaits_) {
+        status = WaitEvent(stream, nodes_[tail].event);
+        if (!status.Ok()) {
+            MKI_LOG(ERROR) << "join scheduler stream fail";
+            JoinAfterFailure(stream, streamsTouched);
+            return status;
+        }
+    }
+    stats_.runCount++;
+    return Status::OkStatus();
+}
+} // namespace Mki
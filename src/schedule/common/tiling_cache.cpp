@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/tiling_cache.h"
+#include "mki/utils/assert/assert.h"
+#include "mki/utils/log/log.h"
+
+namespace Mki {
+constexpr size_t MAX_TILING_CACHE_CAPACITY = 4096;
+constexpr size_t MAX_HOST_DATA_KEY_SIZE = 4096; // host data larger than this is not used as key
+
+TilingCacheKey::TilingCacheKey(size_t typeHashCode, TilingCacheKeyFunc func)
+{
+    std::map<size_t, TilingCacheKeyFunc> &funcMap = GetFuncMap();
+    if (funcMap.find(typeHashCode) == funcMap.end()) {
+        funcMap[typeHashCode] = func;
+    } else {
+        MKI_LOG(WARN) << typeHashCode << " tiling cache key has been registered";
+    }
+}
+
+bool TilingCacheKey::Append(const Any &param, std::string &key)
+{
+    const std::map<size_t, TilingCacheKeyFunc> &funcMap = GetFuncMap();
+    auto it = funcMap.find(param.Type().hash_code());
+    if (it == funcMap.end()) {
+        return false;
+    }
+    AppendTilingCacheKey(key, param.Type().hash_code());
+    it->second(param, key);
+    return true;
+}
+
+std::map<size_t, TilingCacheKeyFunc> &TilingCacheKey::GetFuncMap()
+{
+    // registered from static objects of other translation units
+    static std::map<size_t, TilingCacheKeyFunc> funcMap;
+    return funcMap;
+}
+
+static bool AppendTensorKey(std::string &key, const Tensor &tensor)
+{
+    AppendTilingCacheKey(key, tensor.desc.dtype);
+    AppendTilingCacheKey(key, tensor.desc.format);
+    AppendTilingCacheKey(key, tensor.desc.dims.size());
+    for (size_t i = 0; i < tensor.desc.dims.size(); ++i) {
+        AppendTilingCacheKey(key, tensor.desc.dims[i]);
+    }
+    // tiling may read host data, so its content is part of the key
+    if (tensor.hostData != nullptr) {
+        int64_t numel = tensor.desc.Numel();
+        MKI_CHECK(numel >= 0, "invalid host tensor numel " << numel, return false);
+        uint64_t hostDataSize = static_cast<uint64_t>(numel) * GetTensorElementSize(tensor.desc.dtype);
+        MKI_CHECK(hostDataSize <= MAX_HOST_DATA_KEY_SIZE, "host data too large for tiling cache key", return false);
+        AppendTilingCacheKey(key, hostDataSize);
+        key.append(static_cast<const char *>(tensor.hostData), hostDataSize);
+    }
+    return true;
+}
+
+void TilingCache::SetCapacity(size_t capacity)
+{
+    MKI_CHECK(capacity <= MAX_TILING_CACHE_CAPACITY, "tiling cache capacity " << capacity << " is too large",
+              return);
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    stats_.capacity = capacity;
+    EvictLocked(capacity);
+}
+
+size_t TilingCache::GetCapacity() const { return capacity_; }
+
+bool TilingCache::GenerateKey(const LaunchParam &launchParam, std::string &key)
+{
+    bool cacheable = launchParam.GetInputLenCount() == 0 && launchParam.GetOutputLenCount() == 0;
+    const Any &param = launchParam.GetParam();
+
+    key.clear();
+    cacheable = cacheable && (!param.HasValue() || TilingCacheKey::Append(param, key));
+    key.push_back('|');
+    for (size_t i = 0; cacheable && i < launchParam.GetInTensorCount(); ++i) {
+        cacheable = AppendTensorKey(key, launchParam.GetInTensor(i));
+    }
+    key.push_back('|');
+    for (size_t i = 0; cacheable && i < launchParam.GetOutTensorCount(); ++i) {
+        cacheable = AppendTensorKey(key, launchParam.GetOutTensor(i));
+    }
+    if (!cacheable) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.bypassCount++;
+        return false;
+    }
+    return true;
+}
+
+bool TilingCache::Get(const std::string &key, KernelInfo &kernelInfo)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entryMap_.find(key);
+    if (it == entryMap_.end()) {
+        stats_.missCount++;
+        return false;
+    }
+    lruList_.splice(lruList_.begin(), lruList_, it->second);
+    bool argsFrozen = kernelInfo.GetArgsFrozen();
+    kernelInfo.Reset();
+    kernelInfo.Copy(*it->second->second);
+    kernelInfo.SetArgsFrozen(argsFrozen);
+    stats_.hitCount++;
+    return true;
+}
+
+void TilingCache::Put(const std::string &key, const KernelInfo &kernelInfo)
+{
+    std::unique_ptr<KernelInfo> entryInfo = std::make_unique<KernelInfo>();
+    entryInfo->Copy(kernelInfo);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+    auto it = entryMap_.find(key);
+    if (it != entryMap_.end()) {
+        it->second->second = std::move(entryInfo);
+        lruList_.splice(lruList_.begin(), lruList_, it->second);
+        return;
+    }
+    EvictLocked(capacity_ - 1);
+    lruList_.emplace_front(key, std::move(entryInfo));
+    entryMap_[key] = lruList_.begin();
+    stats_.size = lruList_.size();
+    MKI_LOG(DEBUG) << "tiling cache add entry, size " << stats_.size;
+}
+
+void TilingCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entryMap_.clear();
+    lruList_.clear();
+    stats_.size = 0;
+}
+
+TilingCacheStats TilingCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void TilingCache::ResetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.hitCount = 0;
+    stats_.missCount = 0;
+    stats_.bypassCount = 0;
+    stats_.evictCount = 0;
+}
+
+void TilingCache::EvictLocked(size_t capacity)
+{
+    while (lruList_.size() > capacity) {
+        entryMap_.erase(lruList_.back().first);
+        lruList_.pop_back();
+        stats_.evictCount++;
+    }
+    stats_.size = lruList_.size();
+}
+} // namespace Mki
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/allocator/host_allocator.h"
+#include <atomic>
+#include <new>
+#include "mki/utils/assert/assert.h"
+#include "mki/utils/log/log.h"
+
+namespace Mki {
+constexpr size_t THREAD_CACHE_LIMIT = 16;   // blocks kept by one thread for one size class
+constexpr size_t CENTRAL_CACHE_LIMIT = 256; // blocks kept by the central lists for one size class
+constexpr size_t FETCH_BATCH_NUM = 4;
+
+static uint64_t GetClassSize(size_t classIdx) { return SlabHostAllocator::MIN_CLASS_SIZE << classIdx; }
+
+// set when the thread cache is destructed, buffers freed later on this thread go to the central lists
+static thread_local bool g_threadCacheDestructed = false;
+
+struct SlabHostAllocator::ThreadCache {
+    SlabHostAllocator *owner = nullptr;
+    std::vector<uint8_t *> freeLists[CLASS_NUM];
+
+    ~ThreadCache()
+    {
+        g_threadCacheDestructed = true;
+        if (owner == nullptr) {
+            return;
+        }
+        for (size_t i = 0; i < CLASS_NUM; ++i) {
+            owner->ReturnToCentral(i, freeLists[i], 0);
+        }
+    }
+};
+
+SlabHostAllocator::SlabHostAllocator(bool useThreadCache) : useThreadCache_(useThreadCache) {}
+
+SlabHostAllocator::~SlabHostAllocator()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &freeList : centralFreeLists_) {
+        for (uint8_t *addr : freeList) {
+            delete[] addr;
+        }
+        freeList.clear();
+    }
+}
+
+size_t SlabHostAllocator::GetClassIdx(uint64_t size)
+{
+    size_t classIdx = 0;
+    while (GetClassSize(classIdx) < size) {
+        ++classIdx;
+    }
+    return classIdx;
+}
+
+SlabHostAllocator::ThreadCache *SlabHostAllocator::GetThreadCache()
+{
+    if (!useThreadCache_ || g_threadCacheDestructed) {
+        return nullptr;
+    }
+    thread_local ThreadCache threadCache;
+    if (threadCache.owner == nullptr) {
+        threadCache.owner = this;
+    }
+    // only the first thread cached allocator used by a thread owns its cache
+    return threadCache.owner == this ? &threadCache : nullptr;
+}
+
+void SlabHostAllocator::FetchFromCentral(size_t classIdx, std::vector<uint8_t *> &freeList, size_t fetchNum)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &centralFreeList = centralFreeLists_[classIdx];
+    for (size_t i = 0; i < fetchNum && !centralFreeList.empty(); ++i) {
+        freeList.push_back(centralFreeList.back());
+        centralFreeList.pop_back();
+    }
+}
+
+void SlabHostAllocator::ReturnToCentral(size_t classIdx, std::vector<uint8_t *> &freeList, size_t keepNum)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &centralFreeList = centralFreeLists_[classIdx];
+    while (freeList.size() > keepNum) {
+        if (centralFreeList.size() < CENTRAL_CACHE_LIMIT) {
+            centralFreeList.push_back(freeList.back());
+        } else {
+            delete[] freeList.back();
+        }
+        freeList.pop_back();
+    }
+}
+
+uint8_t *SlabHostAllocator::Allocate(uint64_t size)
+{
+    if (size > MAX_CLASS_SIZE) {
+        return new (std::nothrow) uint8_t[size];
+    }
+    size_t classIdx = GetClassIdx(size);
+    ThreadCache *threadCache = GetThreadCache();
+    if (threadCache != nullptr) {
+        auto &freeList = threadCache->freeLists[classIdx];
+        if (freeList.empty()) {
+            FetchFromCentral(classIdx, freeList, FETCH_BATCH_NUM);
+        }
+        if (!freeList.empty()) {
+            uint8_t *addr = freeList.back();
+            freeList.pop_back();
+            return addr;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &centralFreeList = centralFreeLists_[classIdx];
+        if (!centralFreeList.empty()) {
+            uint8_t *addr = centralFreeList.back();
+            centralFreeList.pop_back();
+            return addr;
+        }
+    }
+    return new (std::nothrow) uint8_t[GetClassSize(classIdx)];
+}
+
+void SlabHostAllocator::Deallocate(uint8_t *addr, uint64_t size)
+{
+    if (addr == nullptr) {
+        return;
+    }
+    if (size > MAX_CLASS_SIZE) {
+        delete[] addr;
+        return;
+    }
+    size_t classIdx = GetClassIdx(size);
+    ThreadCache *threadCache = GetThreadCache();
+    if (threadCache == nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &centralFreeList = centralFreeLists_[classIdx];
+        if (centralFreeList.size() < CENTRAL_CACHE_LIMIT) {
+            centralFreeList.push_back(addr);
+        } else {
+            delete[] addr;
+        }
+        return;
+    }
+    auto &freeList = threadCache->freeLists[classIdx];
+    freeList.push_back(addr);
+    if (freeList.size() > THREAD_CACHE_LIMIT) {
+        ReturnToCentral(classIdx, freeList, THREAD_CACHE_LIMIT / 2); // 2: keep half of the thread cache
+    }
+}
+
+static std::atomic<HostAllocator *> &GetDefaultHostAllocatorRef()
+{
+    // never destructed, KernelInfo in static kernels release buffers during exit
+    static std::atomic<HostAllocator *> *defaultAllocator =
+        new std::atomic<HostAllocator *>(new SlabHostAllocator(true));
+    return *defaultAllocator;
+}
+
+HostAllocator *GetDefaultHostAllocator() { return GetDefaultHostAllocatorRef().load(std::memory_order_acquire); }
+
+void SetDefaultHostAllocator(HostAllocator *allocator)
+{
+    MKI_CHECK(allocator != nullptr, "default host allocator can not be nullptr", return);
+    GetDefaultHostAllocatorRef().store(allocator, std::memory_order_release);
+}
+} // namespace Mki
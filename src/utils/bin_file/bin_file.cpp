@@ -15,6 +15,7 @@
 #include <climits>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include "mki/utils/assert/assert.h"
 #include "mki/utils/log/log.h"
 #include "mki/utils/strings/str_split.h"
@@ -31,7 +32,7 @@ constexpr uint64_t MAX_SINGLE_MEMCPY_SIZE = 1073741824; // copy 1G each loop
 
 BinFile::BinFile() {}
 
-BinFile::~BinFile() {}
+BinFile::~BinFile() { Unmap(); }
 
 Status BinFile::AddAttr(const std::string &name, const std::string &value)
 {
@@ -59,6 +60,10 @@ Status BinFile::AddObject(const std::string &name, char *binaryBuffer, uint64_t
         return Status::FailStatus(1, "binaryBuffer is nullptr");
     }
 
+    if (IsMapped()) {
+        return Status::FailStatus(1, "can not add object to a mapped bin file");
+    }
+
     size_t needLen = binariesBuffer_.size() + binaryLen;
     if (binaryLen > static_cast<uint64_t>(MAX_FILE_SIZE) || needLen > static_cast<uint64_t>(MAX_FILE_SIZE)) {
         return Status::FailStatus(1, "MAX file size exceeded");
@@ -73,6 +78,7 @@ Status BinFile::AddObject(const std::string &name, char *binaryBuffer, uint64_t
     BinFile::Binary binary = {currentLen, binaryLen};
     binaries_.push_back({name, binary});
     binariesBuffer_.resize(needLen);
+    binariesLength_ = needLen;
 
     uint64_t offset = 0;
     uint64_t copyLen = binaryLen;
@@ -97,7 +103,7 @@ bool BinFile::WriteImpl(int &fd)
     ret = WriteAttr(fd, ATTR_OBJECT_COUNT, std::to_string(binaries_.size()));
     MKI_CHECK(ret, "write attr object count fail", return ret);
 
-    ret = WriteAttr(fd, ATTR_OBJECT_LENGTH, std::to_string(binariesBuffer_.size()));
+    ret = WriteAttr(fd, ATTR_OBJECT_LENGTH, std::to_string(binariesLength_));
     MKI_CHECK(ret, "write attr object length fail", return ret);
 
     for (const auto &attrIt : attrs_) {
@@ -114,9 +120,9 @@ bool BinFile::WriteImpl(int &fd)
     ret = WriteAttr(fd, ATTR_END, "1");
     MKI_CHECK(ret, "write ATTR_END fail", return ret);
 
-    if (binariesBuffer_.size() > 0) {
-        auto writeSize = write(fd, binariesBuffer_.data(), binariesBuffer_.size());
-        if (writeSize != static_cast<ssize_t>(binariesBuffer_.size())) {
+    if (binariesLength_ > 0) {
+        auto writeSize = write(fd, GetBinariesData(), binariesLength_);
+        if (writeSize != static_cast<ssize_t>(binariesLength_)) {
             MKI_LOG(ERROR) << "write binaries buffer fail";
             return ret;
         }
@@ -154,18 +160,31 @@ bool BinFile::WriteAttr(int &fd, const std::string &name, const std::string &val
     return true;
 }
 
-Status BinFile::Read(const std::string &filePath)
+Status BinFile::CheckReadPath(const std::string &filePath, std::string &realPath, int64_t &fileSize) const
 {
+    MKI_CHECK(!IsMapped(), "bin file is already mapped", return Status::FailStatus(1, "bin file is already mapped"));
+
     char resolvedPath[PATH_MAX] = {0};
     MKI_CHECK(realpath(filePath.c_str(), resolvedPath) != nullptr, "realpath resolved fail",
               return Status::FailStatus(1, "realpath resolved fail"));
 
-    std::string realPath = FileSystem::PathCheckAndRegular(resolvedPath);
+    realPath = FileSystem::PathCheckAndRegular(resolvedPath);
     MKI_CHECK(!realPath.empty(), "bin file path invalid", return Status::FailStatus(1, "file path is invalid"));
-    int64_t fileSize = FileSystem::FileSize(realPath);
+    fileSize = FileSystem::FileSize(realPath);
     if (fileSize < 0 || fileSize > MAX_FILE_SIZE) {
         return Status::FailStatus(1, "File size is invalid");
     }
+    return Status::OkStatus();
+}
+
+Status BinFile::Read(const std::string &filePath)
+{
+    std::string realPath;
+    int64_t fileSize = 0;
+    Status st = CheckReadPath(filePath, realPath, fileSize);
+    if (!st.Ok()) {
+        return st;
+    }
 
     std::ifstream fd(realPath.c_str());
     if (!fd) {
@@ -175,6 +194,96 @@ Status BinFile::Read(const std::string &filePath)
     return ParseBinFile(fd, static_cast<size_t>(fileSize));
 }
 
+Status BinFile::ReadMapped(const std::string &filePath, BinFileMapAdvice advice)
+{
+    std::string realPath;
+    int64_t fileSize = 0;
+    Status st = CheckReadPath(filePath, realPath, fileSize);
+    if (!st.Ok()) {
+        return st;
+    }
+    MKI_CHECK(binaries_.empty() && attrs_.empty(), "bin file is not empty",
+              return Status::FailStatus(1, "bin file is not empty"));
+    if (fileSize == 0) {
+        return Status::FailStatus(1, "Failed to parse bin file");
+    }
+
+    int fd = open(realPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Status::FailStatus(1, "open " + FileSystem::BaseName(filePath) + " for read fail");
+    }
+    // private writable mapping, GetAllObjects hands out char * and writes must not reach the file
+    int flags = MAP_PRIVATE | (advice == BinFileMapAdvice::POPULATE ? MAP_POPULATE : 0);
+    void *addr = mmap(nullptr, static_cast<size_t>(fileSize), PROT_READ | PROT_WRITE, flags, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return Status::FailStatus(1, "mmap " + FileSystem::BaseName(filePath) + " fail");
+    }
+    mapAddr_ = static_cast<char *>(addr);
+    mapSize_ = static_cast<size_t>(fileSize);
+
+    MKI_LOG(DEBUG) << "Begin to parse mapped bin file";
+    bool foundAttrObjectLength = false;
+    bool matchAttrEnd = false;
+    size_t position = 0;
+    uint32_t lineNum = 0;
+    while (position < mapSize_) {
+        MKI_CHECK(lineNum <= MAX_FILE_LINE_NUM, "file lineNum is out of range, lineNum: " << lineNum, break);
+        lineNum++;
+
+        const char *lineBegin = mapAddr_ + position;
+        const char *lineEnd = static_cast<const char *>(memchr(lineBegin, '\n', mapSize_ - position));
+        size_t lineLen = lineEnd == nullptr ? mapSize_ - position : static_cast<size_t>(lineEnd - lineBegin);
+        position += lineEnd == nullptr ? lineLen : lineLen + 1;
+        if (!ParseHeadLine(std::string(lineBegin, lineLen), foundAttrObjectLength, matchAttrEnd) || matchAttrEnd) {
+            break;
+        }
+    }
+    if (!matchAttrEnd) {
+        MKI_LOG(ERROR) << "failed to parse bin file";
+        Unmap();
+        return Status::FailStatus(1, "Failed to parse bin file");
+    }
+
+    MKI_LOG(DEBUG) << "Map binary buffer, size: " << binariesLength_ << ", file size: " << mapSize_
+                  << ", current posotion: " << position;
+    if (binariesLength_ > mapSize_ - position) {
+        MKI_LOG(ERROR) << "Not enough file for binary buffer";
+        Unmap();
+        return Status::FailStatus(1, "Failed to parse binary from bin file");
+    }
+    mapDataOffset_ = position;
+
+    if (binariesLength_ > 0 && (advice == BinFileMapAdvice::WILLNEED || advice == BinFileMapAdvice::SEQUENTIAL)) {
+        // madvise needs a page aligned start, the mapping itself is page aligned
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t alignedOffset = mapDataOffset_ - mapDataOffset_ % pageSize;
+        int ret = madvise(mapAddr_ + alignedOffset, mapDataOffset_ + binariesLength_ - alignedOffset,
+                          advice == BinFileMapAdvice::WILLNEED ? MADV_WILLNEED : MADV_SEQUENTIAL);
+        if (ret != 0) {
+            MKI_LOG(WARN) << "madvise on bin file fail, errno: " << errno;
+        }
+    }
+    return Status::OkStatus();
+}
+
+bool BinFile::IsMapped() const { return mapAddr_ != nullptr; }
+
+void BinFile::Unmap()
+{
+    if (mapAddr_ != nullptr) {
+        munmap(mapAddr_, mapSize_);
+        mapAddr_ = nullptr;
+        mapSize_ = 0;
+        mapDataOffset_ = 0;
+    }
+}
+
+char *BinFile::GetBinariesData()
+{
+    return IsMapped() ? mapAddr_ + mapDataOffset_ : binariesBuffer_.data();
+}
+
 Status BinFile::ParseBinFile(std::ifstream &fd, size_t fileSize)
 {
     MKI_LOG(DEBUG) << "Begin to parse bin file";
@@ -185,34 +294,8 @@ Status BinFile::ParseBinFile(std::ifstream &fd, size_t fileSize)
     while (getline(fd, line)) {
         MKI_CHECK(lineNum <= MAX_FILE_LINE_NUM, "file lineNum is out of range, lineNum: " << lineNum, break);
         lineNum++;
-
-        std::vector<std::string> fields;
-        StrSplit(line, '=', fields);
-        const int needFieldNum = 2;
-        MKI_CHECK(fields.size() == needFieldNum, "Invalid binary file line!!!", break);
-
-        std::string attrName = fields[0];
-        std::string attrValue = fields[1];
-        MKI_CHECK(!attrName.empty() && !attrValue.empty(), "attrName or attrValue is empty!!!", break);
-        MKI_LOG(DEBUG) << "attrName:" << attrName << ", attrValue:" << attrValue;
-        if (attrName == ATTR_END) {
-            matchAttrEnd = true;
+        if (!ParseHeadLine(line, foundAttrObjectLength, matchAttrEnd) || matchAttrEnd) {
             break;
-        } else if (attrName == ATTR_OBJECT_COUNT) {
-            continue; // this attr is not used now
-        } else if (attrName == ATTR_OBJECT_LENGTH) {
-            MKI_CHECK(!foundAttrObjectLength, "object length is repeated", break);
-            foundAttrObjectLength = true;
-            uint64_t totalBinarySize = std::strtoull(attrValue.c_str(), nullptr, 10); // 10进制
-            MKI_CHECK(totalBinarySize <= static_cast<uint64_t>(MAX_FILE_SIZE), "totalBinarySize exceeded", break);
-            MKI_LOG(DEBUG) << "Parsed object length " << totalBinarySize;
-            binariesBuffer_.resize(totalBinarySize);
-        } else if (attrName.at(0) == '$') {
-            MKI_CHECK(ParseSystemAttr(attrName, attrValue).Ok(), "failed to parse attr", break);
-        } else {
-            MKI_CHECK(attrNames_.find(attrName) == attrNames_.end(), "attrName is repeated!!!", break);
-            attrNames_.insert(attrName);
-            attrs_.push_back({attrName, attrValue});
         }
     }
     MKI_CHECK(matchAttrEnd, "failed to parse bin file", return Status::FailStatus(1, "Failed to parse bin file"));
@@ -228,6 +311,41 @@ Status BinFile::ParseBinFile(std::ifstream &fd, size_t fileSize)
     return Status::OkStatus();
 }
 
+bool BinFile::ParseHeadLine(const std::string &line, bool &foundAttrObjectLength, bool &matchAttrEnd)
+{
+    std::vector<std::string> fields;
+    StrSplit(line, '=', fields);
+    const int needFieldNum = 2;
+    MKI_CHECK(fields.size() == needFieldNum, "Invalid binary file line!!!", return false);
+
+    std::string attrName = fields[0];
+    std::string attrValue = fields[1];
+    MKI_CHECK(!attrName.empty() && !attrValue.empty(), "attrName or attrValue is empty!!!", return false);
+    MKI_LOG(DEBUG) << "attrName:" << attrName << ", attrValue:" << attrValue;
+    if (attrName == ATTR_END) {
+        matchAttrEnd = true;
+    } else if (attrName == ATTR_OBJECT_COUNT) {
+        return true; // this attr is not used now
+    } else if (attrName == ATTR_OBJECT_LENGTH) {
+        MKI_CHECK(!foundAttrObjectLength, "object length is repeated", return false);
+        foundAttrObjectLength = true;
+        uint64_t totalBinarySize = std::strtoull(attrValue.c_str(), nullptr, 10); // 10进制
+        MKI_CHECK(totalBinarySize <= static_cast<uint64_t>(MAX_FILE_SIZE), "totalBinarySize exceeded", return false);
+        MKI_LOG(DEBUG) << "Parsed object length " << totalBinarySize;
+        binariesLength_ = totalBinarySize;
+        if (!IsMapped()) {
+            binariesBuffer_.resize(totalBinarySize);
+        }
+    } else if (attrName.at(0) == '$') {
+        MKI_CHECK(ParseSystemAttr(attrName, attrValue).Ok(), "failed to parse attr", return false);
+    } else {
+        MKI_CHECK(attrNames_.find(attrName) == attrNames_.end(), "attrName is repeated!!!", return false);
+        attrNames_.insert(attrName);
+        attrs_.push_back({attrName, attrValue});
+    }
+    return true;
+}
+
 Status BinFile::ParseSystemAttr(const std::string &attrName, const std::string &value)
 {
     if (StartsWith(attrName, ATTR_OBJECT_PREFIX)) {
@@ -242,8 +360,7 @@ Status BinFile::ParseSystemAttr(const std::string &attrName, const std::string &
 
         uint64_t offset = std::strtoull(fields[0].c_str(), nullptr, 10); // 10 进制
         uint64_t length = std::strtoull(fields[1].c_str(), nullptr, 10); // 10 进制
-        MKI_CHECK(offset <= binariesBuffer_.size() &&
-            length <= binariesBuffer_.size() && offset + length <= binariesBuffer_.size(),
+        MKI_CHECK(offset <= binariesLength_ && length <= binariesLength_ && offset + length <= binariesLength_,
             "offset " << offset << " or length " << length << " exceeded",
             return Status::FailStatus(1, "Invalid object offset/length")
         );
@@ -258,8 +375,18 @@ void BinFile::GetAllAttrs(std::vector<std::pair<std::string, std::string>> &attr
 
 void BinFile::GetAllObjects(std::vector<std::pair<std::string, std::pair<char *, uint64_t>>> &binaries)
 {
+    char *data = GetBinariesData();
     for (auto it : binaries_) {
-        binaries.push_back({it.first, {binariesBuffer_.data() + it.second.offset, it.second.length}});
+        binaries.push_back({it.first, {data + it.second.offset, it.second.length}});
+    }
+}
+
+void BinFile::GetAllObjectSpans(std::vector<std::pair<std::string, BinObjectSpan>> &objects) const
+{
+    const char *data = IsMapped() ? mapAddr_ + mapDataOffset_ : binariesBuffer_.data();
+    objects.reserve(objects.size() + binaries_.size());
+    for (const auto &it : binaries_) {
+        objects.push_back({it.first, {data + it.second.offset, it.second.length}});
     }
 }
 } // namespace Mki
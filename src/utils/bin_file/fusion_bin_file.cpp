@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/bin_file/fusion_bin_file.h"
+#include <securec.h>
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "mki/utils/assert/assert.h"
+#include "mki/utils/log/log.h"
+#include "mki/utils/file_system/file_system.h"
+#include "mki/utils/strings/str_checker.h"
+
+namespace Mki {
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+constexpr uint32_t CRC32_POLY = 0xEDB88320; // reflected IEEE 802.3 polynomial
+constexpr uint32_t CRC32_TABLE_SIZE = 256;
+constexpr uint32_t BITS_PER_BYTE = 8;
+constexpr uint32_t MAX_FUSION_BIN_ENTRY_NUM = 1000000;
+constexpr uint32_t MAX_FUSION_BIN_STRING_LEN = 256;
+
+static uint32_t Crc32(const char *data, uint64_t len, uint32_t crc = 0)
+{
+    static const std::vector<uint32_t> table = []() {
+        std::vector<uint32_t> t(CRC32_TABLE_SIZE);
+        for (uint32_t i = 0; i < CRC32_TABLE_SIZE; i++) {
+            uint32_t c = i;
+            for (uint32_t k = 0; k < BITS_PER_BYTE; k++) {
+                c = (c & 1) ? (CRC32_POLY ^ (c >> 1)) : (c >> 1);
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (uint64_t i = 0; i < len; i++) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> BITS_PER_BYTE); // 0xFF: low byte
+    }
+    return ~crc;
+}
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool WriteAll(int fd, const char *data, uint64_t len)
+{
+    while (len > 0) {
+        ssize_t writeSize = write(fd, data, len);
+        if (writeSize <= 0) {
+            MKI_LOG(ERROR) << "write fusion bin file fail, errno: " << errno;
+            return false;
+        }
+        data += writeSize;
+        len -= static_cast<uint64_t>(writeSize);
+    }
+    return true;
+}
+
+static bool WritePadding(int fd, uint64_t len)
+{
+    static const char zeros[FUSION_BIN_ALIGNMENT] = {0};
+    return WriteAll(fd, zeros, len);
+}
+
+static bool EntryKeyLess(const FusionBinEntry &lhs, const FusionBinEntry &rhs)
+{
+    return lhs.nameHash != rhs.nameHash ? lhs.nameHash < rhs.nameHash : lhs.socHash < rhs.socHash;
+}
+
+FusionBinFile::FusionBinFile() {}
+
+FusionBinFile::~FusionBinFile() { Unmap(); }
+
+uint64_t FusionBinFile::Hash(const std::string &str)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (char c : str) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+Status FusionBinFile::AddObject(const std::string &name, const std::string &soc, const char *binaryBuffer,
+                                uint64_t binaryLen)
+{
+    if (!CheckNameValid(name, MAX_FUSION_BIN_STRING_LEN) || !CheckNameValid(soc, MAX_FUSION_BIN_STRING_LEN)) {
+        return Status::FailStatus(1, "invalid name or soc");
+    }
+    if (binaryBuffer == nullptr) {
+        return Status::FailStatus(1, "binaryBuffer is nullptr");
+    }
+    if (mapAddr_ != nullptr) {
+        return Status::FailStatus(1, "can not add object to a mapped fusion bin file");
+    }
+    if (objects_.size() >= MAX_FUSION_BIN_ENTRY_NUM || binaryLen > static_cast<uint64_t>(MAX_FILE_SIZE)) {
+        return Status::FailStatus(1, "MAX object num or size exceeded");
+    }
+    if (!objectKeys_.insert({name, soc}).second) {
+        return Status::FailStatus(1, "object:" + name + " of soc:" + soc + " already exists");
+    }
+    objects_.push_back({name, soc, std::vector<char>(binaryBuffer, binaryBuffer + binaryLen)});
+    return Status::OkStatus();
+}
+
+Status FusionBinFile::Write(const std::string &filePath, const mode_t mode)
+{
+    char resolvedDir[PATH_MAX] = {0};
+    MKI_CHECK(realpath(FileSystem::DirName(filePath).c_str(), resolvedDir) != nullptr, filePath <<
+              " realpath resolved fail", return Status::FailStatus(1, "open file fail"));
+
+    std::vector<FusionBinEntry> entries(objects_.size());
+    std::vector<size_t> order(objects_.size());
+    for (size_t i = 0; i < objects_.size(); i++) {
+        entries[i] = {};
+        entries[i].nameHash = Hash(objects_[i].name);
+        entries[i].socHash = Hash(objects_[i].soc);
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return std::tie(entries[lhs].nameHash, entries[lhs].socHash, objects_[lhs].name, objects_[lhs].soc) <
+               std::tie(entries[rhs].nameHash, entries[rhs].socHash, objects_[rhs].name, objects_[rhs].soc);
+    });
+
+    std::vector<FusionBinEntry> index(objects_.size());
+    std::string stringTable;
+    uint64_t dataSize = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        const Object &object = objects_[order[i]];
+        FusionBinEntry &entry = index[i];
+        entry = entries[order[i]];
+        entry.nameOffset = static_cast<uint32_t>(stringTable.size());
+        entry.nameLength = static_cast<uint32_t>(object.name.size());
+        stringTable.append(object.name);
+        entry.socOffset = static_cast<uint32_t>(stringTable.size());
+        entry.socLength = static_cast<uint32_t>(object.soc.size());
+        stringTable.append(object.soc);
+        dataSize = AlignUp(dataSize, FUSION_BIN_ALIGNMENT);
+        entry.dataOffset = dataSize;
+        entry.dataLength = object.data.size();
+        entry.dataCrc = Crc32(object.data.data(), object.data.size());
+        dataSize += object.data.size();
+    }
+
+    FusionBinHeader header = {};
+    (void)memcpy_s(header.magic, sizeof(header.magic), FUSION_BIN_MAGIC, sizeof(FUSION_BIN_MAGIC));
+    header.version = FUSION_BIN_VERSION;
+    header.entryCount = static_cast<uint32_t>(index.size());
+    header.alignment = FUSION_BIN_ALIGNMENT;
+    header.indexOffset = sizeof(FusionBinHeader);
+    header.stringTableOffset = header.indexOffset + index.size() * sizeof(FusionBinEntry);
+    header.stringTableSize = stringTable.size();
+    header.dataOffset = AlignUp(header.stringTableOffset + header.stringTableSize, FUSION_BIN_ALIGNMENT);
+    MKI_CHECK(header.dataOffset + dataSize <= static_cast<uint64_t>(MAX_FILE_SIZE), "MAX file size exceeded",
+              return Status::FailStatus(1, "MAX file size exceeded"));
+    header.indexCrc = Crc32(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(FusionBinEntry));
+    header.indexCrc = Crc32(stringTable.data(), stringTable.size(), header.indexCrc);
+    header.headerCrc = Crc32(reinterpret_cast<const char *>(&header), offsetof(FusionBinHeader, headerCrc));
+
+    int fd = open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, mode);
+    if (fd < 0) {
+        return Status::FailStatus(1, "open file fail");
+    }
+    bool ret = WriteAll(fd, reinterpret_cast<const char *>(&header), sizeof(header)) &&
+               WriteAll(fd, reinterpret_cast<const char *>(index.data()), index.size() * sizeof(FusionBinEntry)) &&
+               WriteAll(fd, stringTable.data(), stringTable.size()) &&
+               WritePadding(fd, header.dataOffset - header.stringTableOffset - header.stringTableSize);
+    uint64_t position = 0;
+    for (size_t i = 0; ret && i < index.size(); i++) {
+        const Object &object = objects_[order[i]];
+        ret = WritePadding(fd, index[i].dataOffset - position) &&
+              WriteAll(fd, object.data.data(), object.data.size());
+        position = index[i].dataOffset + object.data.size();
+    }
+    close(fd);
+    if (!ret) {
+        return Status::FailStatus(1, "write fusion bin file fail");
+    }
+    return Status::OkStatus();
+}
+
+Status FusionBinFile::Read(const std::string &filePath)
+{
+    MKI_CHECK(mapAddr_ == nullptr && objects_.empty(), "fusion bin file is not empty",
+              return Status::FailStatus(1, "fusion bin file is not empty"));
+
+    char resolvedPath[PATH_MAX] = {0};
+    MKI_CHECK(realpath(filePath.c_str(), resolvedPath) != nullptr, "realpath resolved fail",
+              return Status::FailStatus(1, "realpath resolved fail"));
+    std::string realPath = FileSystem::PathCheckAndRegular(resolvedPath);
+    MKI_CHECK(!realPath.empty(), "fusion bin file path invalid", return Status::FailStatus(1, "file path is invalid"));
+    int64_t fileSize = FileSystem::FileSize(realPath);
+    if (fileSize < static_cast<int64_t>(sizeof(FusionBinHeader)) || fileSize > MAX_FILE_SIZE) {
+        return Status::FailStatus(1, "File size is invalid");
+    }
+
+    int fd = open(realPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Status::FailStatus(1, "open " + FileSystem::BaseName(filePath) + " for read fail");
+    }
+    void *addr = mmap(nullptr, static_cast<size_t>(fileSize), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return Status::FailStatus(1, "mmap " + FileSystem::BaseName(filePath) + " fail");
+    }
+    mapAddr_ = static_cast<char *>(addr);
+    mapSize_ = static_cast<size_t>(fileSize);
+    header_ = reinterpret_cast<const FusionBinHeader *>(mapAddr_);
+    entries_ = reinterpret_cast<const FusionBinEntry *>(mapAddr_ + sizeof(FusionBinHeader));
+
+    Status st = CheckIndex();
+    if (!st.Ok()) {
+        MKI_LOG(ERROR) << "invalid fusion bin file " << FileSystem::BaseName(filePath) << ", " << st.Message();
+        Unmap();
+        return st;
+    }
+    MKI_LOG(DEBUG) << "Read fusion bin file " << FileSystem::BaseName(filePath) << ", object count: "
+                   << header_->entryCount;
+    return Status::OkStatus();
+}
+
+Status FusionBinFile::CheckIndex() const
+{
+    if (memcmp(header_->magic, FUSION_BIN_MAGIC, sizeof(FUSION_BIN_MAGIC)) != 0) {
+        return Status::FailStatus(1, "magic mismatch");
+    }
+    if (header_->version != FUSION_BIN_VERSION) {
+        return Status::FailStatus(1, "unsupported version " + std::to_string(header_->version));
+    }
+    if (Crc32(mapAddr_, offsetof(FusionBinHeader, headerCrc)) != header_->headerCrc) {
+        return Status::FailStatus(1, "header crc mismatch");
+    }
+    if (header_->alignment == 0 || header_->entryCount > MAX_FUSION_BIN_ENTRY_NUM ||
+        header_->indexOffset != sizeof(FusionBinHeader) ||
+        header_->stringTableOffset != header_->indexOffset + header_->entryCount * sizeof(FusionBinEntry) ||
+        header_->stringTableOffset > mapSize_ || header_->stringTableSize > mapSize_ - header_->stringTableOffset ||
+        header_->dataOffset < header_->stringTableOffset + header_->stringTableSize || header_->dataOffset > mapSize_) {
+        return Status::FailStatus(1, "invalid header layout");
+    }
+    if (Crc32(mapAddr_ + header_->indexOffset, header_->stringTableOffset + header_->stringTableSize -
+              header_->indexOffset) != header_->indexCrc) {
+        return Status::FailStatus(1, "index crc mismatch");
+    }
+    uint64_t dataSize = mapSize_ - header_->dataOffset;
+    for (uint32_t i = 0; i < header_->entryCount; i++) {
+        const FusionBinEntry &entry = entries_[i];
+        if (static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header_->stringTableSize ||
+            static_cast<uint64_t>(entry.socOffset) + entry.socLength > header_->stringTableSize ||
+            entry.dataOffset > dataSize || entry.dataLength > dataSize - entry.dataOffset) {
+            return Status::FailStatus(1, "entry " + std::to_string(i) + " out of range");
+        }
+        if (i > 0 && EntryKeyLess(entry, entries_[i - 1])) {
+            return Status::FailStatus(1, "index is not sorted");
+        }
+    }
+    return Status::OkStatus();
+}
+
+Status FusionBinFile::Find(const std::string &name, const std::string &soc, BinObjectSpan &object) const
+{
+    if (mapAddr_ == nullptr) {
+        return Status::FailStatus(1, "fusion bin file is not read");
+    }
+    FusionBinEntry key = {};
+    key.nameHash = Hash(name);
+    key.socHash = Hash(soc);
+    const FusionBinEntry *end = entries_ + header_->entryCount;
+    for (const FusionBinEntry *it = std::lower_bound(entries_, end, key, EntryKeyLess);
+         it != end && !EntryKeyLess(key, *it); ++it) {
+        if (!EntryStringEquals(it->nameOffset, it->nameLength, name) ||
+            !EntryStringEquals(it->socOffset, it->socLength, soc)) {
+            continue; // hash collision
+        }
+        BinObjectSpan span = GetEntryObject(*it);
+        if (Crc32(span.data, span.length) != it->dataCrc) {
+            MKI_LOG(ERROR) << "object " << name << " of soc " << soc << " crc mismatch";
+            return Status::FailStatus(1, "object crc mismatch");
+        }
+        object = span;
+        return Status::OkStatus();
+    }
+    return Status::FailStatus(1, "object " + name + " of soc " + soc + " not found");
+}
+
+void FusionBinFile::GetSocObjects(const std::string &soc,
+                                  std::vector<std::pair<std::string, BinObjectSpan>> &objects) const
+{
+    if (mapAddr_ == nullptr) {
+        return;
+    }
+    uint64_t socHash = Hash(soc);
+    for (uint32_t i = 0; i < header_->entryCount; i++) {
+        const FusionBinEntry &entry = entries_[i];
+        if (entry.socHash == socHash && EntryStringEquals(entry.socOffset, entry.socLength, soc)) {
+            objects.push_back({GetEntryString(entry.nameOffset, entry.nameLength), GetEntryObject(entry)});
+        }
+    }
+}
+
+uint32_t FusionBinFile::GetObjectCount() const
+{
+    return mapAddr_ != nullptr ? header_->entryCount : static_cast<uint32_t>(objects_.size());
+}
+
+std::string FusionBinFile::GetEntryString(uint32_t offset, uint32_t length) const
+{
+    return std::string(mapAddr_ + header_->stringTableOffset + offset, length);
+}
+
+bool FusionBinFile::EntryStringEquals(uint32_t offset, uint32_t length, const std::string &str) const
+{
+    return length == str.size() && memcmp(mapAddr_ + header_->stringTableOffset + offset, str.data(), length) == 0;
+}
+
+BinObjectSpan FusionBinFile::GetEntryObject(const FusionBinEntry &entry) const
+{
+    return {mapAddr_ + header_->dataOffset + entry.dataOffset, entry.dataLength};
+}
+
+void FusionBinFile::Unmap()
+{
+    if (mapAddr_ != nullptr) {
+        munmap(mapAddr_, mapSize_);
+        mapAddr_ = nullptr;
+        mapSize_ = 0;
+        header_ = nullptr;
+        entries_ = nullptr;
+    }
+}
+} // namespace Mki
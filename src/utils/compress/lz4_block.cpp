@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/compress/lz4_block.h"
+#include <securec.h>
+
+namespace Mki {
+constexpr uint32_t LZ4_MIN_MATCH = 4;
+constexpr uint32_t LZ4_RUN_MASK = 0xF; // 4 bits of the token for each length
+constexpr uint32_t LZ4_LITERAL_SHIFT = 4;
+constexpr uint32_t LZ4_LENGTH_BYTE_MAX = 255;
+constexpr uint32_t LZ4_OFFSET_SIZE = 2;
+constexpr uint32_t BITS_PER_BYTE = 8;
+
+static bool ReadLength(const uint8_t *&ip, const uint8_t *ipEnd, size_t maxLen, size_t &length)
+{
+    uint32_t value = 0;
+    do {
+        if (ip >= ipEnd) {
+            return false;
+        }
+        value = *ip++;
+        length += value;
+        if (length > maxLen) {
+            return false;
+        }
+    } while (value == LZ4_LENGTH_BYTE_MAX);
+    return true;
+}
+
+bool Lz4BlockDecompress(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstLen)
+{
+    if (src == nullptr || dst == nullptr) {
+        return false;
+    }
+    const uint8_t *ip = src;
+    const uint8_t *ipEnd = src + srcLen;
+    uint8_t *op = dst;
+    uint8_t *opEnd = dst + dstLen;
+    while (ip < ipEnd) {
+        uint32_t token = *ip++;
+        size_t literalLen = token >> LZ4_LITERAL_SHIFT;
+        if (literalLen == LZ4_RUN_MASK && !ReadLength(ip, ipEnd, dstLen, literalLen)) {
+            return false;
+        }
+        if (literalLen > static_cast<size_t>(ipEnd - ip) || literalLen > static_cast<size_t>(opEnd - op)) {
+            return false;
+        }
+        if (literalLen > 0 && memcpy_s(op, static_cast<size_t>(opEnd - op), ip, literalLen) != EOK) {
+            return false;
+        }
+        ip += literalLen;
+        op += literalLen;
+        if (ip == ipEnd) {
+            break; // the last sequence only carries literals
+        }
+
+        if (static_cast<size_t>(ipEnd - ip) < LZ4_OFFSET_SIZE) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << BITS_PER_BYTE);
+        ip += LZ4_OFFSET_SIZE;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            return false;
+        }
+        size_t matchLen = token & LZ4_RUN_MASK;
+        if (matchLen == LZ4_RUN_MASK && !ReadLength(ip, ipEnd, dstLen, matchLen)) {
+            return false;
+        }
+        matchLen += LZ4_MIN_MATCH;
+        if (matchLen > static_cast<size_t>(opEnd - op)) {
+            return false;
+        }
+        // match may overlap the output being written, copy forward byte by byte
+        const uint8_t *match = op - offset;
+        for (size_t i = 0; i < matchLen; ++i) {
+            op[i] = match[i];
+        }
+        op += matchLen;
+    }
+    return op == opEnd;
+}
+} // namespace Mki
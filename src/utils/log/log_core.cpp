@@ -18,6 +18,8 @@
 #include <algorithm>
 #include "mki/utils/log/log_sink_stdout.h"
 #include "mki/utils/log/log_sink_file.h"
+#include "mki/utils/log/log_sink_async.h"
+#include "mki/utils/log/log_sink_binary.h"
 #include "mki/utils/log/log.h"
 #include "mki/utils/env/env.h"
 
@@ -35,6 +37,45 @@ static bool GetLogToFileFromEnv()
     return envLogToFile != nullptr && strlen(envLogToFile) <= MAX_ENV_STRING_LEN && strcmp(envLogToFile, "1") == 0;
 }
 
+static bool GetLogToBinaryFromEnv()
+{
+    const char *envLogToBinary = std::getenv("ASDOPS_LOG_TO_BINARY");
+    return envLogToBinary != nullptr && strlen(envLogToBinary) <= MAX_ENV_STRING_LEN &&
+           strcmp(envLogToBinary, "1") == 0;
+}
+
+static bool GetLogAsyncFromEnv()
+{
+    const char *envLogAsync = std::getenv("ASDOPS_LOG_ASYNC");
+    return envLogAsync != nullptr && strlen(envLogAsync) <= MAX_ENV_STRING_LEN && strcmp(envLogAsync, "1") == 0;
+}
+
+static LogOverflowPolicy GetLogOverflowPolicyFromEnv()
+{
+    const char *env = std::getenv("ASDOPS_LOG_ASYNC_OVERFLOW");
+    if (env == nullptr || strlen(env) > MAX_ENV_STRING_LEN) {
+        return LogOverflowPolicy::BLOCK;
+    }
+    std::string envPolicy(env);
+    std::transform(envPolicy.begin(), envPolicy.end(), envPolicy.begin(), ::toupper);
+    static std::unordered_map<std::string, LogOverflowPolicy> policyMap{{"BLOCK", LogOverflowPolicy::BLOCK},
+                                                                        {"DROP", LogOverflowPolicy::DROP},
+                                                                        {"COUNT", LogOverflowPolicy::COUNT}};
+    auto policyIt = policyMap.find(envPolicy);
+    return policyIt != policyMap.end() ? policyIt->second : LogOverflowPolicy::BLOCK;
+}
+
+static uint64_t GetUintFromEnv(const char *name, uint64_t defaultValue)
+{
+    const char *env = std::getenv(name);
+    if (env == nullptr || strlen(env) > MAX_ENV_STRING_LEN) {
+        return defaultValue;
+    }
+    char *end = nullptr;
+    unsigned long long value = std::strtoull(env, &end, 10); // 10: decimal
+    return (end == env || *end != '\0') ? defaultValue : value;
+}
+
 static LogLevel GetLogLevelFromEnv()
 {
     const char *env = std::getenv("ASDOPS_LOG_LEVEL");
@@ -53,34 +94,113 @@ static LogLevel GetLogLevelFromEnv()
 LogCore::LogCore()
 {
     level_ = GetLogLevelFromEnv();
+    uint64_t rateLimit = GetUintFromEnv("ASDOPS_LOG_RATE_LIMIT", 0);
+    rateLimiter_.SetRate(rateLimit, GetUintFromEnv("ASDOPS_LOG_RATE_BURST", rateLimit));
     if (GetLogToStdoutFromEnv()) {
         AddSink(std::make_shared<LogSinkStdout>());
     }
     if (GetLogToFileFromEnv()) {
         AddSink(std::make_shared<LogSinkFile>());
     }
+    if (!sinks_.empty() && GetLogAsyncFromEnv()) {
+        std::vector<std::shared_ptr<LogSink>> sinks;
+        sinks.swap(sinks_);
+        AddSink(std::make_shared<LogSinkAsync>(std::move(sinks), GetLogOverflowPolicyFromEnv()));
+    }
+    // binary sink buffers records itself, so it is never wrapped by the async sink
+    if (GetLogToBinaryFromEnv()) {
+        AddSink(std::make_shared<LogSinkBinary>());
+    }
 }
 
+std::atomic<int> LogCore::cachedLogLevel_{-1};
+
 LogCore &LogCore::Instance()
 {
-    static LogCore logCore;
-    return logCore;
+    static LogCore *logCore = []() {
+        static LogCore instance;
+        instance.isInstance_ = true;
+        cachedLogLevel_.store(static_cast<int>(instance.level_), std::memory_order_relaxed);
+        return &instance;
+    }();
+    return *logCore;
 }
 
 LogLevel LogCore::GetLogLevel() const { return level_; }
 
-void LogCore::SetLogLevel(LogLevel level) { level_ = level; }
+void LogCore::SetLogLevel(LogLevel level)
+{
+    level_ = level;
+    if (isInstance_) {
+        cachedLogLevel_.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+}
+
+bool LogCore::AcquireLogToken()
+{
+    if (rateLimiter_.Enabled()) {
+        uint64_t suppressedCount = 0;
+        if (!rateLimiter_.Acquire(suppressedCount)) {
+            return false;
+        }
+        if (suppressedCount > 0) {
+            LogSuppressedCount(suppressedCount);
+        }
+    }
+    return true;
+}
 
 void LogCore::Log(const char *log, uint64_t logLen)
 {
+    if (!AcquireLogToken()) {
+        return;
+    }
     for (auto &sink : sinks_) {
         sink->Log(log, logLen);
     }
 }
 
+bool LogCore::HasTextSink() const { return hasTextSink_; }
+
+bool LogCore::HasStructuredSink() const { return hasStructuredSink_; }
+
+void LogCore::LogText(const char *log, uint64_t logLen)
+{
+    for (auto &sink : sinks_) {
+        if (!sink->IsStructured()) {
+            sink->Log(log, logLen);
+        }
+    }
+}
+
+void LogCore::LogStructured(const LogEntity &entity, const char *format, va_list args)
+{
+    for (auto &sink : sinks_) {
+        if (sink->IsStructured()) {
+            va_list sinkArgs;
+            va_copy(sinkArgs, args);
+            sink->LogStructured(entity, format, sinkArgs);
+            va_end(sinkArgs);
+        }
+    }
+}
+
+void LogCore::LogSuppressedCount(uint64_t suppressedCount)
+{
+    std::string log = "[mki_log] " + std::to_string(suppressedCount) + " logs are suppressed by rate limit\n";
+    for (auto &sink : sinks_) {
+        sink->Log(log.c_str(), log.size());
+    }
+}
+
+void LogCore::SetLogRateLimit(uint64_t ratePerSecond, uint64_t burst) { rateLimiter_.SetRate(ratePerSecond, burst); }
+
+uint64_t LogCore::GetSuppressedLogCount() const { return rateLimiter_.GetSuppressedTotal(); }
+
 void LogCore::DeleteLogFileSink()
 {
     sinks_.pop_back();
+    UpdateSinkFlags();
 }
 
 void LogCore::AddSink(std::shared_ptr<LogSink> sink)
@@ -90,6 +210,20 @@ void LogCore::AddSink(std::shared_ptr<LogSink> sink)
         return;
     }
     sinks_.push_back(sink);
+    UpdateSinkFlags();
+}
+
+void LogCore::UpdateSinkFlags()
+{
+    hasTextSink_ = false;
+    hasStructuredSink_ = false;
+    for (auto &sink : sinks_) {
+        if (sink->IsStructured()) {
+            hasStructuredSink_ = true;
+        } else {
+            hasTextSink_ = true;
+        }
+    }
 }
 
 const std::vector<std::shared_ptr<LogSink>> &LogCore::GetAllSinks() const { return sinks_; }
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/log/log_rate_limiter.h"
+#include <algorithm>
+
+namespace Mki {
+constexpr int64_t MS_PER_SECOND = 1000;
+constexpr int64_t SUPPRESSED_REPORT_INTERVAL_MS = 1000;
+
+void LogRateLimiter::SetRate(uint64_t ratePerSecond, uint64_t burst)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    rate_ = ratePerSecond;
+    burst_ = std::max(burst, ratePerSecond > 0 ? uint64_t(1) : uint64_t(0));
+    tokens_ = static_cast<double>(burst_);
+    lastRefillMs_ = GetLogSteadyTimeMs();
+}
+
+uint64_t LogRateLimiter::GetRate() const { return rate_; }
+
+bool LogRateLimiter::Enabled() const { return rate_.load(std::memory_order_relaxed) > 0; }
+
+bool LogRateLimiter::Acquire(uint64_t &suppressedCount)
+{
+    suppressedCount = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t rate = rate_.load(std::memory_order_relaxed);
+    if (rate == 0) {
+        return true;
+    }
+    int64_t nowMs = GetLogSteadyTimeMs();
+    if (nowMs > lastRefillMs_) {
+        tokens_ += static_cast<double>(nowMs - lastRefillMs_) * rate / MS_PER_SECOND;
+        tokens_ = std::min(tokens_, static_cast<double>(burst_));
+        lastRefillMs_ = nowMs;
+    }
+    if (tokens_ < 1) {
+        unreportedCount_++;
+        suppressedTotal_++;
+        return false;
+    }
+    tokens_ -= 1;
+    if (unreportedCount_ > 0 && nowMs - lastReportMs_ >= SUPPRESSED_REPORT_INTERVAL_MS) {
+        suppressedCount = unreportedCount_;
+        unreportedCount_ = 0;
+        lastReportMs_ = nowMs;
+    }
+    return true;
+}
+
+uint64_t LogRateLimiter::GetSuppressedTotal() const { return suppressedTotal_; }
+} // namespace Mki
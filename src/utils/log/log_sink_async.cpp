@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/log/log_sink_async.h"
+#include <csignal>
+#include <cstdio>
+#include <cinttypes>
+#include <chrono>
+#include <ctime>
+#include <unistd.h>
+#include <securec.h>
+
+namespace Mki {
+constexpr size_t MIN_ASYNC_CAPACITY = 64;
+constexpr size_t MAX_ASYNC_CAPACITY = 1 << 20;
+constexpr int MAX_BATCH_LOG_NUM = 256;
+constexpr int CRASH_FLUSH_RETRY = 100;
+constexpr long CRASH_FLUSH_RETRY_NS = 1000000;
+constexpr std::chrono::milliseconds FLUSH_INTERVAL(20);
+static const int CRASH_SIGNALS[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+constexpr size_t CRASH_SIGNAL_NUM = sizeof(CRASH_SIGNALS) / sizeof(CRASH_SIGNALS[0]);
+
+static std::atomic<LogSinkAsync *> g_crashFlushSink{nullptr};
+static struct sigaction g_oldActions[CRASH_SIGNAL_NUM];
+
+static size_t AlignCapacity(size_t capacity)
+{
+    size_t alignedCapacity = MIN_ASYNC_CAPACITY;
+    while (alignedCapacity < capacity && alignedCapacity < MAX_ASYNC_CAPACITY) {
+        alignedCapacity <<= 1;
+    }
+    return alignedCapacity;
+}
+
+LogSinkAsync::LogSinkAsync(std::vector<std::shared_ptr<LogSink>> sinks, LogOverflowPolicy policy, size_t capacity,
+                           bool flushOnCrash)
+    : sinks_(std::move(sinks)), policy_(policy), capacity_(AlignCapacity(capacity)), mask_(capacity_ - 1),
+      slots_(new Slot[capacity_])
+{
+    for (size_t i = 0; i < capacity_; ++i) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    thread_ = std::thread(&LogSinkAsync::FlushThread, this);
+    if (flushOnCrash) {
+        g_crashFlushSink.store(this);
+        InstallCrashHandler();
+    }
+}
+
+LogSinkAsync::~LogSinkAsync()
+{
+    LogSinkAsync *self = this;
+    (void)g_crashFlushSink.compare_exchange_strong(self, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    flushCv_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    std::lock_guard<std::mutex> drainLock(drainMutex_);
+    while (Drain() > 0) {
+    }
+    WriteDropReport();
+}
+
+void LogSinkAsync::Log(const char *log, uint64_t logLen)
+{
+    bool blocked = false;
+    while (!TryEnqueue(log, logLen)) {
+        if (policy_ != LogOverflowPolicy::BLOCK || std::this_thread::get_id() == thread_.get_id()) {
+            dropCount_++;
+            if (policy_ == LogOverflowPolicy::COUNT) {
+                unreportedDropCount_++;
+            }
+            return;
+        }
+        if (!blocked) {
+            blocked = true;
+            blockCount_++;
+        }
+        flushCv_.notify_one();
+        std::this_thread::yield();
+    }
+    enqueueCount_++;
+    uint64_t pending = enqueuePos_.load(std::memory_order_relaxed) - dequeuePos_.load(std::memory_order_relaxed);
+    if (pending >= capacity_ / 2) { // 2: wake up flusher when half full
+        flushCv_.notify_one();
+    }
+}
+
+bool LogSinkAsync::TryEnqueue(const char *log, uint64_t logLen)
+{
+    uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    while (true) {
+        slot = &slots_[pos & mask_];
+        int64_t diff = static_cast<int64_t>(slot->seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // full
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->len = logLen;
+    char *dst = slot->data;
+    if (logLen >= SLOT_DATA_SIZE) {
+        slot->largeData = new (std::nothrow) char[logLen + 1];
+        dst = slot->largeData;
+    }
+    if (dst == nullptr || memcpy_s(dst, logLen + 1, log, logLen) != EOK) {
+        slot->len = 0; // the slot is taken, publish it as empty
+    } else {
+        dst[logLen] = '\0';
+    }
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+size_t LogSinkAsync::Drain()
+{
+    if (drainBusy_.test_and_set(std::memory_order_acquire)) {
+        return 0; // the crash handler is writing the ring
+    }
+    struct iovec iov[MAX_BATCH_LOG_NUM];
+    int iovCnt = 0;
+    uint64_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    size_t slotNum = 0;
+    while (slotNum < static_cast<size_t>(MAX_BATCH_LOG_NUM)) {
+        Slot &slot = slots_[(pos + slotNum) & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != pos + slotNum + 1) {
+            break;
+        }
+        if (slot.len > 0) {
+            iov[iovCnt].iov_base = slot.largeData != nullptr ? slot.largeData : slot.data;
+            iov[iovCnt].iov_len = slot.len;
+            iovCnt++;
+        }
+        slotNum++;
+    }
+    if (iovCnt > 0) {
+        for (auto &sink : sinks_) {
+            sink->LogBatch(iov, iovCnt);
+        }
+        batchCount_++;
+    }
+    for (size_t i = 0; i < slotNum; ++i) {
+        Slot &slot = slots_[(pos + i) & mask_];
+        delete[] slot.largeData;
+        slot.largeData = nullptr;
+        slot.seq.store(pos + i + capacity_, std::memory_order_release);
+    }
+    dequeuePos_.store(pos + slotNum, std::memory_order_release);
+    drainBusy_.clear(std::memory_order_release);
+    return slotNum;
+}
+
+// async-signal-safe: the published slots are already formatted, they are written with write(2) only
+void LogSinkAsync::WriteOnCrash()
+{
+    uint64_t pos = dequeuePos_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < capacity_; ++i, ++pos) {
+        Slot &slot = slots_[pos & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+            break;
+        }
+        const char *data = slot.largeData != nullptr ? slot.largeData : slot.data;
+        for (auto &sink : sinks_) {
+            int fd = sink->GetCrashFd();
+            if (fd >= 0 && slot.len > 0) {
+                (void)write(fd, data, slot.len);
+            }
+        }
+    }
+}
+
+void LogSinkAsync::WriteDropReport()
+{
+    uint64_t dropCount = unreportedDropCount_.exchange(0);
+    if (dropCount == 0) {
+        return;
+    }
+    char report[128] = {0}; // 128: report buffer size
+    int len = snprintf_s(report, sizeof(report), sizeof(report) - 1,
+                         "[mki_log] %" PRIu64 " logs are dropped by async log sink\n", dropCount);
+    if (len <= 0) {
+        return;
+    }
+    struct iovec iov = {report, static_cast<size_t>(len)};
+    for (auto &sink : sinks_) {
+        sink->LogBatch(&iov, 1);
+    }
+}
+
+void LogSinkAsync::FlushThread()
+{
+    bool stop = false;
+    while (!stop) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            flushCv_.wait_for(lock, FLUSH_INTERVAL, [this]() {
+                return stop_ || enqueuePos_.load(std::memory_order_relaxed) -
+                                dequeuePos_.load(std::memory_order_relaxed) >= capacity_ / 2; // 2: half full
+            });
+            stop = stop_;
+        }
+        std::lock_guard<std::mutex> drainLock(drainMutex_);
+        while (Drain() > 0) {
+        }
+        WriteDropReport();
+    }
+}
+
+void LogSinkAsync::Flush()
+{
+    uint64_t target = enqueuePos_.load(std::memory_order_acquire);
+    while (dequeuePos_.load(std::memory_order_acquire) < target) {
+        {
+            std::lock_guard<std::mutex> drainLock(drainMutex_);
+            (void)Drain();
+        }
+        if (dequeuePos_.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield(); // a producer has not published its slot yet
+        }
+    }
+    std::lock_guard<std::mutex> drainLock(drainMutex_);
+    WriteDropReport();
+}
+
+LogOverflowPolicy LogSinkAsync::GetOverflowPolicy() const { return policy_; }
+
+size_t LogSinkAsync::GetCapacity() const { return capacity_; }
+
+LogAsyncStats LogSinkAsync::GetStats() const
+{
+    LogAsyncStats stats;
+    stats.enqueueCount = enqueueCount_.load();
+    stats.dropCount = dropCount_.load();
+    stats.blockCount = blockCount_.load();
+    stats.batchCount = batchCount_.load();
+    return stats;
+}
+
+void LogSinkAsync::InstallCrashHandler()
+{
+    static std::once_flag installFlag;
+    std::call_once(installFlag, []() {
+        struct sigaction action;
+        (void)memset_s(&action, sizeof(action), 0, sizeof(action));
+        action.sa_handler = &LogSinkAsync::CrashHandler;
+        (void)sigemptyset(&action.sa_mask);
+        for (size_t i = 0; i < CRASH_SIGNAL_NUM; ++i) {
+            (void)sigaction(CRASH_SIGNALS[i], &action, &g_oldActions[i]);
+        }
+    });
+}
+
+// best effort: write what is left in the ring, then hand the signal to the previous handler. Only
+// async-signal-safe calls are made here, logs that are not formatted into the ring yet are lost.
+void LogSinkAsync::CrashHandler(int sig)
+{
+    LogSinkAsync *sink = g_crashFlushSink.exchange(nullptr);
+    if (sink != nullptr) {
+        // wait for a Drain in progress, it may be on the crashed thread so the wait is bounded
+        bool acquired = !sink->drainBusy_.test_and_set(std::memory_order_acquire);
+        struct timespec retryInterval = {0, CRASH_FLUSH_RETRY_NS};
+        for (int i = 0; !acquired && i < CRASH_FLUSH_RETRY; ++i) {
+            (void)nanosleep(&retryInterval, nullptr);
+            acquired = !sink->drainBusy_.test_and_set(std::memory_order_acquire);
+        }
+        if (acquired) {
+            sink->WriteOnCrash();
+        }
+    }
+    for (size_t i = 0; i < CRASH_SIGNAL_NUM; ++i) {
+        if (CRASH_SIGNALS[i] == sig) {
+            (void)sigaction(sig, &g_oldActions[i], nullptr);
+            break;
+        }
+    }
+    (void)raise(sig);
+}
+} // namespace Mki
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/log/log_sink_binary.h"
+#include <chrono>
+#include <cstring>
+#include <securec.h>
+#include "mki/utils/log/log_sink_file.h"
+#include "mki/utils/log/log_rate_limiter.h"
+#include "mki/utils/log/log_stream.h"
+
+namespace Mki {
+constexpr uint32_t MAX_CALLSITE_COUNT = 65536;
+constexpr size_t MAX_STR16_LEN = 65535;
+constexpr size_t MAX_STRING_ARG_LEN = 1024;   // same as the content limit of text logs
+constexpr size_t MAX_FORMAT_ARG_COUNT = 255;
+constexpr uint8_t LONG_DOUBLE_FLAG = 0x80;    // parsed long double, encoded as DOUBLE
+constexpr int64_t FLUSH_INTERVAL_MS = 1000;   // buffered records are written at least once per second
+
+template <typename T> static void AppendValue(std::string &buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+static void AppendStr16(std::string &buffer, const char *str, size_t maxLen = MAX_STR16_LEN)
+{
+    if (str == nullptr) {
+        str = "(null)";
+    }
+    size_t len = strnlen(str, maxLen);
+    AppendValue(buffer, static_cast<uint16_t>(len));
+    buffer.append(str, len);
+}
+
+// types of the arguments consumed by a printf format, false if the format uses an unsupported conversion
+static bool ParseFormatArgs(const char *format, std::vector<uint8_t> &argTypes)
+{
+    const char *p = format;
+    while (*p != '\0') {
+        if (*p++ != '%') {
+            continue;
+        }
+        if (*p == '%') {
+            ++p;
+            continue;
+        }
+        while (*p != '\0' && strchr("-+ #0'", *p) != nullptr) {
+            ++p;
+        }
+        if (*p == '*') {
+            argTypes.push_back(static_cast<uint8_t>(LogArgType::INT));
+            ++p;
+        }
+        while (*p >= '0' && *p <= '9') {
+            ++p;
+        }
+        if (*p == '.') {
+            ++p;
+            if (*p == '*') {
+                argTypes.push_back(static_cast<uint8_t>(LogArgType::INT));
+                ++p;
+            }
+            while (*p >= '0' && *p <= '9') {
+                ++p;
+            }
+        }
+        bool isLong = false;
+        bool isLongDouble = false;
+        while (*p != '\0' && strchr("hlLqjzt", *p) != nullptr) {
+            isLong = isLong || *p != 'h';
+            isLongDouble = isLongDouble || *p == 'L';
+            ++p;
+        }
+        if (*p == '\0') {
+            return false;
+        }
+        switch (*p++) {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+                argTypes.push_back(static_cast<uint8_t>(isLong ? LogArgType::LONG : LogArgType::INT));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                argTypes.push_back(static_cast<uint8_t>(LogArgType::DOUBLE) | (isLongDouble ? LONG_DOUBLE_FLAG : 0));
+                break;
+            case 's':
+                if (isLong) {
+                    return false; // wide string
+                }
+                argTypes.push_back(static_cast<uint8_t>(LogArgType::STRING));
+                break;
+            case 'p':
+                argTypes.push_back(static_cast<uint8_t>(LogArgType::POINTER));
+                break;
+            default:
+                return false;
+        }
+    }
+    return argTypes.size() <= MAX_FORMAT_ARG_COUNT;
+}
+
+static void AppendArgs(std::string &buffer, const std::vector<uint8_t> &argTypes, va_list args)
+{
+    for (uint8_t argType : argTypes) {
+        if ((argType & LONG_DOUBLE_FLAG) != 0) {
+            AppendValue(buffer, static_cast<double>(va_arg(args, long double)));
+            continue;
+        }
+        switch (static_cast<LogArgType>(argType)) {
+            case LogArgType::INT:
+                AppendValue(buffer, static_cast<int32_t>(va_arg(args, int)));
+                break;
+            case LogArgType::LONG:
+                AppendValue(buffer, static_cast<int64_t>(va_arg(args, long long)));
+                break;
+            case LogArgType::DOUBLE:
+                AppendValue(buffer, va_arg(args, double));
+                break;
+            case LogArgType::STRING:
+                AppendStr16(buffer, va_arg(args, const char *), MAX_STRING_ARG_LEN);
+                break;
+            case LogArgType::POINTER:
+                AppendValue(buffer, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(va_arg(args, void *))));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+LogSinkBinary::LogSinkBinary()
+{
+    std::shared_ptr<LogSinkFile> fileSink = std::make_shared<LogSinkFile>(".binlog");
+    fileSink->SetFileHeaderGenerator([this]() { return GetFileHeader(); });
+    fileSink->SetPeriodicTask([this]() { Flush(); }, FLUSH_INTERVAL_MS);
+    fileOutput_ = fileSink.get();
+    output_ = fileSink;
+    bufferSize_ = 65536; // 65536: 64KB per write
+    buffer_.reserve(bufferSize_);
+}
+
+LogSinkBinary::LogSinkBinary(std::shared_ptr<LogSink> output, size_t bufferSize)
+    : output_(std::move(output)), bufferSize_(bufferSize)
+{
+    buffer_.reserve(bufferSize_);
+}
+
+LogSinkBinary::~LogSinkBinary()
+{
+    if (fileOutput_ != nullptr) {
+        fileOutput_->SetPeriodicTask(nullptr, 0);
+    }
+    Flush();
+    if (fileOutput_ != nullptr) {
+        fileOutput_->SetFileHeaderGenerator(nullptr); // the file sink may outlive this sink
+    }
+}
+
+void LogSinkBinary::Log(const char *log, uint64_t logLen)
+{
+    bool needFlush = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        AppendValue(buffer_, static_cast<uint8_t>(LogRecordType::TEXT));
+        AppendValue(buffer_, static_cast<uint32_t>(logLen));
+        buffer_.append(log, logLen);
+        needFlush = NeedFlush(LogLevel::TRACE);
+    }
+    if (needFlush) {
+        Flush();
+    }
+}
+
+void LogSinkBinary::LogStructured(const LogEntity &entity, const char *format, va_list args)
+{
+    uint64_t timeUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(entity.time.time_since_epoch()).count());
+    bool needFlush = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Callsite *callsite = GetCallsite(entity, format);
+        if (callsite == nullptr || !callsite->encodable) {
+            const size_t logContentSize = 1024; // 1024 日志内容最大支持1024
+            char text[MAX_LOG_HEADER_LEN + logContentSize + 1] = {0};
+            // the callsite table is full, the text has the same header as a text log
+            size_t headerLen = callsite == nullptr ? FormatLogHeader(entity, text, MAX_LOG_HEADER_LEN) : 0;
+            char *content = text + headerLen;
+            int len = vsnprintf_s(content, logContentSize + 1, logContentSize, format, args);
+            content[len < 0 ? 0 : len] = '\0';
+            if (callsite == nullptr) {
+                size_t textLen = headerLen + strlen(content);
+                AppendValue(buffer_, static_cast<uint8_t>(LogRecordType::TEXT));
+                AppendValue(buffer_, static_cast<uint32_t>(textLen + 1));
+                buffer_.append(text, textLen);
+                buffer_.push_back('\n');
+            } else {
+                AppendValue(buffer_, static_cast<uint8_t>(LogRecordType::RENDERED));
+                AppendValue(buffer_, callsite->id);
+                AppendValue(buffer_, timeUs);
+                AppendValue(buffer_, static_cast<uint32_t>(entity.threadId));
+                AppendStr16(buffer_, content);
+            }
+        } else {
+            AppendValue(buffer_, static_cast<uint8_t>(LogRecordType::FORMAT));
+            AppendValue(buffer_, callsite->id);
+            AppendValue(buffer_, timeUs);
+            AppendValue(buffer_, static_cast<uint32_t>(entity.threadId));
+            AppendArgs(buffer_, callsite->argTypes, args);
+        }
+        needFlush = NeedFlush(entity.level);
+    }
+    if (needFlush) {
+        Flush();
+    }
+}
+
+const LogSinkBinary::Callsite *LogSinkBinary::GetCallsite(const LogEntity &entity, const char *format)
+{
+    CallsiteKey key{format, entity.fileName, entity.line};
+    auto it = callsites_.find(key);
+    if (it != callsites_.end()) {
+        return &it->second;
+    }
+    if (callsites_.size() >= MAX_CALLSITE_COUNT) {
+        return nullptr;
+    }
+
+    Callsite &callsite = callsites_[key];
+    callsite.id = static_cast<uint32_t>(callsites_.size() - 1);
+    callsite.encodable = ParseFormatArgs(format, callsite.argTypes);
+    if (!callsite.encodable) {
+        callsite.argTypes.clear();
+    }
+
+    std::string def;
+    AppendValue(def, static_cast<uint8_t>(LogRecordType::CALLSITE));
+    AppendValue(def, callsite.id);
+    AppendValue(def, static_cast<uint8_t>(entity.level));
+    AppendValue(def, static_cast<uint32_t>(entity.line));
+    AppendStr16(def, entity.fileName);
+    AppendStr16(def, entity.funcName);
+    AppendStr16(def, format);
+    AppendValue(def, static_cast<uint8_t>(callsite.argTypes.size()));
+    for (uint8_t argType : callsite.argTypes) {
+        AppendValue(def, static_cast<uint8_t>(argType & ~LONG_DOUBLE_FLAG));
+    }
+    buffer_.append(def);
+    std::lock_guard<std::mutex> defsLock(defsMutex_);
+    defs_.append(def);
+    defCount_++;
+    return &callsite;
+}
+
+bool LogSinkBinary::NeedFlush(LogLevel level)
+{
+    if (buffer_.size() >= bufferSize_ || level >= LogLevel::ERROR) {
+        return true;
+    }
+    int64_t nowMs = GetLogSteadyTimeMs();
+    if (lastFlushMs_ == 0) {
+        lastFlushMs_ = nowMs;
+    }
+    return nowMs - lastFlushMs_ >= FLUSH_INTERVAL_MS;
+}
+
+void LogSinkBinary::Flush()
+{
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastFlushMs_ = GetLogSteadyTimeMs();
+        if (buffer_.empty()) {
+            return;
+        }
+        writeBuffer_.swap(buffer_);
+    }
+    output_->Log(writeBuffer_.data(), writeBuffer_.size());
+    writeBuffer_.clear();
+}
+
+std::string LogSinkBinary::GetFileHeader() const
+{
+    std::string header(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+    AppendValue(header, BINARY_LOG_VERSION);
+    std::lock_guard<std::mutex> defsLock(defsMutex_);
+    header.append(defs_);
+    return header;
+}
+
+size_t LogSinkBinary::GetCallsiteCount() const
+{
+    std::lock_guard<std::mutex> defsLock(defsMutex_);
+    return defCount_;
+}
+} // namespace Mki
@@ -13,6 +13,10 @@
 #include <string>
 #include <cstdlib>
 #include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <chrono>
+#include <algorithm>
 #include <unistd.h>
 #include <syscall.h>
 #include <sstream>
@@ -25,15 +29,49 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <sys/statvfs.h>
+#include <sys/uio.h>
 #include <securec.h>
 #include "mki/utils/log/log_core.h"
+#include "mki/utils/log/log_rate_limiter.h"
 #include "mki/utils/env/env.h"
 
 namespace Mki {
-constexpr size_t MAX_LOG_FILE_COUNT = 50;                               // 50 回滚管理50个日志文件
-constexpr size_t MAX_FILE_NAME_LEN = 128;                                  // 128: max file length
-constexpr uint64_t MAX_FILE_SIZE_THRESHOLD = 1073741824;                // 1073741824 当前单个日志文件最大1G
-constexpr uint64_t DISK_AVAILABEL_LIMIT = 10 * MAX_FILE_SIZE_THRESHOLD; // 磁盘剩余空间门限10G
+constexpr size_t DEFAULT_MAX_LOG_FILE_COUNT = 50;                       // 50 默认回滚管理50个日志文件
+constexpr size_t MAX_FILE_NAME_LEN = 128;                               // 128: max file length
+constexpr uint64_t MB_SIZE = 1048576;                                   // 1048576: bytes of 1MB
+constexpr uint64_t DEFAULT_MAX_FILE_SIZE_MB = 1024;                     // 1024 默认单个日志文件最大1G
+constexpr uint64_t MAX_FILE_SIZE_MB = 1048576;                          // 1048576 单个日志文件最大1T
+constexpr uint64_t DISK_AVAILABEL_LIMIT = 10 * 1024 * MB_SIZE;          // 磁盘剩余空间门限10G
+constexpr int64_t MAINTAIN_INTERVAL_MS = 10000;                         // 10000 至少每10s刷新一次磁盘剩余空间
+constexpr int MAX_CREATE_FILE_RETRY = 10;
+
+static uint64_t GetUintFromEnv(const char *name, uint64_t defaultValue)
+{
+    const char *env = std::getenv(name);
+    if (env == nullptr || strlen(env) > MAX_ENV_STRING_LEN) {
+        return defaultValue;
+    }
+    char *end = nullptr;
+    unsigned long long value = std::strtoull(env, &end, 10); // 10: decimal
+    return (end == env || *end != '\0') ? defaultValue : value;
+}
+
+// file name time stamp YYYYmmddHHMMSSsss
+static uint64_t GetFileTimeStamp()
+{
+    std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+    std::time_t tmpTime = std::chrono::system_clock::to_time_t(now);
+    struct tm nowTime;
+    localtime_r(&tmpTime, &nowTime);
+    uint64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    uint64_t stamp = static_cast<uint64_t>(nowTime.tm_year + 1900); // 1900: base year of tm
+    stamp = stamp * 100 + static_cast<uint64_t>(nowTime.tm_mon + 1); // 100: two digits
+    stamp = stamp * 100 + static_cast<uint64_t>(nowTime.tm_mday);   // 100: two digits
+    stamp = stamp * 100 + static_cast<uint64_t>(nowTime.tm_hour);   // 100: two digits
+    stamp = stamp * 100 + static_cast<uint64_t>(nowTime.tm_min);    // 100: two digits
+    stamp = stamp * 100 + static_cast<uint64_t>(nowTime.tm_sec);    // 100: two digits
+    return stamp * 1000 + ms;                                       // 1000: three digits
+}
 
 static bool IsValidFileName(const char *name)
 {
@@ -108,22 +146,90 @@ static std::string PathCheckAndRegular(const std::string &path)
     return res;
 }
 
-LogSinkFile::LogSinkFile() { Init(); }
+LogSinkFile::LogSinkFile(const std::string &fileSuffix) : fileSuffix_(fileSuffix) { Init(); }
 
-LogSinkFile::~LogSinkFile() { CloseFile(); }
+LogSinkFile::~LogSinkFile()
+{
+    {
+        std::lock_guard<std::mutex> lock(maintainMutex_);
+        stopMaintain_ = true;
+    }
+    maintainCond_.notify_all();
+    if (maintainThread_.joinable()) {
+        maintainThread_.join();
+    }
+    CloseFile();
+    if (spareFd_ >= 0) {
+        close(spareFd_);
+        remove(spareFilePath_.c_str());
+        spareFd_ = -1;
+    }
+    if (!fileIndex_.empty()) {
+        ScanLogDir();
+        DeleteOldestFile();
+    }
+}
 
-void LogSinkFile::Log(const char *log, uint64_t logLen)
+void LogSinkFile::SetFileHeaderGenerator(std::function<std::string()> generator)
 {
     std::lock_guard<std::mutex> guard(mutex_);
-    if (currentFileSize_ + logLen >= MAX_FILE_SIZE_THRESHOLD) {
-        CloseFile();
+    fileHeaderGenerator_ = std::move(generator);
+}
+
+void LogSinkFile::SetPeriodicTask(std::function<void()> task, int64_t intervalMs)
+{
+    {
+        std::lock_guard<std::mutex> taskLock(periodicTaskMutex_);
+        periodicTask_ = std::move(task);
+        periodicIntervalMs_ = periodicTask_ ? std::max<int64_t>(intervalMs, 1) : 0;
+    }
+    if (periodicIntervalMs_ > 0) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!maintainThread_.joinable()) {
+            MakeLogDir();
+            UpdateDiskAvailable();
+            StartMaintainThread();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(maintainMutex_);
+        maintainRequested_ = true; // wake up the thread to pick up the new interval
+    }
+    maintainCond_.notify_one();
+}
+
+void LogSinkFile::SetRotation(uint64_t maxFileSize, size_t maxFileCount)
+{
+    if (maxFileSize > 0) {
+        maxFileSize_ = maxFileSize;
+    }
+    if (maxFileCount > 0) {
+        maxFileCount_ = maxFileCount;
+    }
+    {
+        std::lock_guard<std::mutex> lock(maintainMutex_);
+        maintainRequested_ = true;
+    }
+    maintainCond_.notify_one();
+}
+
+bool LogSinkFile::PrepareFile(uint64_t logLen)
+{
+    if (currentFd_ >= 0 && currentFileSize_ + logLen >= maxFileSize_) {
+        SwapToSpareFile();
     }
 
     if (currentFd_ < 0) {
         OpenFile();
     }
 
-    if (currentFd_ < 0) {
+    return currentFd_ >= 0;
+}
+
+void LogSinkFile::Log(const char *log, uint64_t logLen)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!PrepareFile(logLen)) {
         return;
     }
 
@@ -136,8 +242,35 @@ void LogSinkFile::Log(const char *log, uint64_t logLen)
     }
 
     currentFileSize_ += writeSize;
+    writtenSinceStat_.fetch_add(writeSize, std::memory_order_relaxed);
+}
+
+void LogSinkFile::LogBatch(const struct iovec *iov, int iovCnt)
+{
+    uint64_t logLen = 0;
+    for (int i = 0; i < iovCnt; ++i) {
+        logLen += iov[i].iov_len;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!PrepareFile(logLen)) {
+        return;
+    }
+
+    ssize_t writeSize = writev(currentFd_, iov, iovCnt);
+    if (writeSize != static_cast<ssize_t>(logLen)) {
+        std::cout << "mki_log writev file fail, want to write size: " << logLen
+                  << ", success write size:" << writeSize;
+        CloseFile();
+        return;
+    }
+
+    currentFileSize_ += writeSize;
+    writtenSinceStat_.fetch_add(writeSize, std::memory_order_relaxed);
 }
 
+int LogSinkFile::GetCrashFd() const { return crashFd_.load(); }
+
 void LogSinkFile::Init()
 {
     const char *env = std::getenv("ASDOPS_LOG_TO_BOOST_TYPE");
@@ -152,11 +285,163 @@ void LogSinkFile::Init()
 
     env = std::getenv("ASDOPS_LOG_TO_FILE_FLUSH");
     isFlush_ = env && strlen(env) <= MAX_ENV_STRING_LEN ? std::string(env) == "1" : false;
+
+    uint64_t maxFileSizeMb = GetUintFromEnv("ASDOPS_LOG_MAX_FILE_SIZE", DEFAULT_MAX_FILE_SIZE_MB);
+    if (maxFileSizeMb == 0 || maxFileSizeMb > MAX_FILE_SIZE_MB) {
+        maxFileSizeMb = DEFAULT_MAX_FILE_SIZE_MB;
+    }
+    maxFileSize_ = maxFileSizeMb * MB_SIZE;
+    uint64_t maxFileCount = GetUintFromEnv("ASDOPS_LOG_MAX_FILE_COUNT", DEFAULT_MAX_LOG_FILE_COUNT);
+    maxFileCount_ = maxFileCount == 0 ? DEFAULT_MAX_LOG_FILE_COUNT : static_cast<size_t>(maxFileCount);
 }
 
-void LogSinkFile::DeleteOldestFile()
+void LogSinkFile::OpenFile()
+{
+    if (!maintainThread_.joinable()) {
+        MakeLogDir();
+        UpdateDiskAvailable();
+        StartMaintainThread();
+    }
+
+    if (!IsDiskAvailable()) {
+        return;
+    }
+
+    std::string logFilePath;
+    int fd = CreateLogFile(logFilePath);
+    if (fd < 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(maintainMutex_);
+        fileIndex_.push_back(logFilePath);
+        maintainRequested_ = true;
+    }
+    maintainCond_.notify_one();
+    currentFd_ = fd;
+    crashFd_.store(fd);
+    WriteFileHeader();
+}
+
+void LogSinkFile::SwapToSpareFile()
 {
-    std::string regStr = boostType_ + "_\\d+_(\\d+).log";
+    CloseFile();
+    if (!IsDiskAvailable()) {
+        return;
+    }
+
+    int fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(maintainMutex_);
+        fd = spareFd_;
+        if (fd >= 0) {
+            fileIndex_.push_back(spareFilePath_);
+            spareFd_ = -1;
+        }
+        maintainRequested_ = true;
+    }
+    maintainCond_.notify_one();
+    if (fd < 0) {
+        return; // the maintenance thread has not prepared a spare file yet, PrepareFile opens one
+    }
+    currentFd_ = fd;
+    crashFd_.store(fd);
+    WriteFileHeader();
+}
+
+void LogSinkFile::WriteFileHeader()
+{
+    if (!fileHeaderGenerator_) {
+        return;
+    }
+    std::string header = fileHeaderGenerator_();
+    ssize_t writeSize = write(currentFd_, header.data(), header.size());
+    if (writeSize != static_cast<ssize_t>(header.size())) {
+        std::cout << "mki_log write file header fail" << std::endl;
+        CloseFile();
+        return;
+    }
+    currentFileSize_ += writeSize;
+    writtenSinceStat_.fetch_add(writeSize, std::memory_order_relaxed);
+}
+
+int LogSinkFile::CreateLogFile(std::string &filePath)
+{
+    for (int i = 0; i < MAX_CREATE_FILE_RETRY; ++i) {
+        filePath = GetNewLogFilePath();
+        int fd = open(filePath.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP);
+        if (fd >= 0) {
+            return fd;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+    std::cout << "mki_log open " << filePath << " fail" << std::endl;
+    return -1;
+}
+
+std::string LogSinkFile::GetNewLogFilePath()
+{
+    uint64_t stamp = GetFileTimeStamp();
+    {
+        // file names of one process are strictly increasing even if files are rotated within a millisecond
+        std::lock_guard<std::mutex> lock(maintainMutex_);
+        stamp = std::max(stamp, lastFileStamp_ + 1);
+        lastFileStamp_ = stamp;
+    }
+    return logDir_ + "/" + boostType_ + "_" + std::to_string(syscall(SYS_getpid)) + "_" + std::to_string(stamp) +
+           fileSuffix_;
+}
+
+void LogSinkFile::StartMaintainThread()
+{
+    maintainThread_ = std::thread([this]() { MaintainThread(); });
+}
+
+void LogSinkFile::MaintainThread()
+{
+    int64_t lastMaintainMs = 0;
+    std::unique_lock<std::mutex> lock(maintainMutex_);
+    while (!stopMaintain_) {
+        int64_t nowMs = GetLogSteadyTimeMs();
+        bool maintain = maintainRequested_ || lastMaintainMs == 0 || nowMs - lastMaintainMs >= MAINTAIN_INTERVAL_MS;
+        maintainRequested_ = false;
+        lock.unlock();
+        if (maintain) {
+            ScanLogDir();
+            UpdateDiskAvailable();
+            DeleteOldestFile();
+            PrepareSpareFile();
+            lastMaintainMs = nowMs;
+        }
+        {
+            std::lock_guard<std::mutex> taskLock(periodicTaskMutex_);
+            if (periodicTask_) {
+                periodicTask_();
+            }
+        }
+        lock.lock();
+        int64_t intervalMs = periodicIntervalMs_ > 0 ? std::min(periodicIntervalMs_.load(), MAINTAIN_INTERVAL_MS)
+                                                     : MAINTAIN_INTERVAL_MS;
+        maintainCond_.wait_for(lock, std::chrono::milliseconds(intervalMs),
+                               [this]() { return stopMaintain_ || maintainRequested_; });
+    }
+}
+
+// files left by earlier processes are found by one directory scan, later files are tracked in fileIndex_
+void LogSinkFile::ScanLogDir()
+{
+    if (logDirScanned_) {
+        return;
+    }
+    logDirScanned_ = true;
+
+    std::string suffix;
+    for (char c : fileSuffix_) {
+        suffix += (c == '.') ? "\\." : std::string(1, c);
+    }
+    std::string regStr = boostType_ + "_\\d+_(\\d+)" + suffix;
     const std::regex reg(regStr);
 
     std::vector<std::pair<std::string, std::string>> logFiles;
@@ -182,59 +467,78 @@ void LogSinkFile::DeleteOldestFile()
                   return a.second < b.second;
               });
 
-    if (logFiles.size() > MAX_LOG_FILE_COUNT) {
-        size_t deleteCount = logFiles.size() - MAX_LOG_FILE_COUNT;
-        for (size_t i = 0; i < deleteCount; ++i) {
-            std::cout << "mki_log delete old file:" << logFiles[i].first << std::endl;
-            remove(logFiles[i].first.c_str());
+    // files of this process are already in fileIndex_ or being added by the logging thread
+    std::string ownPrefix = logDir_ + "/" + boostType_ + "_" + std::to_string(syscall(SYS_getpid)) + "_";
+    std::lock_guard<std::mutex> lock(maintainMutex_);
+    for (auto it = logFiles.rbegin(); it != logFiles.rend(); ++it) {
+        if (it->first.compare(0, ownPrefix.size(), ownPrefix) != 0) {
+            fileIndex_.push_front(it->first);
         }
     }
 }
 
-void LogSinkFile::OpenFile()
+void LogSinkFile::DeleteOldestFile()
 {
-    MakeLogDir();
-
-    DeleteOldestFile();
-
-    if (!IsDiskAvailable()) {
-        return;
+    std::vector<std::string> deleteFiles;
+    {
+        std::lock_guard<std::mutex> lock(maintainMutex_);
+        while (fileIndex_.size() > maxFileCount_) {
+            deleteFiles.push_back(fileIndex_.front());
+            fileIndex_.pop_front();
+        }
     }
-
-    std::string logFilePath = GetNewLogFilePath();
-    currentFd_ = open(logFilePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP);
-    if (currentFd_ < 0) {
-        std::cout << "mki_log open " << logFilePath << " fail" << std::endl;
+    for (const std::string &filePath : deleteFiles) {
+        std::cout << "mki_log delete old file:" << filePath << std::endl;
+        remove(filePath.c_str());
     }
 }
 
-std::string LogSinkFile::GetNewLogFilePath()
+void LogSinkFile::PrepareSpareFile()
 {
-    std::time_t tmpTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    struct tm *nowTime = std::localtime(&tmpTime);
+    {
+        std::lock_guard<std::mutex> lock(maintainMutex_);
+        if (spareFd_ >= 0) {
+            return;
+        }
+    }
+    if (!IsDiskAvailable()) {
+        return;
+    }
 
-    std::stringstream filePath;
-    filePath << logDir_ << "/" << boostType_ << "_" << std::to_string(syscall(SYS_getpid)) << "_"
-             << std::put_time(nowTime, "%Y%m%d%H%M%S") << ".log";
-    return filePath.str();
+    std::string filePath;
+    int fd = CreateLogFile(filePath);
+    if (fd < 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(maintainMutex_);
+    spareFd_ = fd;
+    spareFilePath_ = filePath;
 }
 
-bool LogSinkFile::IsDiskAvailable()
+void LogSinkFile::UpdateDiskAvailable()
 {
     struct statvfs vfs;
     if (statvfs(logDir_.c_str(), &vfs) == -1) {
         std::cout << "mki_log get current disk stats fail" << std::endl;
-        return false;
+        availableSize_ = 0;
+        return;
     }
 
     uint64_t availableSize = vfs.f_bsize * vfs.f_bfree;
     if (availableSize <= DISK_AVAILABEL_LIMIT) {
         std::cout << "mki_log disk available space it too low, available size:" << availableSize
                   << ", limit size:" << DISK_AVAILABEL_LIMIT << std::endl;
-        return false;
     }
+    availableSize_ = availableSize;
+    writtenSinceStat_ = 0;
+}
 
-    return true;
+// estimated by the last statvfs minus the bytes written since then
+bool LogSinkFile::IsDiskAvailable()
+{
+    uint64_t availableSize = availableSize_.load(std::memory_order_relaxed);
+    uint64_t writtenSize = writtenSinceStat_.load(std::memory_order_relaxed);
+    return availableSize > writtenSize && availableSize - writtenSize > DISK_AVAILABEL_LIMIT;
 }
 
 void LogSinkFile::MakeLogDir()
@@ -264,6 +568,7 @@ void LogSinkFile::MakeLogDir()
 void LogSinkFile::CloseFile()
 {
     if (currentFd_ > 0) {
+        crashFd_.store(-1);
         (void)fchmod(currentFd_, S_IRUSR | S_IRGRP);
         close(currentFd_);
         currentFd_ = -1;
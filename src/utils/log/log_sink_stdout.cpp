@@ -12,6 +12,7 @@
 #include "mki/utils/log/log_sink_stdout.h"
 #include <iostream>
 #include <iomanip>
+#include <unistd.h>
 
 namespace Mki {
 void LogSinkStdout::Log(const char *log, uint64_t logLen)
@@ -19,4 +20,6 @@ void LogSinkStdout::Log(const char *log, uint64_t logLen)
     std::lock_guard<std::mutex> guard(mtx_);
     std::cout << log;
 }
+
+int LogSinkStdout::GetCrashFd() const { return STDOUT_FILENO; }
 } // namespace Mki
@@ -14,6 +14,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
 #include <ctime>
 #include <cstdarg>
 #include <unistd.h>
@@ -24,6 +25,24 @@
 namespace Mki {
 thread_local std::ostringstream g_stream;
 
+constexpr int MICRO_SECOND = 1000000;
+constexpr int MICRO_SECOND_WIDTH = 6;
+constexpr size_t MAX_UINT_LEN = 20;
+
+// time prefix is reformatted once per second, thread id and level parts are formatted once
+struct LogHeaderCache {
+    int64_t second = -1;
+    char timePrefix[32] = {0}; // 32: "[YYYY-mm-dd HH:MM:SS."
+    size_t timePrefixLen = 0;
+    char threadIdStr[32] = {0}; // 32: "] [<tid>] ["
+    size_t threadIdStrLen = 0;
+};
+
+thread_local LogHeaderCache g_headerCache;
+
+static const char *LEVEL_PREFIXES[] = {"] [trace] [", "] [debug] [", "] [info] [",
+                                       "] [warn] [",  "] [error] [", "] [fatal] ["};
+
 thread_local long g_threadId = -1;
 long GetThreadId()
 {
@@ -33,6 +52,47 @@ long GetThreadId()
     return g_threadId;
 }
 
+static size_t FormatUint(char *buf, uint64_t value, size_t minWidth = 0)
+{
+    char digits[MAX_UINT_LEN];
+    size_t len = 0;
+    do {
+        digits[len++] = static_cast<char>('0' + value % 10); // 10: decimal
+        value /= 10; // 10: decimal
+    } while (value != 0 && len < MAX_UINT_LEN);
+    size_t pos = 0;
+    for (; pos + len < minWidth; ++pos) {
+        buf[pos] = '0';
+    }
+    while (len > 0) {
+        buf[pos++] = digits[--len];
+    }
+    return pos;
+}
+
+static size_t AppendStr(char *buf, size_t bufLen, size_t pos, const char *str, size_t len)
+{
+    if (pos >= bufLen) {
+        return pos;
+    }
+    len = std::min(len, bufLen - pos);
+    (void)memcpy_s(buf + pos, bufLen - pos, str, len);
+    return pos + len;
+}
+
+static void UpdateHeaderCache(LogHeaderCache &cache, int64_t second)
+{
+    std::time_t tmpTime = static_cast<std::time_t>(second);
+    struct tm timeinfo;
+    localtime_r(&tmpTime, &timeinfo);
+    cache.timePrefixLen = strftime(cache.timePrefix, sizeof(cache.timePrefix), "[%Y-%m-%d %H:%M:%S.", &timeinfo);
+    cache.second = second;
+    if (cache.threadIdStrLen == 0) {
+        size_t len = FormatUint(cache.threadIdStr, static_cast<uint64_t>(GetThreadId()));
+        cache.threadIdStrLen = AppendStr(cache.threadIdStr, sizeof(cache.threadIdStr), len, "] [", 3); // 3: length of "] ["
+    }
+}
+
 LogStream::LogStream(const char *filePath, int line, const char *funcName, LogLevel level) : stream_(g_stream)
 {
     if (filePath != nullptr && funcName != nullptr) {
@@ -44,51 +104,83 @@ LogStream::LogStream(const char *filePath, int line, const char *funcName, LogLe
         logEntity_.funcName = funcName;
         logEntity_.line = line;
     }
+}
 
-    constexpr int microSecond = 1000000;
-    int us = std::chrono::duration_cast<std::chrono::microseconds>(
-        logEntity_.time.time_since_epoch()).count() % microSecond;
-    std::time_t tmpTime = std::chrono::system_clock::to_time_t(logEntity_.time);
-    struct tm timeinfo;
-    localtime_r(&tmpTime, &timeinfo);
-    char timeStr[64] = {0}; // 64 日志buffer长度
-    (void)strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &timeinfo);
-    std::string fileName = (logEntity_.fileName != nullptr) ? logEntity_.fileName : "EmptyFile";
+size_t FormatLogHeader(const LogEntity &entity, char *buf, size_t bufLen)
+{
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(entity.time.time_since_epoch()).count();
+    LogHeaderCache &cache = g_headerCache;
+    if (us / MICRO_SECOND != cache.second) {
+        UpdateHeaderCache(cache, us / MICRO_SECOND);
+    }
+
+    char number[MAX_UINT_LEN];
+    size_t pos = AppendStr(buf, bufLen, 0, cache.timePrefix, cache.timePrefixLen);
+    size_t numberLen = FormatUint(number, static_cast<uint64_t>(us % MICRO_SECOND), MICRO_SECOND_WIDTH);
+    pos = AppendStr(buf, bufLen, pos, number, numberLen);
+    size_t levelIdx = static_cast<size_t>(entity.level);
+    const char *levelPrefix =
+        levelIdx < sizeof(LEVEL_PREFIXES) / sizeof(LEVEL_PREFIXES[0]) ? LEVEL_PREFIXES[levelIdx] : "] [unknown] [";
+    pos = AppendStr(buf, bufLen, pos, levelPrefix, strlen(levelPrefix));
+    pos = AppendStr(buf, bufLen, pos, cache.threadIdStr, cache.threadIdStrLen);
+
+    const char *fileName = (entity.fileName != nullptr) ? entity.fileName : "EmptyFile";
+    pos = AppendStr(buf, bufLen, pos, fileName, strlen(fileName));
+    pos = AppendStr(buf, bufLen, pos, ":", 1);
+    numberLen = FormatUint(number, static_cast<uint64_t>(entity.line));
+    pos = AppendStr(buf, bufLen, pos, number, numberLen);
+    return AppendStr(buf, bufLen, pos, "] ", 2); // 2: length of "] "
+}
+
+void LogStream::WriteHeader()
+{
+    char header[MAX_LOG_HEADER_LEN];
+    size_t headerLen = FormatLogHeader(logEntity_, header, sizeof(header));
     stream_.str("");
-    stream_ << "[" << timeStr << "." << us << "] [" << LogLevelToString(logEntity_.level) << "] ["
-            << logEntity_.threadId << "] [" << fileName << ":" << logEntity_.line << "] ";
+    stream_.write(header, headerLen);
+    headerWritten_ = true;
 }
 
 void LogStream::Format(const char *format, ...)
 {
     useStream_ = false;
-    std::string logHead = stream_.str();
-    const int logContentSize = 1024; // 1024 日志内容最大支持1024
-    const int logBufferSize = logHead.size() + logContentSize;
-    char logBuffer[logBufferSize + 1] = {0};
-
-    int ret = memcpy_s(logBuffer, logBufferSize, logHead.c_str(), logHead.size());
-    if (ret != 0) {
-        std::cout << "mki_log memcpy_s fail, error:" << ret << std::endl;
+    LogCore &logCore = LogCore::Instance();
+    if (!logCore.AcquireLogToken()) {
         return;
     }
+    if (logCore.HasStructuredSink()) {
+        va_list args;
+        va_start(args, format);
+        logCore.LogStructured(logEntity_, format, args);
+        va_end(args);
+    }
+    if (!logCore.HasTextSink()) {
+        return;
+    }
+
+    const size_t logContentSize = 1024; // 1024 日志内容最大支持1024
+    char logBuffer[MAX_LOG_HEADER_LEN + logContentSize + 1] = {0};
+    size_t headerLen = FormatLogHeader(logEntity_, logBuffer, MAX_LOG_HEADER_LEN);
 
     va_list args;
     va_start(args, format);
-    int logLen = vsnprintf_s(logBuffer + logHead.size(), logContentSize + 1, logContentSize, format, args);
+    int logLen = vsnprintf_s(logBuffer + headerLen, logContentSize + 1, logContentSize, format, args);
     va_end(args);
     if (logLen < 0) {
         std::cout << "mki_log vsnprintf_s fail" << std::endl;
         return;
     }
 
-    logBuffer[logHead.size() + logLen] = '\n';
-    LogCore::Instance().Log(logBuffer, logHead.size() + logLen + 1);
+    logBuffer[headerLen + logLen] = '\n';
+    logCore.LogText(logBuffer, headerLen + logLen + 1);
 }
 
 LogStream::~LogStream()
 {
     if (useStream_) {
+        if (!headerWritten_) {
+            WriteHeader();
+        }
         stream_ << "\n";
         std::string log = stream_.str();
         LogCore::Instance().Log(log.c_str(), log.size());
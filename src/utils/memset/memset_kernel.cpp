@@ -67,9 +67,10 @@ public:
     {
         uint32_t blockDim = 0;
         uint32_t maxUb = 0;
-        uint32_t coreNum = PlatformInfo::Instance().GetCoreNum(CoreType::CORE_TYPE_VECTOR);
+        const PlatformCaps &caps = PlatformInfo::Instance().GetPlatformCaps();
+        uint32_t coreNum = caps.GetCoreNum(CoreType::CORE_TYPE_VECTOR);
         // leave 20% ub for system
-        uint64_t maxUbSize = static_cast<uint64_t>(PlatformInfo::Instance().GetUbSize() * 0.8);
+        uint64_t maxUbSize = static_cast<uint64_t>(caps.ubSize * 0.8);
         maxUbSize = (maxUbSize + BLOCK_BYTES - 1) / BLOCK_BYTES * BLOCK_BYTES; // align to 32
         for (size_t i = 0; i < MEMSET_MAX_TENSOR_NUM && i < memsetInfo.size(); ++i) {
             uint64_t size = (memsetInfo[i].size + BLOCK_BYTES - 1) / BLOCK_BYTES * BLOCK_BYTES;
@@ -133,30 +134,30 @@ public:
 static MemsetKernel *MemsetInit()
 {
     std::string kernelName = "MemsetKernel";
-    auto &binaryMap = OpSpace::KernelBinaryRegister::GetKernelBinaryMap();
-    auto it = binaryMap.find(kernelName);
-    MKI_CHECK(it != binaryMap.end(), "get memset kernel binary info fail", return nullptr);
     std::string deviceVersion = PlatformInfo::Instance().GetPlatformName();
-    auto &binarys = it->second;
-    const BinaryBasicInfo *binaryBasicInfo = nullptr;
-    for (size_t i = 0; i < binarys.size(); i++) {
-        if (binarys.at(i).targetSoc == deviceVersion) { binaryBasicInfo = &binarys.at(i); }
-    }
+    const BinaryBasicInfo *binaryBasicInfo = OpSpace::KernelBinaryRegister::FindKernelBinary(deviceVersion, kernelName);
     MKI_CHECK(binaryBasicInfo != nullptr, "get memset kernel binary info fail", return nullptr);
     static BinHandle binHandle(binaryBasicInfo);
     MKI_CHECK(binHandle.Init(kernelName), "memset init bin handle fail", return nullptr);
     return new MemsetKernel(kernelName, &binHandle);
 }
 
-Status ClearTensors(void **args, uint64_t argsNum, const MiniVector<KernelInfo::MemsetInfo> &memsetInfo, void *stream)
+static MemsetKernel *GetMemsetKernel()
 {
     static std::once_flag initedFlag;
     static MemsetKernel* memsetKernel = nullptr;
 
     std::call_once(initedFlag, [&]() { memsetKernel = MemsetInit(); });
+    return memsetKernel;
+}
 
+bool HasMemsetKernel() { return GetMemsetKernel() != nullptr; }
+
+Status ClearTensors(void **args, uint64_t argsNum, const MiniVector<KernelInfo::MemsetInfo> &memsetInfo, void *stream)
+{
+    MemsetKernel *memsetKernel = GetMemsetKernel();
     if (memsetKernel == nullptr) {
-        MKI_LOG(WARN) << "memset kernel is null, use aclrtmemset instead!";
+        MKI_LOG_FIRST_N(WARN, 1) << "memset kernel is null, use aclrtmemset instead!";
         for (size_t i = 0; i < MEMSET_MAX_TENSOR_NUM && i < memsetInfo.size() && i < argsNum; ++i) {
             void *zeroTensor = args[memsetInfo[i].argIdx];
             auto aclRet = aclrtMemset(zeroTensor, memsetInfo[i].size, 0, memsetInfo[i].size);
@@ -58,6 +58,11 @@ void PlatformInfo::Init()
 
     (void)platformConfigs_.GetPlatformSpec("version", "Short_SoC_version", platformName_);
     const auto it = supportedPlatform.find(platformName_);
+    // the caps only need the configs, an unsupported soc still reports its core num and memory sizes
+    ParsePlatformCaps(platformConfigs_, it == supportedPlatform.cend() ? platformType_ : it->second.first, caps_);
+    MKI_LOG(INFO) << "PlatformInfo caps: core num " << caps_.coreNum[0] << "/" << caps_.coreNum[1] << ", l2 size "
+                  << caps_.l2Size << ", l1 size " << caps_.l1Size << ", ub size " << caps_.ubSize
+                  << ", support l0c2out " << caps_.supportL0c2out;
     if (it == supportedPlatform.cend()) {
         MKI_LOG(ERROR) << "Unsupport soc";
         platformName_ = "unrecognized";
@@ -71,87 +76,63 @@ void PlatformInfo::Init()
 
 bool PlatformInfo::Inited() const { return inited_; }
 
-uint32_t PlatformInfo::GetCoreNum(CoreType type)
+static uint32_t GetSpecUint(PlatformConfigs &platformConfigs, const std::string &label, const std::string &key)
 {
-    uint32_t coreNum = 0;
-    if (platformType_ == PlatformType::ASCEND_910B || platformType_ == PlatformType::ASCEND_910D) {
-        switch (type) {
-            case CoreType::CORE_TYPE_VECTOR:
-                coreNum = platformConfigs_.GetCoreNumByType("VectorCore");
-                break;
-            default:
-                coreNum = platformConfigs_.GetCoreNumByType("AiCore");
-                break;
-        }
-    } else {
-        coreNum = platformConfigs_.GetCoreNumByType("AiCore");
+    std::string value;
+    if (!platformConfigs.GetPlatformSpec(label, key, value)) {
+        return 0;
     }
-    MKI_FLOG_INFO("Platform get core num %u, type %d", coreNum, type);
-    return coreNum;
+    return static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)); // 10 进制
 }
 
-uint64_t PlatformInfo::GetL2Size()
+void ParsePlatformCaps(PlatformConfigs &platformConfigs, PlatformType platformType, PlatformCaps &caps)
 {
-    uint64_t memSize = 0;
-    platformConfigs_.GetLocalMemSize(LocalMemType::L2, memSize);
-    MKI_LOG(INFO) << "PlatformInfo get l2 size " << memSize;
-    return memSize;
+    caps = PlatformCaps();
+    caps.platformType = platformType;
+    caps.aiCoreNum = platformConfigs.GetCoreNumByType("AiCore");
+    caps.cubeCoreNum = GetSpecUint(platformConfigs, "SoCInfo", "cube_core_cnt");
+    caps.vectorCoreNum = GetSpecUint(platformConfigs, "SoCInfo", "vector_core_cnt");
+    caps.coreNum[static_cast<int>(CoreType::CORE_TYPE_CUBE)] = caps.aiCoreNum;
+    bool hasVectorCore = platformType == PlatformType::ASCEND_910B || platformType == PlatformType::ASCEND_910D;
+    caps.coreNum[static_cast<int>(CoreType::CORE_TYPE_VECTOR)] =
+        hasVectorCore ? platformConfigs.GetCoreNumByType("VectorCore") : caps.aiCoreNum;
+
+    platformConfigs.GetLocalMemSize(LocalMemType::L2, caps.l2Size);
+    platformConfigs.GetLocalMemSize(LocalMemType::L1, caps.l1Size);
+    platformConfigs.GetLocalMemSize(LocalMemType::L0_A, caps.l0ASize);
+    platformConfigs.GetLocalMemSize(LocalMemType::L0_B, caps.l0BSize);
+    platformConfigs.GetLocalMemSize(LocalMemType::L0_C, caps.l0CSize);
+    platformConfigs.GetLocalMemSize(LocalMemType::UB, caps.ubSize);
+    platformConfigs.GetLocalMemSize(LocalMemType::HBM, caps.hbmSize);
+
+    std::string value;
+    caps.supportL0c2out =
+        platformConfigs.GetPlatformSpec("AICoreintrinsicDtypeMap", "Intrinsic_fix_pipe_l0c2out", value) &&
+        !value.empty();
+    value.clear();
+    caps.supportFixpipe = (platformConfigs.GetPlatformSpec("AICoreSpec", "support_fixpipe", value) && value == "1") ||
+                          !platformConfigs.GetFixPipeDtypeMap().empty();
+    value.clear();
+    caps.cubeVectorSplit = platformConfigs.GetPlatformSpec("SoCInfo", "cube_vector_combine", value) && value == "split";
 }
 
-uint64_t PlatformInfo::GetL1Size()
-{
-    uint64_t memSize = 0;
-    platformConfigs_.GetLocalMemSize(LocalMemType::L1, memSize);
-    MKI_LOG(INFO) << "PlatformInfo get l1 size " << memSize;
-    return memSize;
-}
+const PlatformCaps &PlatformInfo::GetPlatformCaps() const { return caps_; }
 
-uint64_t PlatformInfo::GetL0ASize()
-{
-    uint64_t memSize = 0;
-    platformConfigs_.GetLocalMemSize(LocalMemType::L0_A, memSize);
-    MKI_LOG(INFO) << "PlatformInfo get l0a size " << memSize;
-    return memSize;
-}
+uint32_t PlatformInfo::GetCoreNum(CoreType type) { return caps_.GetCoreNum(type); }
 
-uint64_t PlatformInfo::GetL0BSize()
-{
-    uint64_t memSize = 0;
-    platformConfigs_.GetLocalMemSize(LocalMemType::L0_B, memSize);
-    MKI_LOG(INFO) << "PlatformInfo get l0b size " << memSize;
-    return memSize;
-}
+uint64_t PlatformInfo::GetL2Size() { return caps_.l2Size; }
 
-uint64_t PlatformInfo::GetL0CSize()
-{
-    uint64_t memSize = 0;
-    platformConfigs_.GetLocalMemSize(LocalMemType::L0_C, memSize);
-    MKI_LOG(INFO) << "PlatformInfo get l0c size " << memSize;
-    return memSize;
-}
+uint64_t PlatformInfo::GetL1Size() { return caps_.l1Size; }
 
-uint64_t PlatformInfo::GetUbSize()
-{
-    uint64_t memSize = 0;
-    platformConfigs_.GetLocalMemSize(LocalMemType::UB, memSize);
-    MKI_LOG(INFO) << "PlatformInfo get ub size " << memSize;
-    return memSize;
-}
+uint64_t PlatformInfo::GetL0ASize() { return caps_.l0ASize; }
 
-bool PlatformInfo::SupportL0c2out() { return GetAicoreIntrinsic("Intrinsic_fix_pipe_l0c2out"); }
+uint64_t PlatformInfo::GetL0BSize() { return caps_.l0BSize; }
 
-bool PlatformInfo::GetAicoreIntrinsic(const std::string &intrinsicName)
-{
-    std::string val;
-    (void)platformConfigs_.GetPlatformSpec("AICoreintrinsicDtypeMap", intrinsicName, val);
-    if (!val.empty()) {
-        MKI_LOG(INFO) << "PlatformInfo get aicore intrinsic " << intrinsicName << " = " << val;
-        return true;
-    } else {
-        MKI_LOG(INFO) << "PlatformInfo get no aicore intrinsic " << intrinsicName;
-        return false;
-    }
-}
+uint64_t PlatformInfo::GetL0CSize() { return caps_.l0CSize; }
+
+uint64_t PlatformInfo::GetUbSize() { return caps_.ubSize; }
+
+bool PlatformInfo::SupportL0c2out() { return caps_.supportL0c2out; }
 
 PlatformType PlatformInfo::GetPlatformType() const { return platformType_; }
 std::string PlatformInfo::GetPlatformName() const { return platformName_; }
@@ -24,6 +24,7 @@
 #include "mki/utils/file_system/file_system.h"
 #include "mki/utils/inifile/ini_file.h"
 #include "mki/utils/env/env.h"
+#include "mki/utils/platform/platform_config_table.h"
 
 namespace Mki {
 std::mutex g_pcLock;
@@ -308,25 +309,60 @@ uint32_t PlatformManager::ParsePlatformInfo(std::map<std::string, std::map<std::
     return PLATFORM_SUCCESS;
 }
 
+uint32_t PlatformManager::LoadBuiltinConfig(const std::string &socVersion)
+{
+    size_t tableCount = 0;
+    const PlatformConfigTable *tables = GetBuiltinPlatformConfigTables(tableCount);
+    for (size_t i = 0; i < tableCount; ++i) {
+        if (socVersion != tables[i].socVersion) {
+            continue;
+        }
+        std::map<std::string, std::map<std::string, std::string>> contentInfoMap;
+        for (size_t j = 0; j < tables[i].itemCount; ++j) {
+            const PlatformConfigItem &item = tables[i].items[j];
+            contentInfoMap[item.label].emplace(item.key, item.value);
+        }
+        MKI_LOG(INFO) << "Load builtin platform config " << tables[i].fileName;
+        return AssemblePlatformInfoVector(contentInfoMap);
+    }
+    return PLATFORM_FAILED;
+}
+
 uint32_t PlatformManager::InitializePlatformManager()
 {
     std::lock_guard<std::mutex> lockGuard(g_pcLock);
     if (initFlag_) {
         return PLATFORM_SUCCESS;
     }
-    const char *mkiHomePath = Mki::GetEnv("ASDOPS_HOME_PATH");
-    if (mkiHomePath == nullptr) {
-        MKI_LOG(ERROR) << "env ASDOPS_HOME_PATH is invalid";
-        return PLATFORM_FAILED;
+    // ini files are only parsed when ASDOPS_PLATFORM_CONFIG_PATH overrides the builtin config
+    const char *configPath = std::getenv("ASDOPS_PLATFORM_CONFIG_PATH");
+    size_t builtinTableCount = 0;
+    (void)GetBuiltinPlatformConfigTables(builtinTableCount);
+    if (configPath == nullptr && builtinTableCount > 0) {
+        useBuiltinConfig_ = true;
+        initFlag_ = true;
+        return PLATFORM_SUCCESS;
     }
-    std::string mkiHomePathStr = mkiHomePath;
-    if (mkiHomePathStr == "") {
-        MKI_LOG(ERROR) << "getenv failed";
-        return PLATFORM_FAILED;
+
+    std::string cfgFilePath;
+    if (configPath != nullptr && strlen(configPath) <= MAX_ENV_STRING_LEN) {
+        cfgFilePath = configPath;
+    } else {
+        const char *mkiHomePath = Mki::GetEnv("ASDOPS_HOME_PATH");
+        if (mkiHomePath == nullptr) {
+            MKI_LOG(ERROR) << "env ASDOPS_HOME_PATH is invalid";
+            return PLATFORM_FAILED;
+        }
+        std::string mkiHomePathStr = mkiHomePath;
+        if (mkiHomePathStr == "") {
+            MKI_LOG(ERROR) << "getenv failed";
+            return PLATFORM_FAILED;
+        }
+        cfgFilePath = mkiHomePathStr + PLATFORM_RELATIVE_PATH;
     }
-    std::string cfgFileRealPath = FileSystem::PathCheckAndRegular(mkiHomePathStr + PLATFORM_RELATIVE_PATH, false);
+    std::string cfgFileRealPath = FileSystem::PathCheckAndRegular(cfgFilePath, false);
     if (cfgFileRealPath.empty()) {
-        MKI_LOG(ERROR) << "File path " << cfgFileRealPath.c_str() << " is not valid";
+        MKI_LOG(ERROR) << "File path " << cfgFilePath.c_str() << " is not valid";
         return PLATFORM_FAILED;
     }
 
@@ -335,6 +371,7 @@ uint32_t PlatformManager::InitializePlatformManager()
         MKI_LOG(ERROR) << "Load cfg file failed, path is " << cfgFileRealPath.c_str();
         return PLATFORM_FAILED;
     }
+    useBuiltinConfig_ = false;
     initFlag_ = true;
     return PLATFORM_SUCCESS;
 }
@@ -345,7 +382,13 @@ uint32_t PlatformManager::GetPlatformConfigs(const std::string socVersion, Platf
     if (realSocVersion == SOC_VERSION_ASCEND910) {
         realSocVersion = SOC_VERSION_ASCEND910A;
     }
+    std::lock_guard<std::mutex> lockGuard(g_pcLock);
     auto iter = platformConfigsMap_.find(realSocVersion);
+    // builtin configs are assembled on first use, only for the soc versions actually queried
+    if (iter == platformConfigsMap_.end() && useBuiltinConfig_ &&
+        LoadBuiltinConfig(realSocVersion) == PLATFORM_SUCCESS) {
+        iter = platformConfigsMap_.find(realSocVersion);
+    }
     if (iter == platformConfigsMap_.end()) {
         MKI_LOG(ERROR) << "Can not found platform_info by socVersion " << realSocVersion.c_str();
         return PLATFORM_FAILED;
@@ -361,6 +404,7 @@ uint32_t PlatformManager::Finalize()
         return PLATFORM_SUCCESS;
     }
     platformConfigsMap_.clear();
+    useBuiltinConfig_ = false;
     initFlag_ = false;
     return PLATFORM_SUCCESS;
 }
@@ -10,12 +10,52 @@
  * See the Mulan PSL v2 for more details.
  */
 #include "mki/utils/rt/backend/backend_factory.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "mki/utils/env/env.h"
 #include "mki/utils/rt/backend/rt_backend.h"
 
 namespace Mki {
-Backend *BackendFactory::GetBackend()
+static Backend *GetRtBackend()
 {
     static RtBackend backend;
     return &backend;
 }
+
+static BackendType GetBackendTypeFromEnv()
+{
+    const char *env = std::getenv("ASDOPS_RT_BACKEND");
+    if (env == nullptr || strlen(env) > MAX_ENV_STRING_LEN) {
+        return BackendType::RT;
+    }
+    return std::string(env) == "mock" ? BackendType::MOCK : BackendType::RT;
+}
+
+static std::atomic<Backend *> &GetCurrentBackend()
+{
+    static std::atomic<Backend *> backend(GetBackendTypeFromEnv() == BackendType::MOCK ?
+        static_cast<Backend *>(BackendFactory::GetMockBackend()) : GetRtBackend());
+    return backend;
+}
+
+Backend *BackendFactory::GetBackend() { return GetCurrentBackend().load(std::memory_order_relaxed); }
+
+void BackendFactory::SetBackendType(BackendType type)
+{
+    GetCurrentBackend() = type == BackendType::MOCK ? static_cast<Backend *>(GetMockBackend()) : GetRtBackend();
+}
+
+BackendType BackendFactory::GetBackendType()
+{
+    return GetBackend() == GetMockBackend() ? BackendType::MOCK : BackendType::RT;
+}
+
+MockBackend *BackendFactory::GetMockBackend()
+{
+    // never destructed, static BinHandles destroy their modules during exit
+    static MockBackend *backend = new MockBackend();
+    return backend;
+}
 }
@@ -0,0 +1,618 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/rt/backend/mock_backend.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "mki/utils/env/env.h"
+#include "mki/utils/log/log.h"
+#include "mki/utils/rt/backend/help_macro.h"
+
+namespace Mki {
+constexpr const char *MOCK_DEFAULT_SOC_VERSION = "Ascend910B4";
+
+static uint64_t GetSteadyTimeNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+MockBackend::MockBackend()
+{
+    const char *env = std::getenv("ASDOPS_MOCK_SOC_VERSION");
+    socVersion_ = env != nullptr && strlen(env) <= MAX_ENV_STRING_LEN ? env : MOCK_DEFAULT_SOC_VERSION;
+    MKI_LOG(INFO) << "mock backend is created, soc version " << socVersion_;
+}
+
+MockBackend::~MockBackend()
+{
+    for (auto &mem : deviceMems_) {
+        free(mem.first);
+    }
+    for (void *mem : hostMems_) {
+        free(mem);
+    }
+    for (MkiRtModule module : modules_) {
+        delete static_cast<MkiRtModuleInfo *>(module);
+    }
+    for (auto &capture : capturingStreams_) {
+        delete capture.second;
+    }
+    for (MkiRtModel model : models_) {
+        delete static_cast<std::vector<MockLaunchRecord> *>(model);
+    }
+    for (auto &event : events_) {
+        delete static_cast<uint8_t *>(event.first);
+    }
+}
+
+int MockBackend::DeviceGetCount(int32_t *devCount)
+{
+    CHECK_FUN_PARA_RETURN(devCount);
+    *devCount = 1;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::DeviceGetIds(int32_t *devIds, int32_t devIdNum)
+{
+    CHECK_FUN_PARA_RETURN(devIds);
+    if (devIdNum < 1) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    devIds[0] = 0;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::DeviceGetCurrent(int32_t *devId)
+{
+    CHECK_FUN_PARA_RETURN(devId);
+    std::lock_guard<std::mutex> lock(mutex_);
+    *devId = currentDevId_;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::DeviceSetCurrent(int32_t devId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    currentDevId_ = devId;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::DeviceResetCurrent(int32_t devId)
+{
+    (void)devId;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::DeviceSetSocVersion(const char *version)
+{
+    CHECK_FUN_PARA_RETURN(version);
+    std::lock_guard<std::mutex> lock(mutex_);
+    socVersion_ = version;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::DeviceGetSocVersion(char *version, uint32_t maxLen)
+{
+    CHECK_FUN_PARA_RETURN(version);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socVersion_.size() >= maxLen) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    (void)memcpy(version, socVersion_.c_str(), socVersion_.size() + 1);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::DeviceGetBareTgid(uint32_t *pid)
+{
+    CHECK_FUN_PARA_RETURN(pid);
+    *pid = static_cast<uint32_t>(getpid());
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::DeviceGetPairDevicesInfo(uint32_t devId, uint32_t otherDevId, int32_t infoType, int64_t *val)
+{
+    (void)devId;
+    (void)otherDevId;
+    (void)infoType;
+    CHECK_FUN_PARA_RETURN(val);
+    *val = 0;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::StreamCreate(MkiRtStream *stream, int32_t priority)
+{
+    (void)priority;
+    CHECK_FUN_PARA_RETURN(stream);
+    std::lock_guard<std::mutex> lock(mutex_);
+    int32_t streamId = nextStreamId_++;
+    // stream handle is never dereferenced, a unique non null value is enough
+    *stream = reinterpret_cast<MkiRtStream>(static_cast<uintptr_t>(streamId) + 1);
+    streams_[*stream] = streamId;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::StreamDestroy(MkiRtStream stream)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.erase(stream) == 1 ? MKIRT_SUCCESS : MKIRT_ERROR_PARA_CHECK_FAIL;
+}
+
+int MockBackend::StreamSynchronize(MkiRtStream stream)
+{
+    (void)stream;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::StreamGetId(MkiRtStream stream, int32_t *streamId)
+{
+    CHECK_FUN_PARA_RETURN(streamId);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(stream);
+    if (it == streams_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    *streamId = it->second;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::EventCreate(MkiRtEvent *event)
+{
+    CHECK_FUN_PARA_RETURN(event);
+    *event = new uint8_t(0);
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_[*event] = true;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::EventDestroy(MkiRtEvent event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = events_.find(event);
+    if (it == events_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    incompleteEventDestroyCount_ += it->second ? 0 : 1;
+    events_.erase(it);
+    delete static_cast<uint8_t *>(event);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::EventRecord(MkiRtEvent event, MkiRtStream stream)
+{
+    (void)stream;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = events_.find(event);
+    if (it == events_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    it->second = !eventDeferred_;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::EventQuery(MkiRtEvent event, bool *completed)
+{
+    CHECK_FUN_PARA_RETURN(completed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = events_.find(event);
+    if (it == events_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    *completed = it->second;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::EventSynchronize(MkiRtEvent event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = events_.find(event);
+    if (it == events_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    it->second = true;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::StreamWaitEvent(MkiRtStream stream, MkiRtEvent event)
+{
+    // streams are synchronous, the recorded work is already done
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (streams_.find(stream) == streams_.end() || events_.find(event) == events_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::StreamBeginCapture(MkiRtStream stream)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (streams_.find(stream) == streams_.end() || capturingStreams_.count(stream) != 0) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    capturingStreams_[stream] = new std::vector<MockLaunchRecord>();
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::StreamEndCapture(MkiRtStream stream, MkiRtModel *model)
+{
+    CHECK_FUN_PARA_RETURN(model);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = capturingStreams_.find(stream);
+    if (it == capturingStreams_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    *model = it->second;
+    models_.insert(*model);
+    capturingStreams_.erase(it);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::ModelExecute(MkiRtModel model, MkiRtStream stream)
+{
+    std::vector<MockLaunchRecord> launches;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (models_.count(model) == 0) {
+            return MKIRT_ERROR_PARA_CHECK_FAIL;
+        }
+        launches = *static_cast<std::vector<MockLaunchRecord> *>(model);
+    }
+    for (auto &launch : launches) {
+        MkiRtKernelParam param;
+        param.tilingId = launch.tilingId;
+        param.blockDim = launch.blockDim;
+        param.args = launch.args.data();
+        param.argSize = static_cast<uint32_t>(launch.args.size());
+        int ret = RecordLaunch(launch.func, &param, stream);
+        if (ret != MKIRT_SUCCESS) {
+            return ret;
+        }
+    }
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::ModelDestroy(MkiRtModel model)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (models_.erase(model) != 1) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    delete static_cast<std::vector<MockLaunchRecord> *>(model);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::MemMallocDevice(void **devPtr, uint64_t size, MkiRtMemType memType)
+{
+    (void)memType;
+    CHECK_FUN_PARA_RETURN(devPtr);
+    *devPtr = malloc(size);
+    if (*devPtr == nullptr) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    deviceMems_[*devPtr] = size;
+    deviceMemoryUsed_ += size;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::MemFreeDevice(void *devPtr)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = deviceMems_.find(devPtr);
+    if (it == deviceMems_.end()) {
+        MKI_LOG(ERROR) << "mock backend free unknown device memory";
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    deviceMemoryUsed_ -= it->second;
+    deviceMems_.erase(it);
+    free(devPtr);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::MemMallocHost(void **hostPtr, uint64_t size)
+{
+    CHECK_FUN_PARA_RETURN(hostPtr);
+    *hostPtr = malloc(size);
+    if (*hostPtr == nullptr) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    hostMems_.insert(*hostPtr);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::MemFreeHost(void *hostPtr)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hostMems_.erase(hostPtr) != 1) {
+        MKI_LOG(ERROR) << "mock backend free unknown host memory";
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    free(hostPtr);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::MemCopy(void *dst, uint64_t dstLen, const void *srcPtr, uint64_t srcLen, MkiRtMemCopyType copyType)
+{
+    (void)copyType;
+    CHECK_FUN_PARA_RETURN(dst);
+    CHECK_FUN_PARA_RETURN(srcPtr);
+    if (srcLen > dstLen) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    (void)memmove(dst, srcPtr, srcLen);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::MemCopyAsync(void *dst, uint64_t dstLen, const void *srcPtr, uint64_t srcLen,
+                              MkiRtMemCopyType copyType, void *stream)
+{
+    (void)stream;
+    return MemCopy(dst, dstLen, srcPtr, srcLen, copyType);
+}
+
+int MockBackend::MemSetAsync(void *dst, uint64_t destMax, uint32_t value, uint64_t count, void *stream)
+{
+    (void)stream;
+    CHECK_FUN_PARA_RETURN(dst);
+    if (count > destMax) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    (void)memset(dst, static_cast<int>(value), count);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::IpcSetMemoryName(const void *ptr, uint64_t byteCount, const char *name, uint32_t len)
+{
+    (void)byteCount;
+    CHECK_FUN_PARA_RETURN(ptr);
+    CHECK_FUN_PARA_RETURN(name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ipcMems_[std::string(name, strnlen(name, len))] = const_cast<void *>(ptr);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::IpcOpenMemory(void **ptr, const char *name)
+{
+    CHECK_FUN_PARA_RETURN(ptr);
+    CHECK_FUN_PARA_RETURN(name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ipcMems_.find(name);
+    if (it == ipcMems_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    *ptr = it->second;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::SetIpcMemPid(const char *name, int32_t pid[], int num)
+{
+    (void)name;
+    (void)pid;
+    (void)num;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::ModuleCreate(MkiRtModuleInfo *moduleInfo, MkiRtModule *module)
+{
+    CHECK_FUN_PARA_RETURN(moduleInfo);
+    CHECK_FUN_PARA_RETURN(module);
+    *module = new MkiRtModuleInfo(*moduleInfo);
+    std::lock_guard<std::mutex> lock(mutex_);
+    modules_.insert(*module);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::ModuleCreateFromFile(const char *moduleFilePath, MkiRtModuleType type, int version,
+                                      MkiRtModule *module)
+{
+    CHECK_FUN_PARA_RETURN(moduleFilePath);
+    MkiRtModuleInfo moduleInfo;
+    moduleInfo.type = type;
+    moduleInfo.version = static_cast<uint32_t>(version);
+    return ModuleCreate(&moduleInfo, module);
+}
+
+int MockBackend::ModuleDestory(MkiRtModule *module)
+{
+    if (module == nullptr || *module == nullptr) {
+        return MKIRT_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (modules_.erase(*module) != 1) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    delete static_cast<MkiRtModuleInfo *>(*module);
+    *module = nullptr;
+    return MKIRT_SUCCESS;
+}
+
+const std::string *MockBackend::AddFunction(const void *func, const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    functionNames_.push_back(name);
+    const std::string *functionName = &functionNames_.back();
+    functions_[func != nullptr ? func : functionName] = functionName;
+    return functionName;
+}
+
+int MockBackend::ModuleBindFunction(MkiRtModule module, const char *funcName, void *func)
+{
+    CHECK_FUN_PARA_RETURN(module);
+    CHECK_FUN_PARA_RETURN(funcName);
+    CHECK_FUN_PARA_RETURN(func);
+    // like the runtime, func is the stub address used by FunctionLaunchWithFlag
+    (void)AddFunction(func, funcName);
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::RegisterAllFunction(MkiRtModuleInfo *moduleInfo, void **handle)
+{
+    CHECK_FUN_PARA_RETURN(moduleInfo);
+    CHECK_FUN_PARA_RETURN(handle);
+    // handle is only used as launch key, the address of its name is unique
+    const char *name = moduleInfo->name != nullptr ? moduleInfo->name : "RegisterAllFunction";
+    *handle = const_cast<std::string *>(AddFunction(nullptr, name));
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::RecordLaunch(const void *func, const MkiRtKernelParam *param, MkiRtStream stream)
+{
+    CHECK_FUN_PARA_RETURN(param);
+    uint64_t startTime = GetSteadyTimeNs();
+    std::lock_guard<std::mutex> lock(mutex_);
+    AddLaunchRecord(func, param, stream, startTime);
+    return MKIRT_SUCCESS;
+}
+
+void MockBackend::AddLaunchRecord(const void *func, const MkiRtKernelParam *param, MkiRtStream stream,
+                                  uint64_t startTime)
+{
+    MockLaunchRecord record;
+    record.func = func;
+    record.stream = stream;
+    record.tilingId = param->tilingId;
+    record.blockDim = param->blockDim;
+    record.timestampNs = startTime;
+    const void *args = param->argsEx != nullptr ? param->argsEx->args : param->args;
+    uint32_t argsSize = param->argsEx != nullptr ? param->argsEx->argsSize : param->argSize;
+
+    auto captureIt = capturingStreams_.find(stream);
+    if (captureIt != capturingStreams_.end()) {
+        if (args != nullptr) {
+            record.args.assign(static_cast<const uint8_t *>(args), static_cast<const uint8_t *>(args) + argsSize);
+        }
+        captureIt->second->push_back(std::move(record));
+        return;
+    }
+    record.seq = launchCount_++;
+    if (launchRecords_.size() >= recordLimit_) {
+        return;
+    }
+    auto it = functions_.find(func);
+    if (it != functions_.end()) {
+        record.kernelName = *it->second;
+    }
+    if (recordArgs_ && args != nullptr) {
+        record.args.assign(static_cast<const uint8_t *>(args), static_cast<const uint8_t *>(args) + argsSize);
+    }
+    record.launchCostNs = GetSteadyTimeNs() - startTime;
+    launchRecords_.push_back(std::move(record));
+}
+
+int MockBackend::FunctionLaunch(const void *func, const MkiRtKernelParam *param, MkiRtStream stream)
+{
+    return RecordLaunch(func, param, stream);
+}
+
+int MockBackend::FunctionLaunchWithHandle(void *handle, const MkiRtKernelParam *param, MkiRtStream stream,
+                                          const RtTaskCfgInfoT *cfgInfo)
+{
+    (void)cfgInfo;
+    return RecordLaunch(handle, param, stream);
+}
+
+int MockBackend::FunctionLaunchWithFlag(const void *func, const MkiRtKernelParam *param, MkiRtStream stream,
+                                        const RtTaskCfgInfoT *cfgInfo)
+{
+    (void)cfgInfo;
+    return RecordLaunch(func, param, stream);
+}
+
+int MockBackend::FunctionLaunchBatch(const MkiRtLaunchItem *items, uint32_t count, MkiRtStream stream)
+{
+    CHECK_FUN_PARA_RETURN(items);
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK_FUN_PARA_RETURN(items[i].param);
+    }
+    uint64_t startTime = GetSteadyTimeNs();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint32_t i = 0; i < count; i++) {
+        AddLaunchRecord(items[i].handle != nullptr ? items[i].handle : items[i].func, items[i].param, stream,
+                        startTime);
+    }
+    batchLaunchCount_++;
+    return MKIRT_SUCCESS;
+}
+
+int MockBackend::GetC2cCtrlAddr(uint64_t *addr, uint32_t *len)
+{
+    CHECK_FUN_PARA_RETURN(addr);
+    CHECK_FUN_PARA_RETURN(len);
+    *addr = 0;
+    *len = 0;
+    return MKIRT_SUCCESS;
+}
+
+void MockBackend::SetRecordLimit(size_t limit)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    recordLimit_ = limit;
+}
+
+void MockBackend::SetRecordArgs(bool flag)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    recordArgs_ = flag;
+}
+
+uint64_t MockBackend::GetLaunchCount() const { return launchCount_; }
+
+uint64_t MockBackend::GetBatchLaunchCount() const { return batchLaunchCount_; }
+
+std::vector<MockLaunchRecord> MockBackend::GetLaunchRecords() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return launchRecords_;
+}
+
+void MockBackend::ClearLaunchRecords()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    launchRecords_.clear();
+    launchCount_ = 0;
+    batchLaunchCount_ = 0;
+}
+
+uint64_t MockBackend::GetDeviceMemoryUsed() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return deviceMemoryUsed_;
+}
+
+size_t MockBackend::GetHostMemoryCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hostMems_.size();
+}
+
+void MockBackend::SetEventDeferred(bool flag)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    eventDeferred_ = flag;
+}
+
+void MockBackend::CompleteEvents()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &event : events_) {
+        event.second = true;
+    }
+}
+
+uint64_t MockBackend::GetIncompleteEventDestroyCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return incompleteEventDestroyCount_;
+}
+}
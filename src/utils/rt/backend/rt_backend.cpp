@@ -10,6 +10,7 @@
  * See the Mulan PSL v2 for more details.
  */
 #include "mki/utils/rt/backend/rt_backend.h"
+#include <dlfcn.h>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
@@ -89,6 +90,93 @@ int RtBackend::StreamGetId(MkiRtStream stream, int32_t *streamId)
     CHECK_STATUS_WITH_DESC_RETURN(rtGetStreamId(stream, streamId), "rt GetStreamId");
 }
 
+int RtBackend::EventCreate(MkiRtEvent *event)
+{
+    CHECK_STATUS_WITH_DESC_RETURN(rtEventCreate(event), "rt EventCreate");
+}
+
+int RtBackend::EventDestroy(MkiRtEvent event)
+{
+    CHECK_STATUS_RETURN(rtEventDestroy(event));
+}
+
+int RtBackend::EventRecord(MkiRtEvent event, MkiRtStream stream)
+{
+    CHECK_STATUS_RETURN(rtEventRecord(event, stream));
+}
+
+int RtBackend::EventQuery(MkiRtEvent event, bool *completed)
+{
+    CHECK_FUN_PARA_RETURN(completed);
+    rtEventStatus_t status = RT_EVENT_INIT;
+    int ret = rtEventQueryStatus(event, &status);
+    *completed = ret == 0 && status == RT_EVENT_RECORDED;
+    CHECK_STATUS_RETURN(ret);
+}
+
+int RtBackend::EventSynchronize(MkiRtEvent event)
+{
+    CHECK_STATUS_RETURN(rtEventSynchronize(event));
+}
+
+int RtBackend::StreamWaitEvent(MkiRtStream stream, MkiRtEvent event)
+{
+    CHECK_STATUS_RETURN(rtStreamWaitEvent(stream, event));
+}
+
+using RtStreamBeginCaptureFunc = int (*)(rtStream_t, rtStreamCaptureMode);
+using RtStreamEndCaptureFunc = int (*)(rtStream_t, rtModel_t *);
+using RtModelExecuteFunc = int (*)(rtModel_t, rtStream_t, uint32_t);
+using RtModelDestroyFunc = int (*)(rtModel_t);
+
+template <typename T> static T GetRtCaptureFunc(const char *name)
+{
+    T func = reinterpret_cast<T>(dlsym(RTLD_DEFAULT, name));
+    MKI_LOG_IF(func == nullptr, WARN) << name << " is not supported by the runtime";
+    return func;
+}
+
+int RtBackend::StreamBeginCapture(MkiRtStream stream)
+{
+    static RtStreamBeginCaptureFunc func = GetRtCaptureFunc<RtStreamBeginCaptureFunc>("rtStreamBeginCapture");
+    if (func == nullptr) {
+        return MKIRT_ERROR_FUNC_NOT_EXIST;
+    }
+    int ret = func(stream, RT_STREAM_CAPTURE_MODE_RELAXED);
+    CHECK_STATUS_WITH_DESC_RETURN(ret, "rt StreamBeginCapture");
+}
+
+int RtBackend::StreamEndCapture(MkiRtStream stream, MkiRtModel *model)
+{
+    CHECK_FUN_PARA_RETURN(model);
+    static RtStreamEndCaptureFunc func = GetRtCaptureFunc<RtStreamEndCaptureFunc>("rtStreamEndCapture");
+    if (func == nullptr) {
+        return MKIRT_ERROR_FUNC_NOT_EXIST;
+    }
+    int ret = func(stream, model);
+    CHECK_STATUS_WITH_DESC_RETURN(ret, "rt StreamEndCapture");
+}
+
+int RtBackend::ModelExecute(MkiRtModel model, MkiRtStream stream)
+{
+    static RtModelExecuteFunc func = GetRtCaptureFunc<RtModelExecuteFunc>("rtModelExecute");
+    if (func == nullptr) {
+        return MKIRT_ERROR_FUNC_NOT_EXIST;
+    }
+    int ret = func(model, stream, 0);
+    CHECK_STATUS_WITH_DESC_RETURN(ret, "rt ModelExecute");
+}
+
+int RtBackend::ModelDestroy(MkiRtModel model)
+{
+    static RtModelDestroyFunc func = GetRtCaptureFunc<RtModelDestroyFunc>("rtModelDestroy");
+    if (func == nullptr) {
+        return MKIRT_ERROR_FUNC_NOT_EXIST;
+    }
+    int ret = func(model);
+    CHECK_STATUS_WITH_DESC_RETURN(ret, "rt ModelDestroy");
+}
+
 int RtBackend::MemMallocDevice(void **devPtr, uint64_t size, MkiRtMemType memType)
 {
     MKI_LOG(INFO) << "rtMalloc start, size:" << size << ", memType:" << memType;
@@ -198,6 +198,29 @@ int RtBackend::FunctionLaunchWithFlag(const void *func, const MkiRtKernelParam *
                                   "rt KernelLaunch With Flag");
 }
 
+int RtBackend::FunctionLaunchBatch(const MkiRtLaunchItem *items, uint32_t count, MkiRtStream stream)
+{
+    CHECK_FUN_PARA_RETURN(items);
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK_FUN_PARA_RETURN(items[i].param);
+        CHECK_FUN_PARA_RETURN(items[i].param->argsEx);
+    }
+    /* runtime没有批量下发接口，参数统一校验后逐个下发 */
+    for (uint32_t i = 0; i < count; i++) {
+        const MkiRtKernelParam *param = items[i].param;
+        int ret = items[i].handle != nullptr ?
+            rtKernelLaunchWithHandleV2(items[i].handle, param->tilingId, param->blockDim, param->argsEx, nullptr,
+                                       stream, nullptr) :
+            rtKernelLaunchWithFlagV2(items[i].func, param->blockDim, param->argsEx, nullptr, stream, 0, nullptr);
+        if (ret != 0) {
+            MKI_LOG(ERROR) << "rt KernelLaunch in batch fail, index " << i << " of " << count << ", error:" << ret;
+            return ret;
+        }
+    }
+    MKI_LOG(DEBUG) << "rt KernelLaunch batch of " << count << " success";
+    return MKIRT_SUCCESS;
+}
+
 int RtBackend::GetC2cCtrlAddr(uint64_t *addr, uint32_t *len)
 {
     CHECK_STATUS_WITH_DESC_RETURN(rtGetC2cCtrlAddr(addr, len), "rt Get C2cCtrl Addr");
@@ -38,6 +38,7 @@ const char *MkiRtErrorName(int error)
         ERROR_ITEM(MKIRT_ERROR_NOT_IMPLMENT),       ERROR_ITEM(MKIRT_ERROR_ASCEND_ENV_NOT_EXIST),
         ERROR_ITEM(MKIRT_ERROR_LOAD_RUNTIME_FAIL),  ERROR_ITEM(MKIRT_ERROR_FUNC_NOT_EXIST),
         ERROR_ITEM(MKIRT_ERROR_OPEN_BIN_FILE_FAIL), ERROR_ITEM(MKIRT_ERROR_PARA_CHECK_FAIL),
+        ERROR_ITEM(MKIRT_ERROR_OUT_OF_MEMORY),
     };
 
     const auto it = errorNameMap.find(error);
@@ -57,6 +58,7 @@ const char *MkiRtErrorDesc(int error)
         {MKIRT_ERROR_FUNC_NOT_EXIST, "function not exist in runtime library"},
         {MKIRT_ERROR_OPEN_BIN_FILE_FAIL, "open bin file fail"},
         {MKIRT_ERROR_PARA_CHECK_FAIL, "para check fail"},
+        {MKIRT_ERROR_OUT_OF_MEMORY, "out of device memory or cache limit"},
     };
 
     const auto it = errorDescMap.find(error);
@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/rt/memory/caching_allocator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "mki/utils/env/env.h"
+#include "mki/utils/log/log.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+
+namespace Mki {
+constexpr uint64_t MB_SIZE = 1048576;          // 1048576: bytes of 1MB
+constexpr uint64_t MAX_CACHE_LIMIT_MB = 16777216; // 16777216: 16TB
+constexpr uint64_t MAX_ALLOC_SIZE = 1ULL << 48; // 48: far beyond any device memory
+
+struct DeviceCachingAllocator::Block {
+    void *ptr = nullptr;
+    uint64_t size = 0;
+    MkiRtStream stream = nullptr;
+    bool small = false;
+    bool allocated = false;
+    bool pending = false; // freed, waiting for events of streamUses
+    Block *prev = nullptr; // neighbours in the same segment
+    Block *next = nullptr;
+    std::vector<MkiRtStream> streamUses;
+};
+
+static uint64_t GetUintFromEnv(const char *name, uint64_t defaultValue)
+{
+    const char *env = std::getenv(name);
+    if (env == nullptr || strlen(env) > MAX_ENV_STRING_LEN) {
+        return defaultValue;
+    }
+    char *end = nullptr;
+    unsigned long long value = std::strtoull(env, &end, 10); // 10: decimal
+    return (end == env || *end != '\0') ? defaultValue : value;
+}
+
+static uint64_t AlignUp(uint64_t size, uint64_t align) { return (size + align - 1) / align * align; }
+
+double DeviceAllocatorStats::CacheHitRate() const
+{
+    return allocCount == 0 ? 0 : static_cast<double>(cacheHitCount) / allocCount;
+}
+
+double DeviceAllocatorStats::Fragmentation() const
+{
+    return cachedFreeBytes == 0 ? 0 : 1 - static_cast<double>(largestFreeBlock) / cachedFreeBytes;
+}
+
+bool DeviceCachingAllocator::BlockLess::operator()(const Block *lhs, const Block *rhs) const
+{
+    if (lhs->size != rhs->size) {
+        return lhs->size < rhs->size;
+    }
+    return reinterpret_cast<uintptr_t>(lhs->ptr) < reinterpret_cast<uintptr_t>(rhs->ptr);
+}
+
+DeviceCachingAllocator::DeviceCachingAllocator(Backend *backend) : backend_(backend) {}
+
+DeviceCachingAllocator::~DeviceCachingAllocator()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ProcessEvents(true);
+    MKI_LOG_IF(!allocatedBlocks_.empty(), WARN) << "device caching allocator is destroyed with "
+                                                << allocatedBlocks_.size() << " blocks in use";
+    for (Block *segment : segments_) {
+        (void)backend_->MemFreeDevice(segment->ptr);
+        for (Block *block = segment; block != nullptr;) {
+            Block *next = block->next;
+            delete block;
+            block = next;
+        }
+    }
+    for (MkiRtEvent event : eventPool_) {
+        (void)backend_->EventDestroy(event);
+    }
+}
+
+int DeviceCachingAllocator::Allocate(void **devPtr, uint64_t size, MkiRtStream stream)
+{
+    if (devPtr == nullptr || size > MAX_ALLOC_SIZE) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    *devPtr = nullptr;
+    if (size == 0) {
+        return MKIRT_SUCCESS;
+    }
+    uint64_t alignedSize = AlignUp(size, BLOCK_ALIGN);
+    bool small = alignedSize <= SMALL_SIZE;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ProcessEvents(false);
+    stats_.allocCount++;
+    Block *block = FindFreeBlock(stream, small, alignedSize);
+    if (block != nullptr) {
+        stats_.cacheHitCount++;
+    } else {
+        block = AllocSegment(stream, small, small ? SMALL_SEGMENT_SIZE : AlignUp(alignedSize, LARGE_SEGMENT_ALIGN));
+        if (block == nullptr) {
+            stats_.oomCount++;
+            MKI_LOG(ERROR) << "device caching allocator out of memory, size: " << size << ", reserved: "
+                           << stats_.reservedBytes << ", allocated: " << stats_.allocatedBytes << ", limit: "
+                           << limit_;
+            return MKIRT_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    SplitBlock(block, alignedSize);
+    block->allocated = true;
+    allocatedBlocks_[block->ptr] = block;
+    stats_.allocatedBytes += block->size;
+    stats_.peakAllocatedBytes = std::max(stats_.peakAllocatedBytes, stats_.allocatedBytes);
+    *devPtr = block->ptr;
+    return MKIRT_SUCCESS;
+}
+
+int DeviceCachingAllocator::Free(void *devPtr)
+{
+    if (devPtr == nullptr) {
+        return MKIRT_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = allocatedBlocks_.find(devPtr);
+    if (it == allocatedBlocks_.end()) {
+        MKI_LOG(ERROR) << "device caching allocator free unknown device memory";
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    Block *block = it->second;
+    allocatedBlocks_.erase(it);
+    block->allocated = false;
+    stats_.allocatedBytes -= block->size;
+
+    if (!block->streamUses.empty()) {
+        PendingFree pending;
+        pending.block = block;
+        for (MkiRtStream stream : block->streamUses) {
+            MkiRtEvent event = GetEvent();
+            if (event != nullptr && backend_->EventRecord(event, stream) == MKIRT_SUCCESS) {
+                pending.events.push_back(event);
+                continue;
+            }
+            if (event != nullptr) {
+                eventPool_.push_back(event);
+            }
+            (void)backend_->StreamSynchronize(stream); // no event, wait for the stream instead
+        }
+        block->streamUses.clear();
+        if (!pending.events.empty()) {
+            block->pending = true;
+            stats_.pendingFreeBytes += block->size;
+            pendingFrees_.push_back(std::move(pending));
+            return MKIRT_SUCCESS;
+        }
+    }
+    FreeBlock(block);
+    return MKIRT_SUCCESS;
+}
+
+int DeviceCachingAllocator::RecordStream(void *devPtr, MkiRtStream stream)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = allocatedBlocks_.find(devPtr);
+    if (it == allocatedBlocks_.end()) {
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    Block *block = it->second;
+    if (stream != block->stream &&
+        std::find(block->streamUses.begin(), block->streamUses.end(), stream) == block->streamUses.end()) {
+        block->streamUses.push_back(stream);
+    }
+    return MKIRT_SUCCESS;
+}
+
+void DeviceCachingAllocator::SetMemoryLimit(uint64_t limit)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = limit;
+    if (limit_ != 0 && stats_.reservedBytes > limit_) {
+        ReleaseCachedSegments(limit_);
+    }
+}
+
+uint64_t DeviceCachingAllocator::GetMemoryLimit() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limit_;
+}
+
+void DeviceCachingAllocator::Trim(uint64_t keepBytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ProcessEvents(false);
+    ReleaseCachedSegments(keepBytes);
+}
+
+void DeviceCachingAllocator::ReleaseStream(MkiRtStream stream)
+{
+    if (stream == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    (void)backend_->StreamSynchronize(stream);
+    for (const PendingFree &pending : pendingFrees_) {
+        if (pending.block->stream != stream) {
+            continue;
+        }
+        for (MkiRtEvent event : pending.events) {
+            (void)backend_->EventSynchronize(event);
+        }
+    }
+    ProcessEvents(false);
+    // work of the stream is done, a later free must not record an event on it
+    for (auto &allocated : allocatedBlocks_) {
+        std::vector<MkiRtStream> &streamUses = allocated.second->streamUses;
+        streamUses.erase(std::remove(streamUses.begin(), streamUses.end(), stream), streamUses.end());
+    }
+    std::vector<Block *> streamSegments;
+    for (Block *segment : segments_) {
+        if (segment->stream == stream) {
+            streamSegments.push_back(segment);
+        }
+    }
+    for (Block *segment : streamSegments) {
+        if (!segment->allocated && !segment->pending && segment->next == nullptr) {
+            ReleaseSegment(segment);
+            continue;
+        }
+        for (Block *block = segment; block != nullptr; block = block->next) {
+            bool cached = !block->allocated && !block->pending;
+            if (cached) {
+                EraseFreeBlock(block);
+            }
+            block->stream = nullptr;
+            if (cached) {
+                InsertFreeBlock(block);
+            }
+        }
+    }
+    pools_[0].erase(stream);
+    pools_[1].erase(stream);
+}
+
+DeviceAllocatorStats DeviceCachingAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    DeviceAllocatorStats stats = stats_;
+    stats.cachedFreeBytes = stats_.pendingFreeBytes;
+    stats.largestFreeBlock = 0;
+    for (const auto &pools : pools_) {
+        for (const auto &pool : pools) {
+            for (const BlockSet &bin : pool.second.bins) {
+                for (const Block *block : bin) {
+                    stats.cachedFreeBytes += block->size;
+                }
+                if (!bin.empty()) {
+                    stats.largestFreeBlock = std::max(stats.largestFreeBlock, (*bin.rbegin())->size);
+                }
+            }
+        }
+    }
+    stats.segmentCount = segments_.size();
+    return stats;
+}
+
+void DeviceCachingAllocator::ResetPeakStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.peakAllocatedBytes = stats_.allocatedBytes;
+    stats_.peakReservedBytes = stats_.reservedBytes;
+}
+
+size_t DeviceCachingAllocator::GetBinIdx(uint64_t size)
+{
+    size_t idx = 0;
+    while (size >>= 1) {
+        idx++;
+    }
+    return idx;
+}
+
+DeviceCachingAllocator::StreamPool &DeviceCachingAllocator::GetPool(MkiRtStream stream, bool small)
+{
+    return pools_[small ? 1 : 0][stream];
+}
+
+DeviceCachingAllocator::Block *DeviceCachingAllocator::FindFreeBlock(MkiRtStream stream, bool small, uint64_t size)
+{
+    auto &pools = pools_[small ? 1 : 0];
+    auto poolIt = pools.find(stream);
+    if (poolIt == pools.end()) {
+        return nullptr;
+    }
+    Block key;
+    key.size = size;
+    for (size_t binIdx = GetBinIdx(size); binIdx < BIN_NUM; ++binIdx) {
+        BlockSet &bin = poolIt->second.bins[binIdx];
+        auto it = bin.lower_bound(&key);
+        if (it != bin.end()) {
+            Block *block = *it;
+            bin.erase(it);
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+DeviceCachingAllocator::Block *DeviceCachingAllocator::AllocSegment(MkiRtStream stream, bool small, uint64_t size)
+{
+    if (limit_ != 0 && stats_.reservedBytes + size > limit_) {
+        uint64_t keepBytes = limit_ > size ? limit_ - size : 0;
+        ReleaseCachedSegments(keepBytes);
+        if (stats_.reservedBytes + size > limit_) {
+            ProcessEvents(true);
+            ReleaseCachedSegments(keepBytes);
+        }
+        if (stats_.reservedBytes + size > limit_) {
+            return nullptr;
+        }
+    }
+    void *ptr = nullptr;
+    int ret = backend_->MemMallocDevice(&ptr, size, MKIRT_MEM_DEFAULT);
+    if (ret != MKIRT_SUCCESS || ptr == nullptr) {
+        // give every cached segment back and retry once
+        ProcessEvents(true);
+        ReleaseCachedSegments(0);
+        ret = backend_->MemMallocDevice(&ptr, size, MKIRT_MEM_DEFAULT);
+        if (ret != MKIRT_SUCCESS || ptr == nullptr) {
+            return nullptr;
+        }
+    }
+    Block *block = new Block();
+    block->ptr = ptr;
+    block->size = size;
+    block->stream = stream;
+    block->small = small;
+    segments_.insert(block);
+    stats_.reservedBytes += size;
+    stats_.peakReservedBytes = std::max(stats_.peakReservedBytes, stats_.reservedBytes);
+    stats_.backendMallocCount++;
+    return block;
+}
+
+void DeviceCachingAllocator::SplitBlock(Block *block, uint64_t size)
+{
+    uint64_t remaining = block->size - size;
+    // large blocks keep a small tail instead of leaving it to fragment the large pool
+    if (block->small ? remaining < BLOCK_ALIGN : remaining <= SMALL_SIZE) {
+        return;
+    }
+    Block *rest = new Block();
+    rest->ptr = static_cast<uint8_t *>(block->ptr) + size;
+    rest->size = remaining;
+    rest->stream = block->stream;
+    rest->small = block->small;
+    rest->prev = block;
+    rest->next = block->next;
+    if (block->next != nullptr) {
+        block->next->prev = rest;
+    }
+    block->next = rest;
+    block->size = size;
+    InsertFreeBlock(rest);
+}
+
+void DeviceCachingAllocator::FreeBlock(Block *block)
+{
+    Block *prev = block->prev;
+    if (prev != nullptr && !prev->allocated && !prev->pending) {
+        EraseFreeBlock(prev);
+        prev->size += block->size;
+        prev->next = block->next;
+        if (block->next != nullptr) {
+            block->next->prev = prev;
+        }
+        delete block;
+        block = prev;
+    }
+    Block *next = block->next;
+    if (next != nullptr && !next->allocated && !next->pending) {
+        EraseFreeBlock(next);
+        block->size += next->size;
+        block->next = next->next;
+        if (next->next != nullptr) {
+            next->next->prev = block;
+        }
+        delete next;
+    }
+    InsertFreeBlock(block);
+}
+
+void DeviceCachingAllocator::InsertFreeBlock(Block *block)
+{
+    GetPool(block->stream, block->small).bins[GetBinIdx(block->size)].insert(block);
+}
+
+void DeviceCachingAllocator::EraseFreeBlock(Block *block)
+{
+    GetPool(block->stream, block->small).bins[GetBinIdx(block->size)].erase(block);
+}
+
+void DeviceCachingAllocator::ReleaseSegment(Block *block)
+{
+    EraseFreeBlock(block);
+    int ret = backend_->MemFreeDevice(block->ptr);
+    MKI_LOG_IF(ret != MKIRT_SUCCESS, ERROR) << "device caching allocator free segment fail, error: " << ret;
+    segments_.erase(block);
+    stats_.reservedBytes -= block->size;
+    stats_.backendFreeCount++;
+    delete block;
+}
+
+void DeviceCachingAllocator::ReleaseCachedSegments(uint64_t keepBytes)
+{
+    if (stats_.reservedBytes <= keepBytes) {
+        return;
+    }
+    std::vector<Block *> freeSegments;
+    for (Block *segment : segments_) {
+        if (!segment->allocated && !segment->pending && segment->next == nullptr) {
+            freeSegments.push_back(segment);
+        }
+    }
+    // largest first, so as few segments as possible are given back
+    std::sort(freeSegments.begin(), freeSegments.end(), [](const Block *lhs, const Block *rhs) {
+        return lhs->size > rhs->size;
+    });
+    std::vector<MkiRtStream> syncedStreams;
+    for (Block *segment : freeSegments) {
+        if (stats_.reservedBytes <= keepBytes) {
+            break;
+        }
+        // the last user of the segment may still run on its stream
+        if (std::find(syncedStreams.begin(), syncedStreams.end(), segment->stream) == syncedStreams.end()) {
+            (void)backend_->StreamSynchronize(segment->stream);
+            syncedStreams.push_back(segment->stream);
+        }
+        ReleaseSegment(segment);
+    }
+}
+
+void DeviceCachingAllocator::ProcessEvents(bool synchronize)
+{
+    for (size_t i = 0; i < pendingFrees_.size();) {
+        PendingFree &pending = pendingFrees_[i];
+        bool completed = true;
+        for (MkiRtEvent event : pending.events) {
+            if (synchronize) {
+                (void)backend_->EventSynchronize(event);
+                continue;
+            }
+            if (backend_->EventQuery(event, &completed) != MKIRT_SUCCESS || !completed) {
+                completed = false;
+                break;
+            }
+        }
+        if (!completed) {
+            ++i;
+            continue;
+        }
+        eventPool_.insert(eventPool_.end(), pending.events.begin(), pending.events.end());
+        Block *block = pending.block;
+        block->pending = false;
+        stats_.pendingFreeBytes -= block->size;
+        pendingFrees_[i] = std::move(pendingFrees_.back());
+        pendingFrees_.pop_back();
+        FreeBlock(block);
+    }
+}
+
+MkiRtEvent DeviceCachingAllocator::GetEvent()
+{
+    if (!eventPool_.empty()) {
+        MkiRtEvent event = eventPool_.back();
+        eventPool_.pop_back();
+        return event;
+    }
+    MkiRtEvent event = nullptr;
+    if (backend_->EventCreate(&event) != MKIRT_SUCCESS) {
+        return nullptr;
+    }
+    return event;
+}
+
+DeviceCachingAllocator *GetDeviceCachingAllocator()
+{
+    static std::mutex mutex;
+    static std::unordered_map<Backend *, DeviceCachingAllocator *> allocators;
+    Backend *backend = BackendFactory::GetBackend();
+    std::lock_guard<std::mutex> lock(mutex);
+    DeviceCachingAllocator *&allocator = allocators[backend];
+    if (allocator == nullptr) {
+        // never destructed, the runtime may already be finalized when static objects are destroyed
+        allocator = new DeviceCachingAllocator(backend);
+        uint64_t limitMb = std::min(GetUintFromEnv("ASDOPS_DEVICE_CACHE_LIMIT", 0), MAX_CACHE_LIMIT_MB);
+        allocator->SetMemoryLimit(limitMb * MB_SIZE);
+    }
+    return allocator;
+}
+} // namespace Mki
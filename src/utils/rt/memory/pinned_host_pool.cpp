@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/rt/memory/pinned_host_pool.h"
+#include <algorithm>
+#include <unordered_map>
+#include "mki/utils/log/log.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+
+namespace Mki {
+constexpr uint64_t MAX_ALLOC_SIZE = 1ULL << 40; // 40: 1TB, far beyond any host staging buffer
+
+PinnedHostPool::PinnedHostPool(Backend *backend) : backend_(backend) {}
+
+PinnedHostPool::~PinnedHostPool()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    MKI_LOG_IF(stats_.allocatedBytes != 0, WARN) << "pinned host pool is destroyed with "
+                                                 << stats_.allocatedBytes << " bytes in use";
+    for (auto &range : pinnedRanges_) {
+        (void)backend_->MemFreeHost(reinterpret_cast<void *>(range.first));
+    }
+}
+
+size_t PinnedHostPool::GetClassIdx(uint64_t size)
+{
+    size_t idx = 0;
+    uint64_t classSize = MIN_CLASS_SIZE;
+    while (classSize < size) {
+        classSize <<= 1;
+        idx++;
+    }
+    return idx;
+}
+
+uint8_t *PinnedHostPool::MallocPinned(uint64_t size)
+{
+    void *addr = nullptr;
+    int ret = backend_->MemMallocHost(&addr, size);
+    if (ret != MKIRT_SUCCESS || addr == nullptr) {
+        MKI_LOG(ERROR) << "pinned host pool malloc " << size << " bytes fail, ret " << ret;
+        return nullptr;
+    }
+    stats_.backendMallocCount++;
+    stats_.reservedBytes += size;
+    pinnedRanges_[reinterpret_cast<uintptr_t>(addr)] = size;
+    return static_cast<uint8_t *>(addr);
+}
+
+void PinnedHostPool::RecycleChunkTail()
+{
+    // the tail is a multiple of MIN_CLASS_SIZE, split it into the largest classes that fit
+    for (size_t classIdx = CLASS_NUM; classIdx > 0; classIdx--) {
+        uint64_t classSize = MIN_CLASS_SIZE << (classIdx - 1);
+        while (static_cast<uint64_t>(end_ - cursor_) >= classSize) {
+            freeLists_[classIdx - 1].push_back(cursor_);
+            cursor_ += classSize;
+        }
+    }
+}
+
+uint8_t *PinnedHostPool::AllocateFromClass(size_t classIdx)
+{
+    std::vector<uint8_t *> &freeList = freeLists_[classIdx];
+    if (!freeList.empty()) {
+        uint8_t *addr = freeList.back();
+        freeList.pop_back();
+        stats_.cacheHitCount++;
+        return addr;
+    }
+    uint64_t classSize = MIN_CLASS_SIZE << classIdx;
+    if (static_cast<uint64_t>(end_ - cursor_) < classSize) {
+        uint8_t *chunk = MallocPinned(CHUNK_SIZE);
+        if (chunk == nullptr) {
+            return nullptr;
+        }
+        RecycleChunkTail();
+        stats_.chunkCount++;
+        cursor_ = chunk;
+        end_ = chunk + CHUNK_SIZE;
+    }
+    uint8_t *addr = cursor_;
+    cursor_ += classSize;
+    return addr;
+}
+
+uint8_t *PinnedHostPool::Allocate(uint64_t size)
+{
+    if (size == 0 || size > MAX_ALLOC_SIZE) {
+        MKI_LOG(ERROR) << "pinned host pool invalid size " << size;
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.allocCount++;
+    uint8_t *addr = nullptr;
+    uint64_t allocSize = size;
+    if (size <= MAX_CLASS_SIZE) {
+        size_t classIdx = GetClassIdx(size);
+        allocSize = MIN_CLASS_SIZE << classIdx;
+        addr = AllocateFromClass(classIdx);
+    } else {
+        addr = MallocPinned(size);
+        stats_.largeBlockCount += addr == nullptr ? 0 : 1;
+    }
+    if (addr == nullptr) {
+        stats_.failCount++;
+        return nullptr;
+    }
+    stats_.allocatedBytes += allocSize;
+    stats_.peakAllocatedBytes = std::max(stats_.peakAllocatedBytes, stats_.allocatedBytes);
+    return addr;
+}
+
+void PinnedHostPool::Deallocate(uint8_t *addr, uint64_t size)
+{
+    if (addr == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size <= MAX_CLASS_SIZE) {
+        size_t classIdx = GetClassIdx(size);
+        freeLists_[classIdx].push_back(addr);
+        stats_.allocatedBytes -= MIN_CLASS_SIZE << classIdx;
+        return;
+    }
+    auto it = pinnedRanges_.find(reinterpret_cast<uintptr_t>(addr));
+    if (it == pinnedRanges_.end() || it->second != size) {
+        MKI_LOG(ERROR) << "pinned host pool deallocate unknown block, size " << size;
+        return;
+    }
+    pinnedRanges_.erase(it);
+    (void)backend_->MemFreeHost(addr);
+    stats_.reservedBytes -= size;
+    stats_.allocatedBytes -= size;
+    stats_.largeBlockCount--;
+}
+
+bool PinnedHostPool::IsPinned(const void *addr) const
+{
+    uintptr_t value = reinterpret_cast<uintptr_t>(addr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pinnedRanges_.upper_bound(value);
+    if (it == pinnedRanges_.begin()) {
+        return false;
+    }
+    --it;
+    return value < it->first + it->second;
+}
+
+PinnedHostPoolStats PinnedHostPool::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+PinnedHostPool *GetPinnedHostPool()
+{
+    static std::mutex mutex;
+    static std::unordered_map<Backend *, PinnedHostPool *> pools;
+    Backend *backend = BackendFactory::GetBackend();
+    std::lock_guard<std::mutex> lock(mutex);
+    PinnedHostPool *&pool = pools[backend];
+    if (pool == nullptr) {
+        // never destructed, kernels in static storage may still hold buffers of the pool at exit
+        pool = new PinnedHostPool(backend);
+    }
+    return pool;
+}
+} // namespace Mki
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include "mki/utils/rt/memory/tiling_ring_buffer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <securec.h>
+#include "mki/utils/env/env.h"
+#include "mki/utils/log/log.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+
+namespace Mki {
+constexpr uint64_t MB_SIZE = 1048576;       // 1048576: bytes of 1MB
+constexpr uint64_t MAX_RING_SIZE_MB = 1024; // 1024: 1GB for every stream
+
+static uint64_t GetUintFromEnv(const char *name, uint64_t defaultValue)
+{
+    const char *env = std::getenv(name);
+    if (env == nullptr || strlen(env) > MAX_ENV_STRING_LEN) {
+        return defaultValue;
+    }
+    char *end = nullptr;
+    unsigned long long value = std::strtoull(env, &end, 10); // 10: decimal
+    return (end == env || *end != '\0') ? defaultValue : value;
+}
+
+static uint64_t AlignUp(uint64_t size, uint64_t align) { return (size + align - 1) / align * align; }
+
+TilingRingBuffer::TilingRingBuffer(Backend *backend, uint64_t capacity)
+    : backend_(backend), capacity_(AlignUp(std::max(capacity, SLOT_ALIGN), SLOT_ALIGN))
+{
+    stats_.capacity = capacity_;
+}
+
+TilingRingBuffer::~TilingRingBuffer()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &it : rings_) {
+        FreeRing(it.second);
+    }
+    rings_.clear();
+    for (MkiRtEvent event : eventPool_) {
+        (void)backend_->EventDestroy(event);
+    }
+}
+
+TilingRingBuffer::StreamRing *TilingRingBuffer::GetRing(MkiRtStream stream)
+{
+    auto it = rings_.find(stream);
+    if (it != rings_.end()) {
+        return &it->second;
+    }
+    StreamRing ring;
+    void *deviceBase = nullptr;
+    int ret = backend_->MemMallocDevice(&deviceBase, capacity_, MKIRT_MEM_DEFAULT);
+    if (ret != MKIRT_SUCCESS) {
+        MKI_LOG(ERROR) << "tiling ring malloc device " << capacity_ << " bytes fail, ret " << ret;
+        return nullptr;
+    }
+    void *hostBase = nullptr;
+    ret = backend_->MemMallocHost(&hostBase, capacity_);
+    if (ret != MKIRT_SUCCESS) {
+        MKI_LOG(ERROR) << "tiling ring malloc host " << capacity_ << " bytes fail, ret " << ret;
+        (void)backend_->MemFreeDevice(deviceBase);
+        return nullptr;
+    }
+    ring.deviceBase = static_cast<uint8_t *>(deviceBase);
+    ring.hostBase = static_cast<uint8_t *>(hostBase);
+    stats_.streamCount++;
+    MKI_LOG(INFO) << "tiling ring of stream " << stream << " created, capacity " << capacity_;
+    return &rings_.emplace(stream, std::move(ring)).first->second;
+}
+
+MkiRtEvent TilingRingBuffer::GetEvent()
+{
+    if (!eventPool_.empty()) {
+        MkiRtEvent event = eventPool_.back();
+        eventPool_.pop_back();
+        return event;
+    }
+    MkiRtEvent event = nullptr;
+    int ret = backend_->EventCreate(&event);
+    MKI_LOG_IF(ret != MKIRT_SUCCESS, ERROR) << "tiling ring create event fail, ret " << ret;
+    return ret == MKIRT_SUCCESS ? event : nullptr;
+}
+
+void TilingRingBuffer::RetireMarkers(StreamRing &ring)
+{
+    while (!ring.markers.empty()) {
+        Marker &marker = ring.markers.front();
+        bool completed = false;
+        if (backend_->EventQuery(marker.event, &completed) != MKIRT_SUCCESS || !completed) {
+            break;
+        }
+        ring.tail = marker.end;
+        eventPool_.push_back(marker.event);
+        ring.markers.pop_front();
+    }
+}
+
+int TilingRingBuffer::WaitForSpace(StreamRing &ring, uint64_t newHead)
+{
+    if (newHead - ring.tail <= capacity_) {
+        return MKIRT_SUCCESS;
+    }
+    RetireMarkers(ring);
+    while (newHead - ring.tail > capacity_) {
+        if (ring.markers.empty()) {
+            MKI_LOG(ERROR) << "tiling ring is full of uncommitted slots, capacity " << capacity_;
+            return MKIRT_ERROR_OUT_OF_MEMORY;
+        }
+        Marker marker = ring.markers.front();
+        ring.markers.pop_front();
+        int ret = backend_->EventSynchronize(marker.event);
+        eventPool_.push_back(marker.event);
+        if (ret != MKIRT_SUCCESS) {
+            MKI_LOG(ERROR) << "tiling ring synchronize event fail, ret " << ret;
+            return ret;
+        }
+        ring.tail = marker.end;
+        stats_.waitCount++;
+    }
+    return MKIRT_SUCCESS;
+}
+
+int TilingRingBuffer::Upload(MkiRtStream stream, const void *hostData, uint64_t size, uint8_t **deviceAddr)
+{
+    if (hostData == nullptr || deviceAddr == nullptr || size == 0) {
+        MKI_LOG(ERROR) << "tiling ring upload invalid param, size " << size;
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    uint64_t slotSize = AlignUp(size, SLOT_ALIGN);
+    if (slotSize > capacity_) {
+        MKI_LOG(ERROR) << "tiling size " << size << " exceeds tiling ring capacity " << capacity_;
+        return MKIRT_ERROR_OUT_OF_MEMORY;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    StreamRing *ring = GetRing(stream);
+    if (ring == nullptr) {
+        return MKIRT_ERROR_OUT_OF_MEMORY;
+    }
+    uint64_t start = ring->head;
+    uint64_t offset = start % capacity_;
+    bool wrapped = offset + slotSize > capacity_;
+    if (wrapped) {
+        start += capacity_ - offset; // slots never cross the end of the buffer
+        offset = 0;
+    }
+    int ret = WaitForSpace(*ring, start + slotSize);
+    if (ret != MKIRT_SUCCESS) {
+        return ret;
+    }
+    uint8_t *hostAddr = ring->hostBase + offset;
+    uint8_t *devAddr = ring->deviceBase + offset;
+    if (memcpy_s(hostAddr, slotSize, hostData, size) != EOK) {
+        MKI_LOG(ERROR) << "tiling ring copy host data fail, size " << size;
+        return MKIRT_ERROR_PARA_CHECK_FAIL;
+    }
+    ret = backend_->MemCopyAsync(devAddr, slotSize, hostAddr, size, MKIRT_MEMCOPY_HOST_TO_DEVICE, stream);
+    if (ret != MKIRT_SUCCESS) {
+        MKI_LOG(ERROR) << "tiling ring async copy fail, ret " << ret;
+        return ret;
+    }
+    ring->head = start + slotSize;
+    stats_.wrapCount += wrapped ? 1 : 0;
+    stats_.uploadCount++;
+    stats_.uploadBytes += size;
+    *deviceAddr = devAddr;
+    return MKIRT_SUCCESS;
+}
+
+int TilingRingBuffer::Commit(MkiRtStream stream)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = rings_.find(stream);
+    if (it == rings_.end() || it->second.committed == it->second.head) {
+        return MKIRT_SUCCESS;
+    }
+    StreamRing &ring = it->second;
+    MkiRtEvent event = GetEvent();
+    int ret = event == nullptr ? MKIRT_ERROR_OUT_OF_MEMORY : backend_->EventRecord(event, stream);
+    if (ret != MKIRT_SUCCESS) {
+        // without a marker the slots can only be reused after the stream is idle
+        MKI_LOG(WARN) << "tiling ring record event fail, ret " << ret << ", synchronize stream";
+        if (event != nullptr) {
+            eventPool_.push_back(event);
+        }
+        ret = backend_->StreamSynchronize(stream);
+        if (ret != MKIRT_SUCCESS) {
+            MKI_LOG(ERROR) << "tiling ring synchronize stream fail, ret " << ret;
+            return ret;
+        }
+        for (Marker &marker : ring.markers) {
+            eventPool_.push_back(marker.event);
+        }
+        ring.markers.clear();
+        ring.tail = ring.head;
+    } else {
+        ring.markers.push_back({event, ring.head});
+    }
+    ring.committed = ring.head;
+    return MKIRT_SUCCESS;
+}
+
+void TilingRingBuffer::FreeRing(StreamRing &ring)
+{
+    for (Marker &marker : ring.markers) {
+        (void)backend_->EventSynchronize(marker.event);
+        eventPool_.push_back(marker.event);
+    }
+    ring.markers.clear();
+    MKI_LOG_IF(ring.committed != ring.head, WARN) << "tiling ring is freed with uncommitted slots";
+    (void)backend_->MemFreeDevice(ring.deviceBase);
+    (void)backend_->MemFreeHost(ring.hostBase);
+}
+
+void TilingRingBuffer::ReleaseStream(MkiRtStream stream)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = rings_.find(stream);
+    if (it == rings_.end()) {
+        return;
+    }
+    FreeRing(it->second);
+    rings_.erase(it);
+    stats_.streamCount--;
+}
+
+TilingRingStats TilingRingBuffer::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+TilingRingBuffer *GetTilingRingBuffer()
+{
+    static std::mutex mutex;
+    static std::unordered_map<Backend *, TilingRingBuffer *> ringBuffers;
+    Backend *backend = BackendFactory::GetBackend();
+    std::lock_guard<std::mutex> lock(mutex);
+    TilingRingBuffer *&ringBuffer = ringBuffers[backend];
+    if (ringBuffer == nullptr) {
+        // never destructed, the runtime may already be finalized when static objects are destroyed
+        uint64_t sizeMb = std::min(GetUintFromEnv("ASDOPS_TILING_RING_SIZE", 0), MAX_RING_SIZE_MB);
+        ringBuffer = new TilingRingBuffer(backend, sizeMb == 0 ? TilingRingBuffer::DEFAULT_CAPACITY : sizeMb * MB_SIZE);
+    }
+    return ringBuffer;
+}
+} // namespace Mki
@@ -51,4 +51,9 @@ int MkiRtFunctionLaunchWithFlag(const void *func, const MkiRtKernelParam *launch
 {
     return BackendFactory::GetBackend()->FunctionLaunchWithFlag(func, launchParam, stream, cfgInfo);
 }
+
+int MkiRtFunctionLaunchBatch(const MkiRtLaunchItem *items, uint32_t count, MkiRtStream stream)
+{
+    return BackendFactory::GetBackend()->FunctionLaunchBatch(items, count, stream);
+}
 }
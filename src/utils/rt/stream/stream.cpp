@@ -11,6 +11,8 @@
  */
 #include "mki/utils/rt/stream/stream.h"
 #include "mki/utils/rt/backend/backend_factory.h"
+#include "mki/utils/rt/memory/caching_allocator.h"
+#include "mki/utils/rt/memory/tiling_ring_buffer.h"
 
 namespace Mki {
 int MkiRtStreamCreate(MkiRtStream *stream, int32_t priority)
@@ -18,7 +20,13 @@ int MkiRtStreamCreate(MkiRtStream *stream, int32_t priority)
     return BackendFactory::GetBackend()->StreamCreate(stream, priority);
 }
 
-int MkiRtStreamDestroy(MkiRtStream stream) { return BackendFactory::GetBackend()->StreamDestroy(stream); }
+int MkiRtStreamDestroy(MkiRtStream stream)
+{
+    // the ring and cached blocks of the stream would leak and a stream reusing the handle would get them
+    GetTilingRingBuffer()->ReleaseStream(stream);
+    GetDeviceCachingAllocator()->ReleaseStream(stream);
+    return BackendFactory::GetBackend()->StreamDestroy(stream);
+}
 
 int MkiRtStreamSynchronize(MkiRtStream stream)
 {
@@ -29,4 +37,39 @@ int MkiRtStreamGetId(MkiRtStream stream, int32_t *streamId)
 {
     return BackendFactory::GetBackend()->StreamGetId(stream, streamId);
 }
+
+int MkiRtEventCreate(MkiRtEvent *event) { return BackendFactory::GetBackend()->EventCreate(event); }
+
+int MkiRtEventDestroy(MkiRtEvent event) { return BackendFactory::GetBackend()->EventDestroy(event); }
+
+int MkiRtEventRecord(MkiRtEvent event, MkiRtStream stream)
+{
+    return BackendFactory::GetBackend()->EventRecord(event, stream);
+}
+
+int MkiRtEventQuery(MkiRtEvent event, bool *completed)
+{
+    return BackendFactory::GetBackend()->EventQuery(event, completed);
+}
+
+int MkiRtEventSynchronize(MkiRtEvent event) { return BackendFactory::GetBackend()->EventSynchronize(event); }
+
+int MkiRtStreamWaitEvent(MkiRtStream stream, MkiRtEvent event)
+{
+    return BackendFactory::GetBackend()->StreamWaitEvent(stream, event);
+}
+
+int MkiRtStreamBeginCapture(MkiRtStream stream) { return BackendFactory::GetBackend()->StreamBeginCapture(stream); }
+
+int MkiRtStreamEndCapture(MkiRtStream stream, MkiRtModel *model)
+{
+    return BackendFactory::GetBackend()->StreamEndCapture(stream, model);
+}
+
+int MkiRtModelExecute(MkiRtModel model, MkiRtStream stream)
+{
+    return BackendFactory::GetBackend()->ModelExecute(model, stream);
+}
+
+int MkiRtModelDestroy(MkiRtModel model) { return BackendFactory::GetBackend()->ModelDestroy(model); }
 }
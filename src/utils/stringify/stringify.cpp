@@ -33,4 +33,9 @@ std::string Stringify::ToString(const Any &param)
     }
     return std::string(param.Type().name()) + std::string(" can not be printed");
 }
+
+bool Stringify::IsRegistered(const Any &param)
+{
+    return converterMap_.find(param.Type().hash_code()) != converterMap_.end();
+}
 } // namespace Mki
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <benchmark/benchmark.h>
+#include "mki/utils/rt/backend/backend_factory.h"
+
+// usage: mki_bench [--benchmark_filter=<regex>] [--benchmark_format=json] [--benchmark_out=<file>]
+int main(int argc, char **argv)
+{
+    // host overhead only: launches go to the mock backend and are not recorded
+    Mki::BackendFactory::SetBackendType(Mki::BackendType::MOCK);
+    Mki::BackendFactory::GetMockBackend()->SetRecordLimit(0);
+    benchmark::AddCustomContext("mki_backend", "mock");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <benchmark/benchmark.h>
+#include <memory>
+#include "mki/base/kernel_base.h"
+#include "mki/base/operation_base.h"
+#include "mki/utils/memset/clear_tensors.h"
+#include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+#include "mki_loader/op_register.h"
+#include "mki_loader/ops.h"
+
+namespace OpSpace {
+using namespace Mki;
+constexpr uint32_t BENCH_TILING_SIZE = 64;
+constexpr uint64_t BENCH_WORKSPACE_SIZE = 1024;
+constexpr int64_t BENCH_DIM = 128;
+constexpr uint64_t BENCH_MEMSET_SIZE = 4096;
+
+// kernel binary layout, see document/bin文件格式设计.md
+struct BenchKernelBinary {
+    uint32_t header[32]; // version, magic, tilingSize, coreType, kernelNum, kernelNameOffset, compileInfoOffset,
+                         // kernelBinOffset
+    uint32_t kernelNameSize;
+    char kernelName[8];
+    uint32_t compileInfoSize;
+    char compileInfo[4];
+    uint32_t codeSize;
+    uint8_t code[16];
+};
+
+static const BenchKernelBinary BENCH_KERNEL_BINARY = {
+    {1, 0x41415246, BENCH_TILING_SIZE, 2, 1, 0, 12, 20}, 8, "bench", 4, "{}", 16, {0}
+};
+
+// 128: memset tiling size
+static const BenchKernelBinary BENCH_MEMSET_BINARY = {
+    {1, 0x41415246, 128, 2, 1, 0, 12, 20}, 8, "memset", 4, "{}", 16, {0}
+};
+
+class BenchOperation : public OperationBase {
+public:
+    explicit BenchOperation(const std::string &opName) noexcept : OperationBase(opName) {}
+
+    Kernel *GetBestKernel(const LaunchParam &launchParam) const override
+    {
+        (void)launchParam;
+        return GetKernelByName("BenchKernel");
+    }
+
+    int64_t GetInputNum(const Any &specificParam) const override
+    {
+        (void)specificParam;
+        return 2; // 2: x, y
+    }
+
+    int64_t GetOutputNum(const Any &specificParam) const override
+    {
+        (void)specificParam;
+        return 1;
+    }
+
+protected:
+    Status InferShapeImpl(const LaunchParam &launchParam, SVector<Tensor> &outTensors) const override
+    {
+        outTensors[0].desc = launchParam.GetInTensor(0).desc;
+        return Status::OkStatus();
+    }
+};
+
+class BenchKernel : public KernelBase {
+public:
+    explicit BenchKernel(const std::string &kernelName, const BinHandle *handle) noexcept
+        : KernelBase(kernelName, handle)
+    {
+    }
+
+    bool CanSupport(const LaunchParam &launchParam) const override
+    {
+        return launchParam.GetInTensorCount() == 2 && launchParam.GetOutTensorCount() == 1; // 2: x, y
+    }
+
+    uint64_t GetTilingSize(const LaunchParam &launchParam) const override
+    {
+        (void)launchParam;
+        return BENCH_TILING_SIZE;
+    }
+
+protected:
+    Status InitImpl(const LaunchParam &launchParam) override
+    {
+        uint32_t *tiling = reinterpret_cast<uint32_t *>(kernelInfo_.GetTilingHostAddr());
+        tiling[0] = static_cast<uint32_t>(launchParam.GetInTensor(0).desc.Numel());
+        kernelInfo_.SetTilingUsedSize(sizeof(uint32_t));
+        kernelInfo_.SetBlockDim(8); // 8: block dim
+        kernelInfo_.GetScratchSizes().push_back(BENCH_WORKSPACE_SIZE);
+        return Status::OkStatus();
+    }
+};
+
+REG_OPERATION(BenchOperation);
+REG_KERNEL_BASE(BenchKernel);
+// the mock backend reports Ascend910B4 by default, see ASDOPS_MOCK_SOC_VERSION
+static KernelBinaryRegister binBenchKernelascend910bregister = KernelBinaryRegister(
+    "ascend910b", "BenchKernel", reinterpret_cast<const uint8_t *>(&BENCH_KERNEL_BINARY), sizeof(BENCH_KERNEL_BINARY));
+// ClearTensors looks the memset kernel up once, without it the bench would measure the aclrtMemset fallback
+static KernelBinaryRegister binMemsetKernelascend910bregister = KernelBinaryRegister(
+    "ascend910b", "MemsetKernel", reinterpret_cast<const uint8_t *>(&BENCH_MEMSET_BINARY), sizeof(BENCH_MEMSET_BINARY));
+
+// kernel and operation owned by the bench, usable without platform configs
+class BenchContext {
+public:
+    static BenchContext &Instance()
+    {
+        static BenchContext context;
+        return context;
+    }
+
+    bool Valid() const { return valid_; }
+    const BenchOperation &GetOperation() const { return operation_; }
+    const BenchKernel &GetKernel() const { return kernel_; }
+    LaunchParam MakeLaunchParam() const
+    {
+        LaunchParam launchParam;
+        launchParam.AddInTensor(MakeTensor(devAddrs_[0]));
+        launchParam.AddInTensor(MakeTensor(devAddrs_[1]));
+        launchParam.AddOutTensor(MakeTensor(devAddrs_[2])); // 2: out
+        return launchParam;
+    }
+    void InitRunInfo(RunInfo &runInfo) const
+    {
+        runInfo.SetStream(stream_);
+        runInfo.SetScratchDeviceAddr(static_cast<uint8_t *>(devAddrs_[3])); // 3: workspace
+        runInfo.SetTilingDeviceAddr(static_cast<uint8_t *>(devAddrs_[4])); // 4: tiling
+    }
+
+private:
+    BenchContext() : handle_(&basicInfo_), kernel_("BenchKernel", &handle_), operation_("BenchOperation")
+    {
+        basicInfo_.binaryBuf = reinterpret_cast<const uint8_t *>(&BENCH_KERNEL_BINARY);
+        basicInfo_.binaryLen = sizeof(BENCH_KERNEL_BINARY);
+        SetKernelSelfCreator(kernel_, [this]() { return new BenchKernel("BenchKernel", &handle_); });
+        operation_.AddKernel("BenchKernel", &kernel_);
+        valid_ = handle_.Init("BenchKernel") && MkiRtStreamCreate(&stream_, 0) == MKIRT_SUCCESS;
+        for (size_t i = 0; valid_ && i < DEV_ADDR_NUM; ++i) {
+            valid_ = MkiRtMemMallocDevice(&devAddrs_[i], BENCH_MEMSET_SIZE, MKIRT_MEM_DEFAULT) == MKIRT_SUCCESS;
+        }
+    }
+
+    static Tensor MakeTensor(void *addr)
+    {
+        Tensor tensor;
+        tensor.desc.dtype = TENSOR_DTYPE_FLOAT16;
+        tensor.desc.format = TENSOR_FORMAT_ND;
+        tensor.desc.dims = {BENCH_DIM, BENCH_DIM};
+        tensor.data = addr;
+        return tensor;
+    }
+
+private:
+    static constexpr size_t DEV_ADDR_NUM = 5;
+    BinaryBasicInfo basicInfo_;
+    BinHandle handle_;
+    BenchKernel kernel_;
+    BenchOperation operation_;
+    MkiRtStream stream_ = nullptr;
+    void *devAddrs_[DEV_ADDR_NUM] = {nullptr};
+    bool valid_ = false;
+};
+
+#define BENCH_CHECK(state, cond, msg) \
+    if (!(cond)) {                    \
+        (state).SkipWithError(msg);   \
+        return;                       \
+    }
+
+static void BM_OpsGetOperationByName(benchmark::State &state)
+{
+    const Ops &ops = Ops::Instance();
+    BENCH_CHECK(state, ops.GetOperationByName("BenchOperation") != nullptr,
+                "ops are not loaded, check platform configs under ASDOPS_HOME_PATH");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ops.GetOperationByName("BenchOperation"));
+    }
+}
+BENCHMARK(BM_OpsGetOperationByName);
+
+static void BM_OpsGetKernelInstance(benchmark::State &state)
+{
+    const Ops &ops = Ops::Instance();
+    std::unique_ptr<Kernel> kernel(ops.GetKernelInstance("BenchKernel"));
+    BENCH_CHECK(state, kernel != nullptr, "ops are not loaded, check platform configs under ASDOPS_HOME_PATH");
+    for (auto _ : state) {
+        kernel.reset(ops.GetKernelInstance("BenchKernel"));
+    }
+}
+BENCHMARK(BM_OpsGetKernelInstance);
+
+static void BM_OpsAcquireKernelInstance(benchmark::State &state)
+{
+    const Ops &ops = Ops::Instance();
+    BENCH_CHECK(state, ops.AcquireKernelInstance("BenchKernel") != nullptr,
+                "ops are not loaded, check platform configs under ASDOPS_HOME_PATH");
+    for (auto _ : state) {
+        PooledKernel kernel = ops.AcquireKernelInstance("BenchKernel");
+        benchmark::DoNotOptimize(kernel.get());
+    }
+}
+BENCHMARK(BM_OpsAcquireKernelInstance);
+
+static void BM_OperationInferShape(benchmark::State &state)
+{
+    BenchContext &context = BenchContext::Instance();
+    BENCH_CHECK(state, context.Valid(), "bench context init fail");
+    LaunchParam launchParam = context.MakeLaunchParam();
+    for (auto _ : state) {
+        Status status = context.GetOperation().InferShape(launchParam);
+        benchmark::DoNotOptimize(status);
+    }
+}
+BENCHMARK(BM_OperationInferShape);
+
+static void BM_KernelClone(benchmark::State &state)
+{
+    BenchContext &context = BenchContext::Instance();
+    BENCH_CHECK(state, context.Valid(), "bench context init fail");
+    for (auto _ : state) {
+        std::unique_ptr<Kernel> kernel(context.GetKernel().Clone());
+        benchmark::DoNotOptimize(kernel.get());
+    }
+}
+BENCHMARK(BM_KernelClone);
+
+// cold: every Init runs tiling; warm: Init is served by the tiling cache
+static void BM_KernelInit(benchmark::State &state)
+{
+    BenchContext &context = BenchContext::Instance();
+    BENCH_CHECK(state, context.Valid(), "bench context init fail");
+    std::unique_ptr<Kernel> kernel(context.GetKernel().Clone());
+    kernel->SetTilingCacheCapacity(static_cast<size_t>(state.range(0)));
+    LaunchParam launchParam = context.MakeLaunchParam();
+    BENCH_CHECK(state, kernel->Init(launchParam).Ok(), "kernel init fail");
+    for (auto _ : state) {
+        Status status = kernel->Init(launchParam);
+        benchmark::DoNotOptimize(status);
+    }
+    state.SetLabel(state.range(0) == 0 ? "cold" : "warm");
+}
+BENCHMARK(BM_KernelInit)->Arg(0)->Arg(1);
+
+// kernel args are built on every Run, or only patched when args are frozen
+static void BM_KernelRun(benchmark::State &state)
+{
+    BenchContext &context = BenchContext::Instance();
+    BENCH_CHECK(state, context.Valid(), "bench context init fail");
+    std::unique_ptr<Kernel> kernel(context.GetKernel().Clone());
+    kernel->SetArgsFrozen(state.range(0) != 0);
+    LaunchParam launchParam = context.MakeLaunchParam();
+    RunInfo runInfo;
+    context.InitRunInfo(runInfo);
+    BENCH_CHECK(state, kernel->Init(launchParam).Ok(), "kernel init fail");
+    BENCH_CHECK(state, kernel->Run(launchParam, runInfo).Ok(), "kernel run fail");
+    for (auto _ : state) {
+        Status status = kernel->Run(launchParam, runInfo);
+        benchmark::DoNotOptimize(status);
+    }
+    state.SetLabel(state.range(0) == 0 ? "build args" : "frozen args");
+}
+BENCHMARK(BM_KernelRun)->Arg(0)->Arg(1);
+
+static void BM_ClearTensors(benchmark::State &state)
+{
+    BenchContext &context = BenchContext::Instance();
+    BENCH_CHECK(state, context.Valid(), "bench context init fail");
+    LaunchParam launchParam = context.MakeLaunchParam();
+    RunInfo runInfo;
+    context.InitRunInfo(runInfo);
+    KernelInfo kernelInfo;
+    void *args[3] = {launchParam.GetInTensor(0).data, launchParam.GetInTensor(1).data,
+                     launchParam.GetOutTensor(0).data};
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        kernelInfo.SetMemsetInfo(static_cast<uint64_t>(i), BENCH_MEMSET_SIZE);
+    }
+    const auto &memsetInfo = kernelInfo.GetMemsetInfo();
+    uint64_t launchCount = BackendFactory::GetMockBackend()->GetLaunchCount();
+    BENCH_CHECK(state, ClearTensors(args, 3, memsetInfo, runInfo.GetStream()).Ok(), "clear tensors fail");
+    BENCH_CHECK(state, BackendFactory::GetMockBackend()->GetLaunchCount() == launchCount + 1,
+                "memset kernel is not launched, check platform configs of the mock soc");
+    for (auto _ : state) {
+        Status status = ClearTensors(args, 3, memsetInfo, runInfo.GetStream());
+        benchmark::DoNotOptimize(status);
+    }
+}
+BENCHMARK(BM_ClearTensors)->DenseRange(1, 3);
+} // namespace OpSpace
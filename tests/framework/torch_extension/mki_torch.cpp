@@ -19,6 +19,8 @@
 #include "mki/utils/log/log.h"
 #include "mki/utils/status/status.h"
 #include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/memory/caching_allocator.h"
+#include "mki/utils/rt/memory/pinned_host_pool.h"
 #include "op_desc_json.h"
 
 static std::map<at::ScalarType, Mki::TensorDType> DTYPE_MAP = {
@@ -162,11 +164,12 @@ std::string MkiTorch::AddWorkspace(const Mki::KernelInfo &kernelInfo, Mki::RunIn
     }
     MKI_LOG(INFO) << "Workspace size: " << bufferSize;
     uint8_t *deviceBuffer = nullptr;
-    int ret = Mki::MkiRtMemMallocDevice(reinterpret_cast<void **>(&deviceBuffer), bufferSize, MKIRT_MEM_DEFAULT);
+    int ret = Mki::GetDeviceCachingAllocator()->Allocate(reinterpret_cast<void **>(&deviceBuffer), bufferSize,
+                                                         runInfo.GetStream());
     if (ret != MKIRT_SUCCESS) {
-        MKI_LOG(ERROR) << "MkiRtMemMallocDevice fail, errCode:" << ret << ", errName:" << Mki::MkiRtErrorName(ret)
+        MKI_LOG(ERROR) << "allocate workspace fail, errCode:" << ret << ", errName:" << Mki::MkiRtErrorName(ret)
                        << "errDesc:" << Mki::MkiRtErrorDesc(ret);
-        return "error:MkiRtMemMallocDevice fail";
+        return "error:allocate workspace fail";
     }
     runInfo.SetScratchDeviceAddr(deviceBuffer);
     return "ok";
@@ -180,7 +183,7 @@ std::string MkiTorch::FreeWorkspace(const Mki::KernelInfo &kernelInfo, Mki::RunI
         return "ok";
     }
     if (deviceBuffer != nullptr) {
-        Mki::MkiRtMemFreeDevice(deviceBuffer);
+        Mki::GetDeviceCachingAllocator()->Free(deviceBuffer);
     }
     return "ok";
 }
@@ -192,24 +195,43 @@ std::string MkiTorch::InitTilingAtMkiTorch(std::shared_ptr<Mki::Kernel> kernel,
     uint32_t launchBufferSize = kernel->GetTilingSize(launchParam);
     MKI_CHECK(launchBufferSize > 0, "empty tiling size", return "empty tiling size");
 
-    uint8_t hostLaunchBuffer[launchBufferSize];
-    kernel->SetTilingHostAddr(hostLaunchBuffer, launchBufferSize);
+    // tiling device memory is not set, kernel uploads the tiling to the ring of the stream in Run
+    hostLaunchBuffer_ = Mki::GetPinnedHostPool()->Allocate(launchBufferSize);
+    MKI_CHECK(hostLaunchBuffer_ != nullptr, "allocate host tiling buffer error",
+              return "allocate host tiling buffer error");
+    hostLaunchBufferSize_ = launchBufferSize;
+    kernel->SetTilingHostAddr(hostLaunchBuffer_, launchBufferSize);
     auto status = kernel->Init(launchParam);
-    MKI_CHECK(status.Ok(), "failed to init op", return "failed to init op");
-
-    int st = Mki::MkiRtMemMallocDevice(reinterpret_cast<void **>(&deviceLaunchBuffer_),
-                                       launchBufferSize, MKIRT_MEM_DEFAULT);
-    MKI_CHECK(st == MKIRT_SUCCESS, "MkiRtMemMallocDevice error", return "MkiRtMemMallocDevice error");
-
-    st = Mki::MkiRtMemCopy(deviceLaunchBuffer_, launchBufferSize,
-                           hostLaunchBuffer, launchBufferSize, MKIRT_MEMCOPY_HOST_TO_DEVICE);
-    if (st != MKIRT_SUCCESS) {
-        Mki::MkiRtMemFreeDevice(deviceLaunchBuffer_);
-        deviceLaunchBuffer_ = nullptr;
-        MKI_LOG(ERROR) << "MkiRtMemCopy error";
-        return "MkiRtMemCopy error";
+    if (!status.Ok()) {
+        FreeLaunchBuffer();
+        MKI_LOG(ERROR) << "failed to init op";
+        return "failed to init op";
+    }
+    runInfo.SetTilingDeviceAddr(nullptr);
+    return "ok";
+}
+
+void MkiTorch::FreeLaunchBuffer()
+{
+    if (hostLaunchBuffer_ != nullptr) {
+        Mki::GetPinnedHostPool()->Deallocate(hostLaunchBuffer_, hostLaunchBufferSize_);
+        hostLaunchBuffer_ = nullptr;
+        hostLaunchBufferSize_ = 0;
+    }
+}
+
+// copies queued on the stream may still read the pinned buffers, they go back to the pool after the stream drains
+std::string MkiTorch::SyncAndFreeLaunchBuffer(MkiRtStream stream)
+{
+    int ret = Mki::MkiRtStreamSynchronize(stream);
+    MKI_LOG_IF(ret != 0, ERROR) << "MkiRtStreamSynchronize fail";
+    if (ret != 0) {
+        // the stream may not have drained, leak the buffer instead of letting the pool reuse it
+        hostLaunchBuffer_ = nullptr;
+        hostLaunchBufferSize_ = 0;
+        return "MkiRtStreamSynchronize fail";
     }
-    runInfo.SetTilingDeviceAddr(deviceLaunchBuffer_);
+    FreeLaunchBuffer();
     return "ok";
 }
 
@@ -220,6 +242,8 @@ std::string MkiTorch::RunOp(Mki::LaunchParam &launchParam)
 
     std::shared_ptr<Mki::Kernel> kernel(GetKernelInstance(launchParam));
     MKI_CHECK(kernel != nullptr, "failed to get kernel instance", return "failed to init op");
+    // args, tiling and tensorList buffers of the kernel are uploaded from page-locked memory
+    kernel->SetHostAllocator(Mki::GetPinnedHostPool());
 
     Mki::RunInfo runInfo;
     MkiRtStream stream = GetCurrentStream();
@@ -231,13 +255,17 @@ std::string MkiTorch::RunOp(Mki::LaunchParam &launchParam)
         status = kernel->Init(launchParam);
         MKI_CHECK(status.Ok(), "failed to init op", return "failed to init op");
     } else {
-        InitTilingAtMkiTorch(kernel, launchParam, runInfo);
+        retStr = InitTilingAtMkiTorch(kernel, launchParam, runInfo);
         MKI_CHECK(retStr == "ok", "failed to init tiling in mkiTorch", return retStr);
     }
 
     const Mki::KernelInfo &kernelInfo = kernel->GetKernelInfo();
     retStr = AddWorkspace(kernelInfo, runInfo);
-    MKI_CHECK(retStr == "ok", "failed to add workspace", return retStr);
+    if (retStr != "ok") {
+        FreeLaunchBuffer();
+        MKI_LOG(ERROR) << "failed to add workspace";
+        return retStr;
+    }
 
     MKI_LOG(INFO) << kernel->GetName() << " run start, LaunchParam:\n" << launchParam.ToString();
     MKI_LOG(INFO) << "RunInfo:\n" << runInfo.ToString();
@@ -245,17 +273,15 @@ std::string MkiTorch::RunOp(Mki::LaunchParam &launchParam)
     status = kernel->Run(launchParam, runInfo);
     MKI_LOG_IF(!status.Ok(), ERROR) << kernel->GetName() << " run fail, error:" << status.ToString();
     if (!status.Ok()) {
+        if (SyncAndFreeLaunchBuffer(runInfo.GetStream()) == "ok") {
+            (void)FreeWorkspace(kernelInfo, runInfo);
+        }
         return "kernel run fail";
     }
 
-    int ret = Mki::MkiRtStreamSynchronize(runInfo.GetStream());
-    MKI_LOG_IF(ret != 0, ERROR) << "MkiRtStreamSynchronize fail";
-    if (ret != 0) {
-        return "MkiRtStreamSynchronize fail";
-    }
-
-    if (deviceLaunchBuffer_ != nullptr) {
-        Mki::MkiRtMemFreeDevice(deviceLaunchBuffer_);
+    retStr = SyncAndFreeLaunchBuffer(runInfo.GetStream());
+    if (retStr != "ok") {
+        return retStr;
     }
 
     retStr = FreeWorkspace(kernelInfo, runInfo);
@@ -272,6 +298,8 @@ std::string MkiTorch::RunOpPerf(Mki::LaunchParam &launchParam, int runTimes)
 
     std::shared_ptr<Mki::Kernel> kernel(GetKernelInstance(launchParam, kernelName_));
     MKI_CHECK(kernel != nullptr, "failed to get kernel instance", return "failed to init op");
+    // args, tiling and tensorList buffers of the kernel are uploaded from page-locked memory
+    kernel->SetHostAllocator(Mki::GetPinnedHostPool());
 
     Mki::RunInfo runInfo;
     MkiRtStream stream = GetCurrentStream();
@@ -283,39 +311,43 @@ std::string MkiTorch::RunOpPerf(Mki::LaunchParam &launchParam, int runTimes)
         status = kernel->Init(launchParam);
         MKI_CHECK(status.Ok(), "failed to run tiling", return "failed to run tiling");
     } else {
-        InitTilingAtMkiTorch(kernel, launchParam, runInfo);
+        retStr = InitTilingAtMkiTorch(kernel, launchParam, runInfo);
         MKI_CHECK(retStr == "ok", "failed to init tiling in mkiTorch", return retStr);
     }
 
     const Mki::KernelInfo &kernelInfo = kernel->GetKernelInfo();
     retStr = AddWorkspace(kernelInfo, runInfo);
-    MKI_CHECK(retStr == "ok", "failed to add workspace", return retStr);
+    if (retStr != "ok") {
+        FreeLaunchBuffer();
+        MKI_LOG(ERROR) << "failed to add workspace";
+        return retStr;
+    }
 
     MKI_LOG(INFO) << kernel->GetName() << " run start, runInfo:\n" << runInfo.ToString();
 
     for (int runIdx = 0; runIdx < runTimes; runIdx++) {
         retStr = GetTensorsFromBuf(launchParam.GetInTensors());
-        MKI_CHECK(retStr == "ok", "failed to save tensors to buffer", return retStr);
+        if (retStr != "ok") {
+            MKI_LOG(ERROR) << "failed to save tensors to buffer";
+            if (SyncAndFreeLaunchBuffer(runInfo.GetStream()) == "ok") {
+                (void)FreeWorkspace(kernelInfo, runInfo);
+            }
+            return retStr;
+        }
 
         status = kernel->Run(launchParam, runInfo);
         MKI_LOG_IF(!status.Ok(), ERROR) << kernel->GetName() << " run fail, error:" << status.ToString();
         if (!status.Ok()) {
-            if (deviceLaunchBuffer_ != nullptr) {
-                Mki::MkiRtMemFreeDevice(deviceLaunchBuffer_);
+            if (SyncAndFreeLaunchBuffer(runInfo.GetStream()) == "ok") {
+                (void)FreeWorkspace(kernelInfo, runInfo);
             }
-            retStr = FreeWorkspace(kernelInfo, runInfo);
             return "kernel run fail";
         }
     }
 
-    int ret = Mki::MkiRtStreamSynchronize(runInfo.GetStream());
-    MKI_LOG_IF(ret != 0, ERROR) << "MkiRtStreamSynchronize fail";
-    if (ret != 0) {
-        return "MkiRtStreamSynchronize fail";
-    }
-
-    if (deviceLaunchBuffer_ != nullptr) {
-        Mki::MkiRtMemFreeDevice(deviceLaunchBuffer_);
+    retStr = SyncAndFreeLaunchBuffer(runInfo.GetStream());
+    if (retStr != "ok") {
+        return retStr;
     }
 
     retStr = FreeWorkspace(kernelInfo, runInfo);
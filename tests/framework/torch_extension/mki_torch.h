@@ -51,11 +51,14 @@ private:
 
     std::string InitTilingAtMkiTorch(std::shared_ptr<Mki::Kernel> kernel, const Mki::LaunchParam &launchParam,
                                      Mki::RunInfo &runInfo);
+    void FreeLaunchBuffer();
+    std::string SyncAndFreeLaunchBuffer(MkiRtStream stream);
 
 private:
     bool perfFlag_{false};
     bool launchWithTiling_{true};
-    uint8_t *deviceLaunchBuffer_{nullptr};
+    uint8_t *hostLaunchBuffer_{nullptr};
+    uint64_t hostLaunchBufferSize_{0};
     uint8_t *tensorTempBufList_[20];
     std::string opDescJsonStr_{""};
     std::string opName_{""};
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "mki/bin_handle.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+
+namespace Mki {
+constexpr uint32_t TEST_HEADER_LENGTH = 128;
+constexpr uint32_t TEST_TILING_SIZE = 60;
+constexpr uint32_t TEST_CORE_TYPE = 2;
+
+static void AppendSection(std::vector<uint8_t> &binary, const char *data, uint32_t size)
+{
+    binary.insert(binary.end(), reinterpret_cast<const uint8_t *>(&size),
+                  reinterpret_cast<const uint8_t *>(&size) + sizeof(size));
+    std::vector<uint8_t> section(size, 0);
+    memcpy(section.data(), data, std::min<size_t>(strlen(data), size));
+    binary.insert(binary.end(), section.begin(), section.end());
+}
+
+// header: version, magic, tilingSize, coreType, kernelNum, kernelNameOffset, compileInfoOffset, kernelBinOffset
+static std::vector<uint8_t> MakeKernelBinary()
+{
+    uint32_t header[] = {1, 0x41415246, TEST_TILING_SIZE, TEST_CORE_TYPE, 1, 0, 12, 20};
+    std::vector<uint8_t> binary(TEST_HEADER_LENGTH, 0);
+    memcpy(binary.data(), header, sizeof(header));
+    AppendSection(binary, "kernel", 8);
+    AppendSection(binary, "{}", 4);
+    AppendSection(binary, "code", 16);
+    return binary;
+}
+
+TEST(BinHandleTest, LazyRegister)
+{
+    std::vector<uint8_t> binary = MakeKernelBinary();
+    BinaryBasicInfo basicInfo;
+    basicInfo.binaryBuf = binary.data();
+    basicInfo.binaryLen = binary.size();
+    BinHandle handle(&basicInfo);
+    ASSERT_TRUE(handle.Init("LazyKernel", true));
+    EXPECT_FALSE(handle.IsRegistered());
+    EXPECT_EQ(handle.GetKernelTilingSize(), 64);
+    EXPECT_EQ(handle.GetKernelCoreType(), TEST_CORE_TYPE);
+    EXPECT_STREQ(handle.GetKernelCompileInfo(), "{}");
+
+    // registration result depends on device, but it must happen only once across threads
+    std::vector<std::thread> threads;
+    std::vector<int> results(4, -1);
+    for (size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&handle, &results, i]() { results[i] = handle.EnsureRegistered() ? 1 : 0; });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (int result : results) {
+        EXPECT_EQ(result, handle.IsRegistered() ? 1 : 0);
+    }
+    EXPECT_EQ(handle.EnsureRegistered(), handle.IsRegistered());
+}
+
+// header with compressType 1 (lz4) and rawBinSize, code section is an lz4 block of "codecodecodecode"
+static std::vector<uint8_t> MakeCompressedKernelBinary(uint32_t compressType)
+{
+    uint32_t header[] = {1, 0x41415246, TEST_TILING_SIZE, TEST_CORE_TYPE, 1, 0, 12, 20, 0, 0, compressType, 16};
+    std::vector<uint8_t> binary(TEST_HEADER_LENGTH, 0);
+    memcpy(binary.data(), header, sizeof(header));
+    AppendSection(binary, "kernel", 8);
+    AppendSection(binary, "{}", 4);
+    std::vector<uint8_t> block = {0x44, 'c', 'o', 'd', 'e', 0x04, 0x00, 0x40, 'c', 'o', 'd', 'e'};
+    uint32_t blockSize = block.size();
+    binary.insert(binary.end(), reinterpret_cast<const uint8_t *>(&blockSize),
+                  reinterpret_cast<const uint8_t *>(&blockSize) + sizeof(blockSize));
+    binary.insert(binary.end(), block.begin(), block.end());
+    return binary;
+}
+
+TEST(BinHandleTest, CompressedBinary)
+{
+    std::vector<uint8_t> binary = MakeCompressedKernelBinary(1);
+    BinaryBasicInfo basicInfo;
+    basicInfo.binaryBuf = binary.data();
+    basicInfo.binaryLen = binary.size();
+    BinHandle handle(&basicInfo);
+    ASSERT_TRUE(handle.Init("CompressedKernel", true));
+    EXPECT_EQ(handle.GetKernelTilingSize(), 64);
+    EXPECT_STREQ(handle.GetKernelCompileInfo(), "{}");
+    // the code is decompressed into a temporary buffer while it is registered
+    BackendType backendType = BackendFactory::GetBackendType();
+    BackendFactory::SetBackendType(BackendType::MOCK);
+    EXPECT_TRUE(handle.EnsureRegistered());
+    EXPECT_TRUE(handle.IsRegistered());
+    BackendFactory::SetBackendType(backendType);
+
+    std::vector<uint8_t> unknown = MakeCompressedKernelBinary(2);
+    basicInfo.binaryBuf = unknown.data();
+    basicInfo.binaryLen = unknown.size();
+    BinHandle unknownHandle(&basicInfo);
+    EXPECT_FALSE(unknownHandle.Init("UnknownCompressKernel", true));
+}
+} // namespace Mki
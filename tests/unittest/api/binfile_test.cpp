@@ -9,6 +9,7 @@
  * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
  * See the Mulan PSL v2 for more details.
  */
+#include <cstring>
 #include <gtest/gtest.h>
 #include "mki/utils/bin_file/bin_file.h"
 #include "mki/utils/file_system/file_system.h"
@@ -226,4 +227,106 @@ TEST(BinFileTest, changeObjectLength)
         FileSystem::DeleteFile("4.bin");
     }
 }
+
+TEST(BinFileTest, readMapped)
+{
+    {
+        BinFile binFile;
+        binFile.AddAttr("attr1", "3");
+        char objBuffer1[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        char objBuffer2[5000];
+        for (size_t i = 0; i < sizeof(objBuffer2); i++) {
+            objBuffer2[i] = static_cast<char>(i);
+        }
+        binFile.AddObject("obj1", objBuffer1, sizeof(objBuffer1));
+        binFile.AddObject("obj2", objBuffer2, sizeof(objBuffer2));
+        binFile.Write("5.bin");
+    }
+    BinFile copyFile;
+    ASSERT_TRUE(copyFile.Read("5.bin").Ok());
+    EXPECT_FALSE(copyFile.IsMapped());
+    std::vector<std::pair<std::string, BinObjectSpan>> copyObjs;
+    copyFile.GetAllObjectSpans(copyObjs);
+    ASSERT_EQ(copyObjs.size(), 2);
+
+    for (auto advice : {BinFileMapAdvice::NONE, BinFileMapAdvice::POPULATE, BinFileMapAdvice::WILLNEED,
+                        BinFileMapAdvice::SEQUENTIAL}) {
+        BinFile binFile;
+        ASSERT_TRUE(binFile.ReadMapped("5.bin", advice).Ok());
+        EXPECT_TRUE(binFile.IsMapped());
+        EXPECT_FALSE(binFile.ReadMapped("5.bin").Ok());
+        std::vector<std::pair<std::string, std::string>> attrMap;
+        binFile.GetAllAttrs(attrMap);
+        ASSERT_EQ(attrMap.size(), 1);
+        EXPECT_EQ(attrMap[0].second, "3");
+
+        std::vector<std::pair<std::string, BinObjectSpan>> objs;
+        binFile.GetAllObjectSpans(objs);
+        ASSERT_EQ(objs.size(), copyObjs.size());
+        for (size_t i = 0; i < objs.size(); i++) {
+            EXPECT_EQ(objs[i].first, copyObjs[i].first);
+            ASSERT_EQ(objs[i].second.length, copyObjs[i].second.length);
+            EXPECT_EQ(memcmp(objs[i].second.data, copyObjs[i].second.data, objs[i].second.length), 0);
+        }
+
+        std::vector<std::pair<std::string, std::pair<char *, uint64_t>>> objMap;
+        binFile.GetAllObjects(objMap);
+        ASSERT_EQ(objMap.size(), 2);
+        EXPECT_EQ(objMap[0].second.first, objs[0].second.data);
+        char objBuffer[1] = {0};
+        EXPECT_FALSE(binFile.AddObject("obj3", objBuffer, sizeof(objBuffer)).Ok());
+    }
+
+    {
+        // writes through the mapping stay private, rewriting a mapped file keeps its objects
+        BinFile binFile;
+        ASSERT_TRUE(binFile.ReadMapped("5.bin").Ok());
+        std::vector<std::pair<std::string, std::pair<char *, uint64_t>>> objMap;
+        binFile.GetAllObjects(objMap);
+        objMap[0].second.first[0] = 100;
+        ASSERT_TRUE(binFile.Write("6.bin").Ok());
+
+        BinFile origFile;
+        ASSERT_TRUE(origFile.ReadMapped("5.bin").Ok());
+        std::vector<std::pair<std::string, BinObjectSpan>> objs;
+        origFile.GetAllObjectSpans(objs);
+        EXPECT_EQ(objs[0].second.data[0], 1);
+
+        BinFile newFile;
+        ASSERT_TRUE(newFile.Read("6.bin").Ok());
+        objs.clear();
+        newFile.GetAllObjectSpans(objs);
+        ASSERT_EQ(objs.size(), 2);
+        EXPECT_EQ(objs[0].second.data[0], 100);
+        EXPECT_EQ(objs[1].second.length, 5000);
+        EXPECT_EQ(objs[1].second.data[4999], static_cast<char>(4999));
+    }
+    FileSystem::DeleteFile("5.bin");
+    FileSystem::DeleteFile("6.bin");
+}
+
+TEST(BinFileTest, readMappedInvalid)
+{
+    {
+        std::string binData;
+        binData.append("$Version=1.0\n");
+        binData.append("$Object.Length=8\n");
+        binData.append("$Object.Tactic1=0,8\n");
+        binData.append("$End=1\n");
+        binData.append("1234");
+        FileSystem::WriteFile(binData.data(), binData.size(), "7.bin");
+    }
+    {
+        BinFile binFile;
+        EXPECT_FALSE(binFile.ReadMapped("7.bin").Ok());
+        EXPECT_FALSE(binFile.IsMapped());
+    }
+    {
+        std::string binData = "$Version=1.0\n$Object.Length=0\n";
+        FileSystem::WriteFile(binData.data(), binData.size(), "7.bin");
+        BinFile binFile;
+        EXPECT_FALSE(binFile.ReadMapped("7.bin").Ok());
+    }
+    FileSystem::DeleteFile("7.bin");
+}
 } // namespace Mki
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+#include "mki/utils/rt/memory/caching_allocator.h"
+
+namespace Mki {
+constexpr uint64_t TEST_MB = 1048576;
+
+class CachingAllocatorTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        backend_ = BackendFactory::GetMockBackend();
+        memUsed_ = backend_->GetDeviceMemoryUsed();
+        ASSERT_EQ(backend_->StreamCreate(&stream1_, 0), MKIRT_SUCCESS);
+        ASSERT_EQ(backend_->StreamCreate(&stream2_, 0), MKIRT_SUCCESS);
+    }
+    void TearDown() override
+    {
+        backend_->SetEventDeferred(false);
+        (void)backend_->StreamDestroy(stream1_);
+        (void)backend_->StreamDestroy(stream2_);
+    }
+
+    MockBackend *backend_ = nullptr;
+    uint64_t memUsed_ = 0;
+    MkiRtStream stream1_ = nullptr;
+    MkiRtStream stream2_ = nullptr;
+};
+
+TEST_F(CachingAllocatorTest, ReuseAndCoalesce)
+{
+    {
+        DeviceCachingAllocator allocator(backend_);
+        void *a = nullptr;
+        void *b = nullptr;
+        void *c = nullptr;
+        ASSERT_EQ(allocator.Allocate(&a, 1000, stream1_), MKIRT_SUCCESS);
+        ASSERT_EQ(allocator.Allocate(&b, 1024, stream1_), MKIRT_SUCCESS);
+        ASSERT_EQ(allocator.Allocate(&c, 100, stream1_), MKIRT_SUCCESS);
+        // small blocks are carved from one 2MB segment
+        EXPECT_EQ(static_cast<uint8_t *>(b), static_cast<uint8_t *>(a) + 1024);
+        EXPECT_EQ(static_cast<uint8_t *>(c), static_cast<uint8_t *>(b) + 1024);
+        EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_ + DeviceCachingAllocator::SMALL_SEGMENT_SIZE);
+
+        DeviceAllocatorStats stats = allocator.GetStats();
+        EXPECT_EQ(stats.allocatedBytes, 2560);
+        EXPECT_EQ(stats.reservedBytes, DeviceCachingAllocator::SMALL_SEGMENT_SIZE);
+        EXPECT_EQ(stats.backendMallocCount, 1);
+        EXPECT_EQ(stats.cacheHitCount, 2);
+
+        // a and c free around b leave two holes
+        ASSERT_EQ(allocator.Free(a), MKIRT_SUCCESS);
+        stats = allocator.GetStats();
+        EXPECT_EQ(stats.cachedFreeBytes, DeviceCachingAllocator::SMALL_SEGMENT_SIZE - 1536);
+        EXPECT_GT(stats.Fragmentation(), 0);
+
+        // b and c coalesce with a and the tail into the whole segment
+        ASSERT_EQ(allocator.Free(b), MKIRT_SUCCESS);
+        ASSERT_EQ(allocator.Free(c), MKIRT_SUCCESS);
+        stats = allocator.GetStats();
+        EXPECT_EQ(stats.allocatedBytes, 0);
+        EXPECT_EQ(stats.largestFreeBlock, DeviceCachingAllocator::SMALL_SEGMENT_SIZE);
+        EXPECT_EQ(stats.Fragmentation(), 0);
+
+        void *d = nullptr;
+        ASSERT_EQ(allocator.Allocate(&d, 3000, stream1_), MKIRT_SUCCESS);
+        EXPECT_EQ(d, a);
+        EXPECT_EQ(allocator.Free(d), MKIRT_SUCCESS);
+        EXPECT_NE(allocator.Free(d), MKIRT_SUCCESS);
+        stats = allocator.GetStats();
+        EXPECT_EQ(stats.backendMallocCount, 1);
+        EXPECT_DOUBLE_EQ(stats.CacheHitRate(), 0.75);
+
+        void *zero = &d;
+        EXPECT_EQ(allocator.Allocate(&zero, 0, stream1_), MKIRT_SUCCESS);
+        EXPECT_EQ(zero, nullptr);
+    }
+    EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_);
+}
+
+TEST_F(CachingAllocatorTest, PerStreamAndLarge)
+{
+    DeviceCachingAllocator allocator(backend_);
+    void *a = nullptr;
+    ASSERT_EQ(allocator.Allocate(&a, 4096, stream1_), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Free(a), MKIRT_SUCCESS);
+    // cached block of stream1 is not handed to stream2
+    void *b = nullptr;
+    ASSERT_EQ(allocator.Allocate(&b, 4096, stream2_), MKIRT_SUCCESS);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(allocator.GetStats().segmentCount, 2);
+    ASSERT_EQ(allocator.Free(b), MKIRT_SUCCESS);
+
+    // large request gets its own segment rounded to 2MB, a tail not larger than 1MB is not split
+    void *large = nullptr;
+    ASSERT_EQ(allocator.Allocate(&large, 3 * TEST_MB, stream1_), MKIRT_SUCCESS);
+    DeviceAllocatorStats stats = allocator.GetStats();
+    EXPECT_EQ(stats.allocatedBytes, 4 * TEST_MB);
+    EXPECT_EQ(stats.reservedBytes, 2 * DeviceCachingAllocator::SMALL_SEGMENT_SIZE + 4 * TEST_MB);
+    ASSERT_EQ(allocator.Free(large), MKIRT_SUCCESS);
+    void *large2 = nullptr;
+    ASSERT_EQ(allocator.Allocate(&large2, 2 * TEST_MB + 1, stream1_), MKIRT_SUCCESS);
+    EXPECT_EQ(large2, large);
+    ASSERT_EQ(allocator.Free(large2), MKIRT_SUCCESS);
+
+    allocator.Trim();
+    stats = allocator.GetStats();
+    EXPECT_EQ(stats.reservedBytes, 0);
+    EXPECT_EQ(stats.segmentCount, 0);
+    EXPECT_EQ(stats.backendFreeCount, 3);
+    EXPECT_EQ(stats.peakReservedBytes, 2 * DeviceCachingAllocator::SMALL_SEGMENT_SIZE + 4 * TEST_MB);
+    EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_);
+}
+
+TEST_F(CachingAllocatorTest, RecordStream)
+{
+    DeviceCachingAllocator allocator(backend_);
+    backend_->SetEventDeferred(true);
+    void *a = nullptr;
+    ASSERT_EQ(allocator.Allocate(&a, 4096, stream1_), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.RecordStream(a, stream2_), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Free(a), MKIRT_SUCCESS);
+    EXPECT_EQ(allocator.GetStats().pendingFreeBytes, 4096);
+
+    // stream2 may still read a, so it is not reused
+    void *b = nullptr;
+    ASSERT_EQ(allocator.Allocate(&b, 4096, stream1_), MKIRT_SUCCESS);
+    EXPECT_NE(a, b);
+    ASSERT_EQ(allocator.Free(b), MKIRT_SUCCESS);
+
+    backend_->CompleteEvents();
+    void *c = nullptr;
+    ASSERT_EQ(allocator.Allocate(&c, 8192, stream1_), MKIRT_SUCCESS);
+    EXPECT_EQ(c, a);
+    EXPECT_EQ(allocator.GetStats().pendingFreeBytes, 0);
+    ASSERT_EQ(allocator.Free(c), MKIRT_SUCCESS);
+    EXPECT_NE(allocator.RecordStream(c, stream2_), MKIRT_SUCCESS);
+}
+
+TEST_F(CachingAllocatorTest, MemoryLimit)
+{
+    DeviceCachingAllocator allocator(backend_);
+    allocator.SetMemoryLimit(4 * TEST_MB);
+    EXPECT_EQ(allocator.GetMemoryLimit(), 4 * TEST_MB);
+    void *large = nullptr;
+    ASSERT_EQ(allocator.Allocate(&large, 3 * TEST_MB, stream1_), MKIRT_SUCCESS);
+    void *small = nullptr;
+    EXPECT_EQ(allocator.Allocate(&small, 1024, stream1_), MKIRT_ERROR_OUT_OF_MEMORY);
+    EXPECT_EQ(allocator.GetStats().oomCount, 1);
+
+    // the cached large segment is released to make room under the limit
+    ASSERT_EQ(allocator.Free(large), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Allocate(&small, 1024, stream1_), MKIRT_SUCCESS);
+    DeviceAllocatorStats stats = allocator.GetStats();
+    EXPECT_EQ(stats.reservedBytes, DeviceCachingAllocator::SMALL_SEGMENT_SIZE);
+    EXPECT_LE(stats.peakReservedBytes, 4 * TEST_MB);
+
+    ASSERT_EQ(allocator.Free(small), MKIRT_SUCCESS);
+    allocator.SetMemoryLimit(TEST_MB);
+    EXPECT_EQ(allocator.GetStats().reservedBytes, 0);
+    allocator.ResetPeakStats();
+    EXPECT_EQ(allocator.GetStats().peakReservedBytes, 0);
+}
+
+TEST_F(CachingAllocatorTest, ReleaseStream)
+{
+    DeviceCachingAllocator allocator(backend_);
+    backend_->SetEventDeferred(true);
+    void *used = nullptr;
+    void *cached = nullptr;
+    void *pending = nullptr;
+    void *shared = nullptr;
+    ASSERT_EQ(allocator.Allocate(&used, 4096, stream1_), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Allocate(&cached, 3 * TEST_MB, stream1_), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Free(cached), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Allocate(&pending, 8192, stream1_), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.RecordStream(pending, stream2_), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Free(pending), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Allocate(&shared, 4096, stream2_), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.RecordStream(shared, stream1_), MKIRT_SUCCESS);
+    EXPECT_EQ(allocator.GetStats().pendingFreeBytes, 8192);
+
+    // the large segment is free and given back, the small one still holds used and moves to the default stream
+    allocator.ReleaseStream(stream1_);
+    DeviceAllocatorStats stats = allocator.GetStats();
+    EXPECT_EQ(stats.pendingFreeBytes, 0);
+    EXPECT_EQ(stats.segmentCount, 2);
+    EXPECT_EQ(stats.reservedBytes, 2 * DeviceCachingAllocator::SMALL_SEGMENT_SIZE);
+    EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_ + 2 * DeviceCachingAllocator::SMALL_SEGMENT_SIZE);
+
+    // the free rest of the moved segment serves the default stream
+    void *reused = nullptr;
+    ASSERT_EQ(allocator.Allocate(&reused, 4096), MKIRT_SUCCESS);
+    EXPECT_EQ(static_cast<uint8_t *>(reused), static_cast<uint8_t *>(used) + 4096);
+    EXPECT_EQ(allocator.GetStats().backendMallocCount, 3);
+
+    // shared no longer waits for the released stream
+    ASSERT_EQ(allocator.Free(shared), MKIRT_SUCCESS);
+    EXPECT_EQ(allocator.GetStats().pendingFreeBytes, 0);
+    ASSERT_EQ(allocator.Free(reused), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator.Free(used), MKIRT_SUCCESS);
+    allocator.Trim();
+    EXPECT_EQ(allocator.GetStats().reservedBytes, 0);
+    EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_);
+}
+
+TEST_F(CachingAllocatorTest, StreamDestroyReleasesBlocks)
+{
+    BackendType backendType = BackendFactory::GetBackendType();
+    BackendFactory::SetBackendType(BackendType::MOCK);
+    DeviceCachingAllocator *allocator = GetDeviceCachingAllocator();
+    allocator->Trim();
+    uint64_t reserved = allocator->GetStats().reservedBytes;
+    MkiRtStream stream = nullptr;
+    ASSERT_EQ(MkiRtStreamCreate(&stream, 0), MKIRT_SUCCESS);
+    void *a = nullptr;
+    ASSERT_EQ(allocator->Allocate(&a, 4096, stream), MKIRT_SUCCESS);
+    ASSERT_EQ(allocator->Free(a), MKIRT_SUCCESS);
+    EXPECT_GT(allocator->GetStats().reservedBytes, reserved);
+
+    EXPECT_EQ(MkiRtStreamDestroy(stream), MKIRT_SUCCESS);
+    EXPECT_EQ(allocator->GetStats().reservedBytes, reserved);
+    BackendFactory::SetBackendType(backendType);
+}
+
+TEST_F(CachingAllocatorTest, DefaultAllocator)
+{
+    BackendType backendType = BackendFactory::GetBackendType();
+    BackendFactory::SetBackendType(BackendType::MOCK);
+    DeviceCachingAllocator *allocator = GetDeviceCachingAllocator();
+    EXPECT_EQ(allocator, GetDeviceCachingAllocator());
+    void *a = nullptr;
+    ASSERT_EQ(allocator->Allocate(&a, 100), MKIRT_SUCCESS);
+    EXPECT_EQ(allocator->Free(a), MKIRT_SUCCESS);
+    allocator->Trim();
+    BackendFactory::SetBackendType(backendType);
+}
+} // namespace Mki
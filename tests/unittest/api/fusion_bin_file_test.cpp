@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+#include "mki/utils/bin_file/fusion_bin_file.h"
+#include "mki/utils/file_system/file_system.h"
+
+namespace Mki {
+static std::string ObjectData(const std::string &name, const std::string &soc, size_t len)
+{
+    std::string data;
+    while (data.size() < len) {
+        data.append(name + "@" + soc + ";");
+    }
+    data.resize(len);
+    return data;
+}
+
+TEST(FusionBinFileTest, writeAndFind)
+{
+    const std::vector<std::string> socs = {"Ascend910B", "Ascend310P", "Ascend910"};
+    const size_t kernelNum = 50;
+    {
+        FusionBinFile binFile;
+        for (size_t i = 0; i < kernelNum; i++) {
+            for (const auto &soc : socs) {
+                std::string name = "Kernel" + std::to_string(i);
+                std::string data = ObjectData(name, soc, i * 7 + 1);
+                ASSERT_TRUE(binFile.AddObject(name, soc, data.data(), data.size()).Ok());
+            }
+        }
+        char buffer[1] = {0};
+        EXPECT_FALSE(binFile.AddObject("Kernel0", "Ascend910B", buffer, sizeof(buffer)).Ok());
+        EXPECT_FALSE(binFile.AddObject("", "Ascend910B", buffer, sizeof(buffer)).Ok());
+        EXPECT_EQ(binFile.GetObjectCount(), kernelNum * socs.size());
+        ASSERT_TRUE(binFile.Write("fusion1.bin").Ok());
+    }
+
+    FusionBinFile binFile;
+    ASSERT_TRUE(binFile.Read("fusion1.bin").Ok());
+    EXPECT_FALSE(binFile.Read("fusion1.bin").Ok());
+    EXPECT_EQ(binFile.GetObjectCount(), kernelNum * socs.size());
+    for (size_t i = 0; i < kernelNum; i++) {
+        for (const auto &soc : socs) {
+            std::string name = "Kernel" + std::to_string(i);
+            std::string data = ObjectData(name, soc, i * 7 + 1);
+            BinObjectSpan object;
+            ASSERT_TRUE(binFile.Find(name, soc, object).Ok());
+            ASSERT_EQ(object.length, data.size());
+            EXPECT_EQ(memcmp(object.data, data.data(), data.size()), 0);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(object.data) % FUSION_BIN_ALIGNMENT, 0);
+        }
+    }
+    BinObjectSpan object;
+    EXPECT_FALSE(binFile.Find("Kernel0", "Ascend310B", object).Ok());
+    EXPECT_FALSE(binFile.Find("Kernel100", "Ascend910B", object).Ok());
+
+    std::vector<std::pair<std::string, BinObjectSpan>> objects;
+    binFile.GetSocObjects("Ascend310P", objects);
+    EXPECT_EQ(objects.size(), kernelNum);
+    for (const auto &it : objects) {
+        size_t len = std::min<size_t>(it.second.length, it.first.size());
+        EXPECT_EQ(std::string(it.second.data, len), it.first.substr(0, len));
+    }
+    FileSystem::DeleteFile("fusion1.bin");
+}
+
+TEST(FusionBinFileTest, corrupted)
+{
+    std::string data = ObjectData("Kernel", "Ascend910B", 100);
+    {
+        FusionBinFile binFile;
+        ASSERT_TRUE(binFile.AddObject("Kernel", "Ascend910B", data.data(), data.size()).Ok());
+        ASSERT_TRUE(binFile.Write("fusion2.bin").Ok());
+    }
+    int64_t fileSize = FileSystem::FileSize("fusion2.bin");
+    ASSERT_GT(fileSize, 0);
+    std::vector<uint8_t> content(static_cast<size_t>(fileSize));
+    ASSERT_TRUE(FileSystem::ReadFile("fusion2.bin", content.data(), content.size()));
+
+    auto writeAndRead = [](std::vector<uint8_t> bytes, size_t pos, BinObjectSpan &object) {
+        bytes[pos] ^= 0xFF;
+        FileSystem::DeleteFile("fusion3.bin");
+        FileSystem::WriteFile(reinterpret_cast<const char *>(bytes.data()), bytes.size(), "fusion3.bin");
+        FusionBinFile binFile;
+        Status st = binFile.Read("fusion3.bin");
+        if (!st.Ok()) {
+            return st;
+        }
+        return binFile.Find("Kernel", "Ascend910B", object);
+    };
+    BinObjectSpan object;
+    EXPECT_FALSE(writeAndRead(content, 0, object).Ok()); // 0: magic
+    EXPECT_FALSE(writeAndRead(content, offsetof(FusionBinHeader, entryCount), object).Ok());
+    EXPECT_FALSE(writeAndRead(content, sizeof(FusionBinHeader), object).Ok()); // name hash in index
+    EXPECT_FALSE(writeAndRead(content, content.size() - 1, object).Ok()); // object data
+    FileSystem::DeleteFile("fusion2.bin");
+    FileSystem::DeleteFile("fusion3.bin");
+}
+} // namespace Mki
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <thread>
+#include "mki/kernel_info.h"
+#include "mki/utils/allocator/host_allocator.h"
+
+namespace Mki {
+class CountHostAllocator : public HostAllocator {
+public:
+    uint8_t *Allocate(uint64_t size) override
+    {
+        allocCount_++;
+        return new uint8_t[size];
+    }
+    void Deallocate(uint8_t *addr, uint64_t size) override
+    {
+        (void)size;
+        freeCount_++;
+        delete[] addr;
+    }
+    uint32_t allocCount_ = 0;
+    uint32_t freeCount_ = 0;
+};
+
+TEST(HostAllocatorTest, SlabReuse)
+{
+    SlabHostAllocator allocator;
+    EXPECT_EQ(SlabHostAllocator::GetClassIdx(1), 0);
+    EXPECT_EQ(SlabHostAllocator::GetClassIdx(SlabHostAllocator::MIN_CLASS_SIZE + 1), 1);
+    EXPECT_EQ(SlabHostAllocator::GetClassIdx(SlabHostAllocator::MAX_CLASS_SIZE), SlabHostAllocator::CLASS_NUM - 1);
+
+    uint8_t *addr = allocator.Allocate(1000);
+    ASSERT_NE(addr, nullptr);
+    allocator.Deallocate(addr, 1000);
+    EXPECT_EQ(allocator.Allocate(1024), addr); // same size class
+    allocator.Deallocate(addr, 1024);
+
+    uint8_t *large = allocator.Allocate(SlabHostAllocator::MAX_CLASS_SIZE + 1);
+    ASSERT_NE(large, nullptr);
+    allocator.Deallocate(large, SlabHostAllocator::MAX_CLASS_SIZE + 1);
+}
+
+TEST(HostAllocatorTest, DefaultThreadCache)
+{
+    HostAllocator *allocator = GetDefaultHostAllocator();
+    ASSERT_NE(allocator, nullptr);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([allocator]() {
+            for (int j = 0; j < 100; ++j) {
+                uint8_t *addr = allocator->Allocate(4096);
+                ASSERT_NE(addr, nullptr);
+                addr[4095] = 1;
+                allocator->Deallocate(addr, 4096);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+TEST(HostAllocatorTest, KernelInfoReuse)
+{
+    CountHostAllocator allocator;
+    {
+        KernelInfo kernelInfo;
+        kernelInfo.SetHostAllocator(&allocator);
+        EXPECT_EQ(kernelInfo.GetHostAllocator(), &allocator);
+        ASSERT_TRUE(kernelInfo.InitArgs(256).Ok());
+        ASSERT_TRUE(kernelInfo.AllocTilingHost(512).Ok());
+        uint8_t *args = kernelInfo.GetArgs();
+        uint8_t *tiling = kernelInfo.GetTilingHostAddr();
+        EXPECT_EQ(allocator.allocCount_, 2);
+
+        kernelInfo.Reset();
+        EXPECT_EQ(kernelInfo.GetArgs(), nullptr);
+        ASSERT_TRUE(kernelInfo.InitArgs(128).Ok());
+        ASSERT_TRUE(kernelInfo.AllocTilingHost(512).Ok());
+        EXPECT_EQ(kernelInfo.GetArgs(), args);
+        EXPECT_EQ(kernelInfo.GetTilingHostAddr(), tiling);
+        EXPECT_EQ(allocator.allocCount_, 2);
+
+        kernelInfo.Reset();
+        ASSERT_TRUE(kernelInfo.InitArgs(1024).Ok());
+        EXPECT_EQ(allocator.allocCount_, 3);
+        EXPECT_EQ(allocator.freeCount_, 1);
+    }
+    EXPECT_EQ(allocator.freeCount_, allocator.allocCount_);
+}
+} // namespace Mki
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <thread>
+#include "mki/base/kernel_base.h"
+#include "mki/tiling_cache.h"
+
+namespace Mki {
+constexpr uint64_t TEST_TILING_SIZE = 64;
+constexpr uint64_t TEST_WORKSPACE_SIZE = 128;
+
+class KernelBaseTest : public KernelBase {
+public:
+    explicit KernelBaseTest(const BinHandle *handle) : KernelBase("KernelBaseTest", handle)
+    {
+        launchBufferSize_ = TEST_TILING_SIZE;
+    }
+    bool CanSupport(const LaunchParam &launchParam) const override { return true; }
+    uint32_t initImplCount_ = 0;
+
+protected:
+    Status InitImpl(const LaunchParam &launchParam) override
+    {
+        initImplCount_++;
+        kernelInfo_.SetBlockDim(launchParam.GetInTensor(0).desc.dims[0]);
+        kernelInfo_.GetScratchSizes().push_back(TEST_WORKSPACE_SIZE);
+        return Status::OkStatus();
+    }
+};
+
+static Tensor MakeTensor(uintptr_t addr, int64_t dim0 = 2)
+{
+    Tensor tensor;
+    tensor.desc.dtype = TENSOR_DTYPE_FLOAT;
+    tensor.desc.dims = {dim0, 4};
+    tensor.data = reinterpret_cast<void *>(addr);
+    return tensor;
+}
+
+static void *GetArg(const KernelInfo &kernelInfo, size_t idx)
+{
+    return reinterpret_cast<void **>(kernelInfo.GetArgs())[idx];
+}
+
+TEST(KernelBaseTest, FrozenArgs)
+{
+    BinHandle handle(nullptr);
+    KernelBaseTest kernel(&handle);
+    kernel.SetArgsFrozen(true);
+
+    LaunchParam launchParam;
+    launchParam.AddInTensor(MakeTensor(0x1000));
+    launchParam.AddOutTensor(MakeTensor(0x2000));
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    EXPECT_FALSE(kernel.GetKernelInfo().GetFrozenArgsInfo().valid);
+
+    RunInfo runInfo;
+    runInfo.SetScratchDeviceAddr(reinterpret_cast<uint8_t *>(0x3000));
+    (void)kernel.Run(launchParam, runInfo); // launch result depends on device
+    const KernelInfo &kernelInfo = kernel.GetKernelInfo();
+    ASSERT_TRUE(kernelInfo.GetFrozenArgsInfo().valid);
+    EXPECT_EQ(kernelInfo.GetFrozenArgsInfo().patchInfos.size(), 3);
+    EXPECT_EQ(GetArg(kernelInfo, 0), reinterpret_cast<void *>(0x1000));
+    EXPECT_EQ(GetArg(kernelInfo, 1), reinterpret_cast<void *>(0x2000));
+    EXPECT_EQ(GetArg(kernelInfo, 2), reinterpret_cast<void *>(0x3000));
+
+    launchParam.GetInTensor(0).data = reinterpret_cast<void *>(0x4000);
+    launchParam.GetOutTensor(0).data = reinterpret_cast<void *>(0x5000);
+    runInfo.SetScratchDeviceAddr(reinterpret_cast<uint8_t *>(0x6000));
+    (void)kernel.Run(launchParam, runInfo);
+    EXPECT_EQ(GetArg(kernelInfo, 0), reinterpret_cast<void *>(0x4000));
+    EXPECT_EQ(GetArg(kernelInfo, 1), reinterpret_cast<void *>(0x5000));
+    EXPECT_EQ(GetArg(kernelInfo, 2), reinterpret_cast<void *>(0x6000));
+    EXPECT_EQ(kernelInfo.GetFrozenArgsInfo().argsEx.args, kernelInfo.GetArgs());
+
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    EXPECT_FALSE(kernel.GetKernelInfo().GetFrozenArgsInfo().valid);
+}
+
+TEST(KernelBaseTest, TilingCache)
+{
+    BinHandle handle(nullptr);
+    KernelBaseTest kernel(&handle);
+    SetKernelSelfCreator(kernel, [&handle]() { return new KernelBaseTest(&handle); });
+    kernel.SetTilingCacheCapacity(2);
+
+    LaunchParam launchParam;
+    launchParam.AddInTensor(MakeTensor(0x1000));
+    launchParam.AddOutTensor(MakeTensor(0x2000));
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    EXPECT_EQ(kernel.initImplCount_, 1);
+    EXPECT_EQ(kernel.GetKernelInfo().GetBlockDim(), 2);
+    EXPECT_EQ(kernel.GetKernelInfo().GetTotalScratchSize(), TEST_WORKSPACE_SIZE);
+
+    std::unique_ptr<Kernel> clone(kernel.Clone());
+    ASSERT_NE(clone, nullptr);
+    LaunchParam otherParam;
+    otherParam.AddInTensor(MakeTensor(0x1000, 3));
+    otherParam.AddOutTensor(MakeTensor(0x2000, 3));
+    ASSERT_TRUE(clone->Init(otherParam).Ok());
+    ASSERT_TRUE(kernel.Init(otherParam).Ok());
+    EXPECT_EQ(kernel.GetKernelInfo().GetBlockDim(), 3);
+    EXPECT_EQ(kernel.initImplCount_, 1);
+
+    launchParam.GetInTensor(0).desc.dims[0] = 5;
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    EXPECT_EQ(kernel.initImplCount_, 2);
+
+    TilingCacheStats stats = kernel.GetTilingCacheStats();
+    EXPECT_EQ(stats.hitCount, 2);
+    EXPECT_EQ(stats.missCount, 3);
+    EXPECT_EQ(stats.evictCount, 1);
+    EXPECT_EQ(stats.size, 2);
+}
+
+struct TilingCacheTestParam {
+    float scale = 0;
+    std::string mode;
+};
+
+struct UnkeyedTestParam {
+    float scale = 0;
+};
+
+static void AppendTestParamKey(const Any &param, std::string &key)
+{
+    const auto &testParam = AnyCast<TilingCacheTestParam>(param);
+    AppendTilingCacheKey(key, testParam.scale);
+    AppendTilingCacheKey(key, testParam.mode);
+}
+
+REG_TILING_CACHE_KEY(TilingCacheTestParam, AppendTestParamKey);
+
+TEST(KernelBaseTest, TilingCacheParamKey)
+{
+    BinHandle handle(nullptr);
+    KernelBaseTest kernel(&handle);
+    kernel.SetTilingCacheCapacity(4);
+
+    LaunchParam launchParam;
+    launchParam.AddInTensor(MakeTensor(0x1000));
+    launchParam.AddOutTensor(MakeTensor(0x2000));
+    TilingCacheTestParam param;
+    param.scale = 1.0f;
+    param.mode = "a";
+    launchParam.SetParam(param);
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    EXPECT_EQ(kernel.initImplCount_, 1);
+
+    // scales equal at printing precision are different keys
+    param.scale = 1.0000001f;
+    launchParam.SetParam(param);
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    EXPECT_EQ(kernel.initImplCount_, 2);
+    param.mode = "b";
+    launchParam.SetParam(param);
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    EXPECT_EQ(kernel.initImplCount_, 3);
+
+    // a param type without a registered key is never cached
+    launchParam.SetParam(UnkeyedTestParam());
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+    EXPECT_EQ(kernel.initImplCount_, 5);
+
+    TilingCacheStats stats = kernel.GetTilingCacheStats();
+    EXPECT_EQ(stats.hitCount, 1);
+    EXPECT_EQ(stats.missCount, 3);
+    EXPECT_EQ(stats.bypassCount, 2);
+}
+
+TEST(KernelBaseTest, KernelPool)
+{
+    BinHandle handle(nullptr);
+    KernelBaseTest kernel(&handle);
+    SetKernelSelfCreator(kernel, [&handle]() { return new KernelBaseTest(&handle); });
+    KernelPool *pool = kernel.GetKernelPool();
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(pool, kernel.GetKernelPool());
+
+    Kernel *first = nullptr;
+    {
+        PooledKernel pooled = pool->AcquireScoped();
+        ASSERT_NE(pooled, nullptr);
+        first = pooled.get();
+        pooled->SetArgsFrozen(true);
+        PooledKernel second = pool->AcquireScoped();
+        EXPECT_NE(second.get(), first);
+    }
+    PooledKernel reused = pool->AcquireScoped();
+    EXPECT_EQ(reused.get(), first);
+    EXPECT_FALSE(reused->GetKernelInfo().GetArgsFrozen());
+
+    pool->SetCapacity(1);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([pool]() {
+            for (int j = 0; j < 100; ++j) {
+                PooledKernel pooled = pool->AcquireScoped();
+                EXPECT_NE(pooled, nullptr);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    reused.reset();
+
+    KernelPoolStats stats = pool->GetStats();
+    EXPECT_EQ(stats.acquireCount, 403);
+    EXPECT_EQ(stats.releaseCount, 403);
+    EXPECT_EQ(stats.inUseCount, 0);
+    EXPECT_GE(stats.inUseHighWater, 2);
+    // 2 idle instances before the capacity is lowered
+    EXPECT_EQ(stats.idleHighWater, 2);
+    EXPECT_LE(stats.idleCount, 1);
+
+    // concurrent releases never keep more idle instances than the capacity
+    KernelPool smallPool(&kernel);
+    smallPool.SetCapacity(1);
+    threads.clear();
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&smallPool]() {
+            for (int j = 0; j < 100; ++j) {
+                PooledKernel first = smallPool.AcquireScoped();
+                PooledKernel second = smallPool.AcquireScoped();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    stats = smallPool.GetStats();
+    EXPECT_LE(stats.idleHighWater, stats.capacity);
+    EXPECT_EQ(stats.idleCount, 1);
+    EXPECT_GT(stats.dropCount, 0);
+}
+} // namespace Mki
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include "mki/launch_batch.h"
+#include "mki/launch_graph.h"
+#include "mock_backend_fixture.h"
+
+namespace Mki {
+class LaunchBatchTest : public MockBackendFixture {};
+
+TEST_F(LaunchBatchTest, OneBackendCall)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernelA("KernelA", &handle, 3); // 3: tiling value
+    MockFixtureKernel kernelB("KernelB", &handle, 5); // 5: tiling value
+    ASSERT_TRUE(kernelA.Init(launchParam_).Ok());
+    ASSERT_TRUE(kernelB.Init(launchParam_).Ok());
+    ASSERT_TRUE(kernelA.Run(launchParam_, runInfo_).Ok());
+    ASSERT_TRUE(kernelB.Run(launchParam_, runInfo_).Ok());
+
+    std::vector<LaunchBatchItem> items = {{&kernelA, &launchParam_, &runInfo_}, {&kernelB, &launchParam_, &runInfo_},
+                                          {&kernelA, &launchParam_, &runInfo_}};
+    ASSERT_TRUE(LaunchBatch(items).Ok());
+    EXPECT_EQ(backend_->GetBatchLaunchCount(), 1);
+    EXPECT_EQ(backend_->GetLaunchCount(), 5);
+    std::vector<MockLaunchRecord> records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 5);
+    // same args image as launched one by one, in order
+    EXPECT_EQ(records[2].args, records[0].args);
+    EXPECT_EQ(records[3].args, records[1].args);
+    EXPECT_EQ(records[4].args, records[0].args);
+    EXPECT_EQ(records[3].blockDim, 5);
+    EXPECT_EQ(records[4].stream, stream_);
+}
+
+TEST_F(LaunchBatchTest, TilingUploadedToRing)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernelA("KernelA", &handle, 3); // 3: tiling value
+    MockFixtureKernel kernelB("KernelB", &handle, 5); // 5: tiling value
+    uint8_t tilingHostA[16] = {0};
+    uint8_t tilingHostB[16] = {0};
+    kernelA.SetLaunchWithTiling(false);
+    kernelA.SetTilingHostAddr(tilingHostA, sizeof(tilingHostA));
+    kernelB.SetLaunchWithTiling(false);
+    kernelB.SetTilingHostAddr(tilingHostB, sizeof(tilingHostB));
+    ASSERT_TRUE(kernelA.Init(launchParam_).Ok());
+    ASSERT_TRUE(kernelB.Init(launchParam_).Ok());
+
+    std::vector<LaunchBatchItem> items = {{&kernelA, &launchParam_, &runInfo_}, {&kernelB, &launchParam_, &runInfo_}};
+    ASSERT_TRUE(LaunchBatch(items).Ok());
+    std::vector<MockLaunchRecord> records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 2);
+    uint32_t *tilingA = static_cast<uint32_t *>(GetArg(records[0], 2));
+    uint32_t *tilingB = static_cast<uint32_t *>(GetArg(records[1], 2));
+    ASSERT_NE(tilingA, nullptr);
+    ASSERT_NE(tilingB, nullptr);
+    EXPECT_NE(tilingA, tilingB);
+    EXPECT_EQ(*tilingA, 3);
+    EXPECT_EQ(*tilingB, 5);
+    EXPECT_EQ(runInfo_.GetTilingDeviceAddr(), nullptr);
+}
+
+TEST_F(LaunchBatchTest, InvalidItems)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernel("KernelA", &handle, 3); // 3: tiling value
+    ASSERT_TRUE(kernel.Init(launchParam_).Ok());
+    EXPECT_FALSE(LaunchBatch({}).Ok());
+    EXPECT_FALSE(LaunchBatch({{&kernel, &launchParam_, nullptr}}).Ok());
+
+    MkiRtStream stream = nullptr;
+    ASSERT_EQ(MkiRtStreamCreate(&stream, 0), MKIRT_SUCCESS);
+    RunInfo runInfo;
+    runInfo.SetStream(stream);
+    EXPECT_FALSE(LaunchBatch({{&kernel, &launchParam_, &runInfo_}, {&kernel, &launchParam_, &runInfo}}).Ok());
+    EXPECT_EQ(backend_->GetLaunchCount(), 0);
+    EXPECT_EQ(MkiRtStreamDestroy(stream), MKIRT_SUCCESS);
+}
+
+TEST_F(LaunchBatchTest, CapturedAsNodes)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernelA("KernelA", &handle, 3); // 3: tiling value
+    MockFixtureKernel kernelB("KernelB", &handle, 5); // 5: tiling value
+    ASSERT_TRUE(kernelA.Init(launchParam_).Ok());
+    ASSERT_TRUE(kernelB.Init(launchParam_).Ok());
+
+    LaunchGraph graph;
+    graph.SetNativeCapture(false);
+    ASSERT_TRUE(graph.BeginCapture().Ok());
+    ASSERT_TRUE(LaunchBatch({{&kernelA, &launchParam_, &runInfo_}, {&kernelB, &launchParam_, &runInfo_}}).Ok());
+    ASSERT_TRUE(graph.EndCapture().Ok());
+    EXPECT_EQ(graph.GetNodeCount(), 2);
+    EXPECT_EQ(backend_->GetBatchLaunchCount(), 0);
+    EXPECT_EQ(backend_->GetLaunchCount(), 2);
+}
+} // namespace Mki
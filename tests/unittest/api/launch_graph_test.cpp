@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include "mki/launch_graph.h"
+#include "mki/utils/memset/clear_tensors.h"
+#include "mock_backend_fixture.h"
+
+namespace Mki {
+constexpr uint64_t ARGS_TILING_OFFSET = 3 * sizeof(void *); // 3: in, out and tiling slots
+
+class LaunchGraphTest : public MockBackendFixture {};
+
+TEST_F(LaunchGraphTest, ReplayNodes)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernelA("KernelA", &handle);
+    MockFixtureKernel kernelB("KernelB", &handle);
+    ASSERT_TRUE(kernelA.Init(launchParam_).Ok());
+    ASSERT_TRUE(kernelB.Init(launchParam_).Ok());
+
+    LaunchGraph graph;
+    graph.SetNativeCapture(false);
+    ASSERT_TRUE(graph.BeginCapture().Ok());
+    EXPECT_EQ(LaunchGraph::GetCapturing(), &graph);
+    LaunchGraph other;
+    EXPECT_FALSE(other.BeginCapture().Ok());
+    ASSERT_TRUE(kernelA.Run(launchParam_, runInfo_).Ok());
+    ASSERT_TRUE(kernelB.Run(launchParam_, runInfo_).Ok());
+    EXPECT_FALSE(graph.Replay().Ok());
+    ASSERT_TRUE(graph.EndCapture().Ok());
+    EXPECT_EQ(LaunchGraph::GetCapturing(), nullptr);
+    ASSERT_EQ(graph.GetNodeCount(), 2);
+    EXPECT_EQ(graph.GetNodeName(1), "KernelB");
+    // capture launches the kernels as usual
+    EXPECT_EQ(backend_->GetLaunchCount(), 2);
+
+    ASSERT_TRUE(graph.Replay().Ok());
+    std::vector<MockLaunchRecord> records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 4);
+    EXPECT_EQ(records[2].args, records[0].args);
+    EXPECT_EQ(records[3].blockDim, FIXTURE_TILING_VALUE);
+    EXPECT_EQ(records[3].stream, stream_);
+
+    // the output of every node is rebound, scalars in the tiling of node 1 are patched
+    EXPECT_EQ(graph.UpdateAddress(reinterpret_cast<void *>(FIXTURE_OUT_ADDR), reinterpret_cast<void *>(0x3000)), 2);
+    uint32_t value = 9;
+    ASSERT_TRUE(graph.UpdateTiling(1, 0, &value, sizeof(value)).Ok());
+    EXPECT_FALSE(graph.UpdateTiling(1, 1024, &value, sizeof(value)).Ok());
+    EXPECT_FALSE(graph.UpdateTiling(2, 0, &value, sizeof(value)).Ok());
+    ASSERT_TRUE(graph.Replay().Ok());
+    records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 6);
+    EXPECT_EQ(GetArg(records[4], 0), reinterpret_cast<void *>(FIXTURE_IN_ADDR));
+    EXPECT_EQ(GetArg(records[4], 1), reinterpret_cast<void *>(0x3000));
+    uint32_t tiling = 0;
+    memcpy(&tiling, records[4].args.data() + ARGS_TILING_OFFSET, sizeof(tiling));
+    EXPECT_EQ(tiling, FIXTURE_TILING_VALUE);
+    memcpy(&tiling, records[5].args.data() + ARGS_TILING_OFFSET, sizeof(tiling));
+    EXPECT_EQ(tiling, 9);
+    EXPECT_FALSE(graph.IsNativeModelReady());
+}
+
+TEST_F(LaunchGraphTest, ReplayNativeModel)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernel("KernelA", &handle);
+    ASSERT_TRUE(kernel.Init(launchParam_).Ok());
+    LaunchGraph graph;
+    ASSERT_TRUE(graph.BeginCapture().Ok());
+    ASSERT_TRUE(kernel.Run(launchParam_, runInfo_).Ok());
+    ASSERT_TRUE(kernel.Run(launchParam_, runInfo_).Ok());
+    ASSERT_TRUE(graph.EndCapture().Ok());
+
+    // the mock backend supports stream capture, the nodes are launched from the model
+    ASSERT_TRUE(graph.Replay().Ok());
+    EXPECT_TRUE(graph.IsNativeModelReady());
+    ASSERT_TRUE(graph.Replay().Ok());
+    EXPECT_EQ(backend_->GetLaunchCount(), 6);
+
+    EXPECT_EQ(graph.UpdateAddress(reinterpret_cast<void *>(FIXTURE_IN_ADDR), reinterpret_cast<void *>(0x5000)), 2);
+    EXPECT_FALSE(graph.IsNativeModelReady());
+    ASSERT_TRUE(graph.Replay().Ok());
+    EXPECT_TRUE(graph.IsNativeModelReady());
+    std::vector<MockLaunchRecord> records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 8);
+    EXPECT_EQ(GetArg(records[7], 0), reinterpret_cast<void *>(0x5000));
+
+    // replay on another stream
+    MkiRtStream stream = nullptr;
+    ASSERT_EQ(MkiRtStreamCreate(&stream, 0), MKIRT_SUCCESS);
+    ASSERT_TRUE(graph.Replay(stream).Ok());
+    records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 10);
+    EXPECT_EQ(records[9].stream, stream);
+    EXPECT_EQ(MkiRtStreamDestroy(stream), MKIRT_SUCCESS);
+}
+
+TEST_F(LaunchGraphTest, TilingOwnedByGraph)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernel("KernelA", &handle);
+    kernel.SetLaunchWithTiling(false);
+    uint8_t tilingHost[16] = {0};
+    kernel.SetTilingHostAddr(tilingHost, sizeof(tilingHost));
+    ASSERT_TRUE(kernel.Init(launchParam_).Ok());
+
+    LaunchGraph graph;
+    graph.SetNativeCapture(false);
+    ASSERT_TRUE(graph.BeginCapture().Ok());
+    ASSERT_TRUE(kernel.Run(launchParam_, runInfo_).Ok());
+    ASSERT_TRUE(graph.EndCapture().Ok());
+    ASSERT_TRUE(graph.Replay().Ok());
+    std::vector<MockLaunchRecord> records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 2);
+    uint32_t *deviceTiling = static_cast<uint32_t *>(GetArg(records[1], 2));
+    ASSERT_NE(deviceTiling, nullptr);
+    EXPECT_EQ(GetArg(records[0], 2), deviceTiling);
+    EXPECT_EQ(*deviceTiling, FIXTURE_TILING_VALUE);
+
+    uint32_t value = 11;
+    ASSERT_TRUE(graph.UpdateTiling(0, 0, &value, sizeof(value)).Ok());
+    EXPECT_EQ(*deviceTiling, 11);
+    EXPECT_FALSE(graph.UpdateTiling(0, 16, &value, sizeof(value)).Ok());
+}
+
+TEST_F(LaunchGraphTest, ClearWaitsForReplays)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernel("KernelA", &handle);
+    kernel.SetLaunchWithTiling(false);
+    uint8_t tilingHost[16] = {0};
+    kernel.SetTilingHostAddr(tilingHost, sizeof(tilingHost));
+    ASSERT_TRUE(kernel.Init(launchParam_).Ok());
+    LaunchGraph graph;
+    ASSERT_TRUE(graph.BeginCapture().Ok());
+    ASSERT_TRUE(kernel.Run(launchParam_, runInfo_).Ok());
+    ASSERT_TRUE(graph.EndCapture().Ok());
+
+    // the model runs on a stream the tiling was not allocated on, its completion is still pending at Clear
+    MkiRtStream stream = nullptr;
+    ASSERT_EQ(MkiRtStreamCreate(&stream, 0), MKIRT_SUCCESS);
+    backend_->SetEventDeferred(true);
+    ASSERT_TRUE(graph.Replay(stream).Ok());
+    EXPECT_TRUE(graph.IsNativeModelReady());
+    ASSERT_TRUE(graph.Replay().Ok());
+    uint64_t destroyCount = backend_->GetIncompleteEventDestroyCount();
+    graph.Clear();
+    backend_->SetEventDeferred(false);
+    EXPECT_EQ(backend_->GetIncompleteEventDestroyCount(), destroyCount);
+    EXPECT_FALSE(graph.IsNativeModelReady());
+    EXPECT_EQ(MkiRtStreamDestroy(stream), MKIRT_SUCCESS);
+}
+
+class LaunchGraphMemsetKernel : public MockFixtureKernel {
+public:
+    using MockFixtureKernel::MockFixtureKernel;
+
+protected:
+    Status InitImpl(const LaunchParam &launchParam) override
+    {
+        kernelInfo_.SetMemsetInfo(1, 32); // 1, 32: clear 32 bytes of the output
+        return MockFixtureKernel::InitImpl(launchParam);
+    }
+};
+
+TEST_F(LaunchGraphTest, HostMemsetNotCaptured)
+{
+    BinHandle handle(nullptr);
+    LaunchGraphMemsetKernel kernel("KernelA", &handle);
+    ASSERT_TRUE(kernel.Init(launchParam_).Ok());
+    LaunchGraph graph;
+    ASSERT_TRUE(graph.BeginCapture().Ok());
+    ASSERT_TRUE(kernel.Run(launchParam_, runInfo_).Ok());
+    ASSERT_TRUE(graph.EndCapture().Ok());
+    ASSERT_TRUE(graph.Replay().Ok());
+    // aclrtMemset is not valid in stream capture, the node is replayed on its own without the memset kernel
+    EXPECT_EQ(graph.IsNativeModelReady(), HasMemsetKernel());
+}
+
+TEST_F(LaunchGraphTest, DestroyedOnAnotherThread)
+{
+    std::unique_ptr<LaunchGraph> other = std::make_unique<LaunchGraph>();
+    std::thread([&other]() { EXPECT_TRUE(other->BeginCapture().Ok()); }).join();
+    LaunchGraph graph;
+    ASSERT_TRUE(graph.BeginCapture().Ok());
+    // the graph capturing on this thread is kept
+    other.reset();
+    EXPECT_EQ(LaunchGraph::GetCapturing(), &graph);
+    ASSERT_TRUE(graph.EndCapture().Ok());
+}
+} // namespace Mki
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+// override the level configured for the build, --min_log_level defines it for every target
+#undef MKI_MIN_LOG_LEVEL
+#define MKI_MIN_LOG_LEVEL 3 // WARN
+#include <gtest/gtest.h>
+#include "mki/utils/log/log.h"
+
+namespace Mki {
+static int g_evalCount = 0;
+
+static int Eval()
+{
+    return ++g_evalCount;
+}
+
+TEST(LogLevel, CompileTimeElision)
+{
+    LogCore &logCore = LogCore::Instance();
+    LogLevel level = logCore.GetLogLevel();
+    logCore.SetLogLevel(LogLevel::TRACE);
+    g_evalCount = 0;
+    MKI_LOG(DEBUG) << Eval();
+    MKI_LOG(INFO) << Eval();
+    MKI_LOG(WARN) << Eval();
+    EXPECT_EQ(g_evalCount, 1);
+
+    logCore.SetLogLevel(LogLevel::ERROR);
+    MKI_LOG(WARN) << Eval();
+    MKI_LOG(ERROR) << Eval();
+    EXPECT_EQ(g_evalCount, 2);
+    logCore.SetLogLevel(level);
+}
+
+TEST(LogLevel, CachedLevel)
+{
+    LogCore &logCore = LogCore::Instance();
+    LogLevel level = logCore.GetLogLevel();
+    logCore.SetLogLevel(LogLevel::ERROR);
+    EXPECT_FALSE(LogCore::IsLogLevelEnabled(LogLevel::WARN));
+    EXPECT_TRUE(LogCore::IsLogLevelEnabled(LogLevel::ERROR));
+
+    LogCore otherCore;
+    otherCore.SetLogLevel(LogLevel::TRACE);
+    EXPECT_FALSE(LogCore::IsLogLevelEnabled(LogLevel::WARN));
+    logCore.SetLogLevel(level);
+}
+} // namespace Mki
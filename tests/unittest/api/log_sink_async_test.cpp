@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <csignal>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "mki/utils/log/log_sink_async.h"
+
+namespace Mki {
+class CollectSink : public LogSink {
+public:
+    void Log(const char *log, uint64_t logLen) override
+    {
+        while (blocked_) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        logs_.emplace_back(log, logLen);
+    }
+    void LogBatch(const struct iovec *iov, int iovCnt) override
+    {
+        batchCount_++;
+        LogSink::LogBatch(iov, iovCnt);
+    }
+    std::vector<std::string> GetLogs()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return logs_;
+    }
+
+    std::atomic_bool blocked_{false};
+    std::atomic<uint64_t> batchCount_{0};
+
+private:
+    std::mutex mutex_;
+    std::vector<std::string> logs_;
+};
+
+// drained logs are discarded, only the crash handler writes to the fd
+class CrashFdSink : public LogSink {
+public:
+    void Log(const char *log, uint64_t logLen) override
+    {
+        (void)log;
+        (void)logLen;
+    }
+    int GetCrashFd() const override { return STDERR_FILENO; }
+};
+
+TEST(LogSinkAsync, OrderAndLargeLog)
+{
+    auto collectSink = std::make_shared<CollectSink>();
+    LogSinkAsync sink({collectSink}, LogOverflowPolicy::BLOCK, 100, false);
+    EXPECT_EQ(sink.GetCapacity(), 128);
+
+    std::string largeLog(2048, 'x');
+    largeLog += "\n";
+    for (int i = 0; i < 1000; ++i) {
+        std::string log = i == 500 ? largeLog : "log " + std::to_string(i) + "\n";
+        sink.Log(log.c_str(), log.size());
+    }
+    sink.Flush();
+
+    std::vector<std::string> logs = collectSink->GetLogs();
+    ASSERT_EQ(logs.size(), 1000);
+    EXPECT_EQ(logs[0], "log 0\n");
+    EXPECT_EQ(logs[500], largeLog);
+    EXPECT_EQ(logs[999], "log 999\n");
+    LogAsyncStats stats = sink.GetStats();
+    EXPECT_EQ(stats.enqueueCount, 1000);
+    EXPECT_EQ(stats.dropCount, 0);
+    EXPECT_LT(stats.batchCount, 1000);
+    EXPECT_EQ(stats.batchCount, collectSink->batchCount_);
+}
+
+TEST(LogSinkAsync, MultiThread)
+{
+    auto collectSink = std::make_shared<CollectSink>();
+    {
+        LogSinkAsync sink({collectSink}, LogOverflowPolicy::BLOCK, 64, false);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&sink, t]() {
+                for (int i = 0; i < 500; ++i) {
+                    std::string log = std::to_string(t) + ":" + std::to_string(i) + "\n";
+                    sink.Log(log.c_str(), log.size());
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+    std::vector<std::string> logs = collectSink->GetLogs();
+    ASSERT_EQ(logs.size(), 2000);
+    std::vector<int> lastIdx(4, -1);
+    for (const auto &log : logs) {
+        int t = std::stoi(log.substr(0, log.find(':')));
+        int i = std::stoi(log.substr(log.find(':') + 1));
+        EXPECT_EQ(i, lastIdx[t] + 1);
+        lastIdx[t] = i;
+    }
+}
+
+TEST(LogSinkAsync, OverflowCount)
+{
+    auto collectSink = std::make_shared<CollectSink>();
+    collectSink->blocked_ = true;
+    LogSinkAsync sink({collectSink}, LogOverflowPolicy::COUNT, 64, false);
+    for (int i = 0; i < 200; ++i) {
+        sink.Log("log\n", 4);
+    }
+    LogAsyncStats stats = sink.GetStats();
+    EXPECT_GT(stats.dropCount, 0);
+    EXPECT_EQ(stats.enqueueCount + stats.dropCount, 200);
+
+    collectSink->blocked_ = false;
+    sink.Flush();
+    std::vector<std::string> logs = collectSink->GetLogs();
+    ASSERT_EQ(logs.size(), stats.enqueueCount + 1);
+    EXPECT_EQ(logs.back(), "[mki_log] " + std::to_string(stats.dropCount) + " logs are dropped by async log sink\n");
+}
+
+TEST(LogSinkAsync, WriteOnCrash)
+{
+    // the log is still in the ring when the signal arrives, the flusher waits 20ms before draining
+    EXPECT_DEATH(
+        {
+            LogSinkAsync sink({std::make_shared<CrashFdSink>()}, LogOverflowPolicy::BLOCK, 4096, true);
+            sink.Log("log in ring\n", 12);
+            (void)raise(SIGABRT);
+        },
+        "log in ring");
+}
+} // namespace Mki
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "mki/utils/log/log.h"
+#include "mki/utils/log/log_core.h"
+#include "mki/utils/log/log_sink_binary.h"
+
+namespace Mki {
+class BinaryOutputCapture : public LogSink {
+public:
+    void Log(const char *log, uint64_t logLen) override { data.append(log, logLen); }
+    std::string data;
+};
+
+static void LogTo(LogSinkBinary &sink, const LogEntity &entity, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    sink.LogStructured(entity, format, args);
+    va_end(args);
+}
+
+template <typename T> static T ReadValue(const std::string &data, size_t &pos)
+{
+    T value;
+    memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+static std::string ReadStr16(const std::string &data, size_t &pos)
+{
+    uint16_t len = ReadValue<uint16_t>(data, pos);
+    std::string str = data.substr(pos, len);
+    pos += len;
+    return str;
+}
+
+static LogEntity MakeEntity(LogLevel level, int line)
+{
+    LogEntity entity;
+    entity.time = std::chrono::system_clock::now();
+    entity.threadId = 1234;
+    entity.level = level;
+    entity.fileName = "binary_test.cpp";
+    entity.line = line;
+    entity.funcName = "TestFunc";
+    return entity;
+}
+
+TEST(LogSinkBinary, Encode)
+{
+    auto output = std::make_shared<BinaryOutputCapture>();
+    LogSinkBinary sink(output);
+    const char *format = "%s dims %d x %lu, scale %.2f";
+    LogTo(sink, MakeEntity(LogLevel::INFO, 10), format, "matmul", 3, static_cast<unsigned long>(4), 0.5);
+    EXPECT_TRUE(output->data.empty());
+    sink.Flush();
+
+    const std::string &data = output->data;
+    size_t pos = 0;
+    ASSERT_EQ(ReadValue<uint8_t>(data, pos), static_cast<uint8_t>(LogRecordType::CALLSITE));
+    uint32_t id = ReadValue<uint32_t>(data, pos);
+    EXPECT_EQ(ReadValue<uint8_t>(data, pos), static_cast<uint8_t>(LogLevel::INFO));
+    EXPECT_EQ(ReadValue<uint32_t>(data, pos), 10);
+    EXPECT_EQ(ReadStr16(data, pos), "binary_test.cpp");
+    EXPECT_EQ(ReadStr16(data, pos), "TestFunc");
+    EXPECT_EQ(ReadStr16(data, pos), format);
+    ASSERT_EQ(ReadValue<uint8_t>(data, pos), 4);
+    EXPECT_EQ(ReadValue<uint8_t>(data, pos), static_cast<uint8_t>(LogArgType::STRING));
+    EXPECT_EQ(ReadValue<uint8_t>(data, pos), static_cast<uint8_t>(LogArgType::INT));
+    EXPECT_EQ(ReadValue<uint8_t>(data, pos), static_cast<uint8_t>(LogArgType::LONG));
+    EXPECT_EQ(ReadValue<uint8_t>(data, pos), static_cast<uint8_t>(LogArgType::DOUBLE));
+
+    ASSERT_EQ(ReadValue<uint8_t>(data, pos), static_cast<uint8_t>(LogRecordType::FORMAT));
+    EXPECT_EQ(ReadValue<uint32_t>(data, pos), id);
+    EXPECT_GT(ReadValue<uint64_t>(data, pos), 0);
+    EXPECT_EQ(ReadValue<uint32_t>(data, pos), 1234);
+    EXPECT_EQ(ReadStr16(data, pos), "matmul");
+    EXPECT_EQ(ReadValue<int32_t>(data, pos), 3);
+    EXPECT_EQ(ReadValue<int64_t>(data, pos), 4);
+    EXPECT_EQ(ReadValue<double>(data, pos), 0.5);
+    EXPECT_EQ(pos, data.size());
+
+    std::string header = sink.GetFileHeader();
+    ASSERT_GT(header.size(), sizeof(BINARY_LOG_MAGIC));
+    EXPECT_EQ(memcmp(header.data(), BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)), 0);
+}
+
+TEST(LogSinkBinary, CallsiteAndFlush)
+{
+    auto output = std::make_shared<BinaryOutputCapture>();
+    LogSinkBinary sink(output);
+    const char *format = "step %d";
+    for (int i = 0; i < 100; ++i) {
+        LogTo(sink, MakeEntity(LogLevel::INFO, 20), format, i);
+    }
+    EXPECT_EQ(sink.GetCallsiteCount(), 1);
+    EXPECT_TRUE(output->data.empty());
+
+    LogTo(sink, MakeEntity(LogLevel::ERROR, 21), "wide %ls", L"text");
+    EXPECT_EQ(sink.GetCallsiteCount(), 2);
+    ASSERT_FALSE(output->data.empty());
+    // every FORMAT record of "step %d" is 1 + 4 + 8 + 4 + 4 bytes
+    EXPECT_GT(output->data.size(), 100 * 21);
+    EXPECT_NE(output->data.find(static_cast<char>(LogRecordType::RENDERED)), std::string::npos);
+}
+
+TEST(LogSinkBinary, LogCore)
+{
+    LogCore &logCore = LogCore::Instance();
+    auto output = std::make_shared<BinaryOutputCapture>();
+    auto sink = std::make_shared<LogSinkBinary>(output);
+    logCore.AddSink(sink);
+    EXPECT_TRUE(logCore.HasStructuredSink());
+    MKI_FLOG(ERROR, "binary %d", 42);
+    MKI_LOG(ERROR) << "text record";
+    logCore.DeleteLogFileSink();
+    EXPECT_FALSE(logCore.HasStructuredSink());
+    sink->Flush();
+
+    EXPECT_EQ(sink->GetCallsiteCount(), 1);
+    EXPECT_NE(output->data.find("binary %d"), std::string::npos);
+    EXPECT_NE(output->data.find("text record\n"), std::string::npos);
+}
+
+TEST(LogSinkBinary, CallsiteOverflow)
+{
+    auto output = std::make_shared<BinaryOutputCapture>();
+    LogSinkBinary sink(output, 1 << 24); // 1 << 24: keep every record in the buffer
+    for (int line = 0; line < 65536; ++line) { // 65536: callsite limit
+        LogTo(sink, MakeEntity(LogLevel::INFO, line), "callsite %d", line);
+    }
+    LogTo(sink, MakeEntity(LogLevel::WARN, 70000), "overflow %d", 1); // 70000: line of a new callsite
+    EXPECT_EQ(sink.GetCallsiteCount(), 65536);
+    sink.Flush();
+
+    // the last record is the TEXT record, its text has the header of a text log
+    const std::string &data = output->data;
+    std::string text;
+    for (size_t pos = data.size() - 1; pos > sizeof(uint32_t) && text.empty(); --pos) {
+        size_t lenPos = pos - sizeof(uint32_t);
+        if (data[pos] == '[' && static_cast<uint8_t>(data[lenPos - 1]) == static_cast<uint8_t>(LogRecordType::TEXT) &&
+            ReadValue<uint32_t>(data, lenPos) == data.size() - pos) {
+            text = data.substr(pos);
+        }
+    }
+    EXPECT_NE(text.find("] [warn] ["), std::string::npos) << text;
+    EXPECT_NE(text.find("] [binary_test.cpp:70000] overflow 1\n"), std::string::npos) << text;
+}
+
+#ifdef MKI_SCRIPTS_DIR
+TEST(LogSinkBinary, DecoderRoundTrip)
+{
+    auto output = std::make_shared<BinaryOutputCapture>();
+    LogSinkBinary sink(output);
+    LogTo(sink, MakeEntity(LogLevel::INFO, 10), "%s dims %d x %lu, scale %.2f", "matmul", 3,
+          static_cast<unsigned long>(4), 0.5);
+    LogTo(sink, MakeEntity(LogLevel::ERROR, 11), "wide %ls", L"text");
+    LogTo(sink, MakeEntity(LogLevel::WARN, 12), "ptr %p, %5.1f%%, %c", nullptr, 12.5, 'x');
+    sink.Log("text log\n", 9);
+    sink.Flush();
+
+    std::string filePath = testing::TempDir() + "mki_log_decoder_test.binlog";
+    {
+        std::ofstream file(filePath, std::ios::binary);
+        std::string header = sink.GetFileHeader();
+        file.write(header.data(), header.size());
+        file.write(output->data.data(), output->data.size());
+    }
+    std::string cmd = std::string("python3 ") + MKI_SCRIPTS_DIR + "/mki_log_decoder.py " + filePath + " 2>&1";
+    FILE *pipe = popen(cmd.c_str(), "r");
+    ASSERT_NE(pipe, nullptr);
+    std::string text;
+    char buf[256] = {0};
+    size_t len = 0;
+    while ((len = fread(buf, 1, sizeof(buf), pipe)) > 0) {
+        text.append(buf, len);
+    }
+    int status = pclose(pipe);
+    (void)remove(filePath.c_str());
+    if (WEXITSTATUS(status) == 127) { // 127: python3 not found
+        GTEST_SKIP() << "python3 is not available";
+    }
+    ASSERT_EQ(WEXITSTATUS(status), 0) << text;
+
+    EXPECT_NE(text.find("] [info] [1234] [binary_test.cpp:10] matmul dims 3 x 4, scale 0.50\n"), std::string::npos)
+        << text;
+    EXPECT_NE(text.find("] [error] [1234] [binary_test.cpp:11] wide text\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("] [warn] [1234] [binary_test.cpp:12] ptr (nil),  12.5%, x\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("\ntext log\n"), std::string::npos) << text;
+}
+#endif
+} // namespace Mki
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "mki/utils/log/log_sink_file.h"
+
+namespace Mki {
+static std::vector<std::string> ListFiles(const std::string &dirPath)
+{
+    std::vector<std::string> files;
+    DIR *dir = opendir(dirPath.c_str());
+    if (dir == nullptr) {
+        return files;
+    }
+    struct dirent *ptr = nullptr;
+    while ((ptr = readdir(dir)) != nullptr) {
+        if (ptr->d_name[0] != '.') {
+            files.push_back(dirPath + "/" + ptr->d_name);
+        }
+    }
+    closedir(dir);
+    return files;
+}
+
+TEST(LogSinkFile, Rotation)
+{
+    const std::string logDir = "/tmp/mkirotatetest/log";
+    for (const std::string &file : ListFiles(logDir)) {
+        remove(file.c_str());
+    }
+    // files left by another process are deleted first
+    mkdir("/tmp/mkirotatetest", S_IRWXU);
+    mkdir(logDir.c_str(), S_IRWXU);
+    const std::string oldFile = logDir + "/mkirotatetest_1_20200101000000.log";
+    FILE *file = fopen(oldFile.c_str(), "w");
+    if (file != nullptr) {
+        fclose(file);
+    }
+    setenv("ASDOPS_LOG_PATH", "/tmp", 1);
+    setenv("ASDOPS_LOG_TO_BOOST_TYPE", "mkirotatetest", 1);
+    {
+        LogSinkFile sink;
+        unsetenv("ASDOPS_LOG_PATH");
+        unsetenv("ASDOPS_LOG_TO_BOOST_TYPE");
+        sink.SetRotation(1024, 3); // 1024: rotate every 1KB, keep 3 files
+
+        std::string log(99, 'x');
+        log += "\n";
+        for (int i = 0; i < 100; ++i) {
+            sink.Log(log.c_str(), log.size());
+        }
+    }
+
+    std::vector<std::string> files = ListFiles(logDir);
+    if (files.empty()) {
+        GTEST_SKIP() << "log dir is not writable or disk space is too low";
+    }
+    EXPECT_EQ(files.size(), 3);
+    for (const std::string &file : files) {
+        EXPECT_NE(file, oldFile);
+        struct stat st {};
+        ASSERT_EQ(stat(file.c_str(), &st), 0);
+        EXPECT_GT(st.st_size, 0);
+        EXPECT_LE(st.st_size, 1024);
+        remove(file.c_str());
+    }
+}
+} // namespace Mki
@@ -11,6 +11,8 @@
  */
 #include <gtest/gtest.h>
 #include <cstdlib>
+#include <regex>
+#include <thread>
 #include "mki/utils/SVector/SVector.h"
 #include "mki/utils/log/log.h"
 #include "mki/utils/log/log_entity.h"
@@ -140,6 +142,65 @@ TEST(LogEntity, Unknown) {
     EXPECT_EQ(std::string("unknown"), Mki::LogLevelToString(static_cast<Mki::LogLevel>(100)));
 }
 
+class LogSinkCapture : public LogSink {
+public:
+    void Log(const char *log, uint64_t logLen) override { logs.emplace_back(log, logLen); }
+    std::vector<std::string> logs;
+};
+
+TEST(LogStream, Header)
+{
+    Mki::LogCore &logCore = Mki::LogCore::Instance();
+    auto sink = std::make_shared<LogSinkCapture>();
+    logCore.AddSink(sink);
+    MKI_LOG(ERROR) << "hello";
+    MKI_FLOG(ERROR, "%s %d", "world", 1);
+    logCore.DeleteLogFileSink();
+
+    ASSERT_EQ(sink->logs.size(), 2);
+    std::string header = R"(\[\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\.\d{6}\] \[error\] \[\d+\] \[log_test.cpp:\d+\] )";
+    EXPECT_TRUE(std::regex_match(sink->logs[0], std::regex(header + "hello\n"))) << sink->logs[0];
+    EXPECT_TRUE(std::regex_match(sink->logs[1], std::regex(header + "world 1\n"))) << sink->logs[1];
+}
+
+TEST(LogStream, Sampling)
+{
+    Mki::LogCore &logCore = Mki::LogCore::Instance();
+    auto sink = std::make_shared<LogSinkCapture>();
+    logCore.AddSink(sink);
+    for (int i = 0; i < 10; ++i) {
+        MKI_LOG_EVERY_N(ERROR, 4) << "every_n " << i;
+        MKI_LOG_FIRST_N(ERROR, 2) << "first_n " << i;
+        MKI_LOG_EVERY_MS(ERROR, 60000) << "every_ms " << i;
+    }
+    logCore.DeleteLogFileSink();
+
+    std::vector<std::string> expects = {"every_n 0", "first_n 0", "every_ms 0", "first_n 1", "every_n 4", "every_n 8"};
+    ASSERT_EQ(sink->logs.size(), expects.size());
+    for (size_t i = 0; i < expects.size(); ++i) {
+        EXPECT_NE(sink->logs[i].find("] " + expects[i] + "\n"), std::string::npos) << sink->logs[i];
+    }
+}
+
+TEST(LogCore, RateLimit)
+{
+    Mki::LogCore logCore;
+    auto sink = std::make_shared<LogSinkCapture>();
+    logCore.AddSink(sink);
+    logCore.SetLogRateLimit(10, 5);
+    for (int i = 0; i < 100; ++i) {
+        logCore.Log("log\n", 4);
+    }
+    EXPECT_EQ(sink->logs.size(), 5);
+    EXPECT_EQ(logCore.GetSuppressedLogCount(), 95);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    logCore.Log("log\n", 4);
+    ASSERT_EQ(sink->logs.size(), 7);
+    EXPECT_EQ(sink->logs[5], "[mki_log] 95 logs are suppressed by rate limit\n");
+    EXPECT_EQ(sink->logs[6], "log\n");
+}
+
 TEST(LogEntity, AddSink) {
     Mki::LogCore logCore;
     logCore.AddSink(std::make_shared<Mki::LogSinkStdout>());
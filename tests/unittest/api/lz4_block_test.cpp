@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "mki/utils/compress/lz4_block.h"
+
+namespace Mki {
+static std::vector<uint8_t> ToBytes(const std::string &str) { return std::vector<uint8_t>(str.begin(), str.end()); }
+
+TEST(Lz4BlockTest, Decompress)
+{
+    // literals "code", match offset 4 length 8, last literals "code"
+    std::vector<uint8_t> block = {0x44, 'c', 'o', 'd', 'e', 0x04, 0x00, 0x40, 'c', 'o', 'd', 'e'};
+    std::vector<uint8_t> raw(16);
+    ASSERT_TRUE(Lz4BlockDecompress(block.data(), block.size(), raw.data(), raw.size()));
+    EXPECT_EQ(raw, ToBytes("codecodecodecode"));
+
+    // run of one byte with extended match length: 1 literal, offset 1, match 4 + 15 + 1
+    std::vector<uint8_t> runBlock = {0x1F, 'a', 0x01, 0x00, 0x01, 0x10, 'b'};
+    std::vector<uint8_t> run(22);
+    ASSERT_TRUE(Lz4BlockDecompress(runBlock.data(), runBlock.size(), run.data(), run.size()));
+    EXPECT_EQ(run, ToBytes(std::string(21, 'a') + "b"));
+
+    std::vector<uint8_t> empty = {0x00};
+    uint8_t dummy = 0;
+    EXPECT_TRUE(Lz4BlockDecompress(empty.data(), empty.size(), &dummy, 0));
+}
+
+TEST(Lz4BlockTest, Malformed)
+{
+    std::vector<uint8_t> block = {0x44, 'c', 'o', 'd', 'e', 0x04, 0x00, 0x40, 'c', 'o', 'd', 'e'};
+    std::vector<uint8_t> raw(16);
+    // wrong decoded size
+    EXPECT_FALSE(Lz4BlockDecompress(block.data(), block.size(), raw.data(), raw.size() - 1));
+    std::vector<uint8_t> larger(17);
+    EXPECT_FALSE(Lz4BlockDecompress(block.data(), block.size(), larger.data(), larger.size()));
+    // offset before the start of output
+    std::vector<uint8_t> badOffset = block;
+    badOffset[5] = 0x08;
+    EXPECT_FALSE(Lz4BlockDecompress(badOffset.data(), badOffset.size(), raw.data(), raw.size()));
+    // zero offset
+    std::vector<uint8_t> zeroOffset = block;
+    zeroOffset[5] = 0x00;
+    EXPECT_FALSE(Lz4BlockDecompress(zeroOffset.data(), zeroOffset.size(), raw.data(), raw.size()));
+    // truncated literals and offset
+    EXPECT_FALSE(Lz4BlockDecompress(block.data(), 3, raw.data(), raw.size()));
+    EXPECT_FALSE(Lz4BlockDecompress(block.data(), 6, raw.data(), raw.size()));
+    // unterminated length bytes
+    std::vector<uint8_t> badLength = {0xF0, 0xFF, 0xFF};
+    EXPECT_FALSE(Lz4BlockDecompress(badLength.data(), badLength.size(), raw.data(), raw.size()));
+    EXPECT_FALSE(Lz4BlockDecompress(nullptr, 0, raw.data(), raw.size()));
+}
+
+#ifdef MKI_SCRIPTS_DIR
+TEST(Lz4BlockTest, BuildUtilRoundTrip)
+{
+    // runs, repeated words and noise, longer than the 64KB match window
+    std::vector<uint8_t> raw;
+    uint32_t seed = 1;
+    const size_t rawSize = 200000;
+    while (raw.size() < rawSize) {
+        seed = seed * 1103515245 + 12345; // 1103515245, 12345: lcg constants
+        uint32_t kind = (seed >> 16) % 3; // 3: kinds of content
+        if (kind == 0) {
+            raw.insert(raw.end(), 1 + (seed >> 8) % 300, static_cast<uint8_t>(seed)); // 300: max run length
+        } else if (kind == 1) {
+            std::string word = "kernel_" + std::to_string((seed >> 8) % 16); // 16: distinct words
+            raw.insert(raw.end(), word.begin(), word.end());
+        } else {
+            raw.push_back(static_cast<uint8_t>(seed >> 24)); // 24: high byte
+        }
+    }
+    std::string rawPath = testing::TempDir() + "mki_lz4_test.raw";
+    std::string blockPath = testing::TempDir() + "mki_lz4_test.lz4";
+    {
+        std::ofstream file(rawPath, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(raw.data()), raw.size());
+    }
+    std::string script = "import sys; sys.path.insert(0, sys.argv[1]); import build_util; "
+                         "open(sys.argv[3], 'wb').write(build_util.lz4_block_compress(open(sys.argv[2], 'rb').read()))";
+    std::string cmd = "python3 -c \"" + script + "\" " + MKI_SCRIPTS_DIR + " " + rawPath + " " + blockPath + " 2>&1";
+    FILE *pipe = popen(cmd.c_str(), "r");
+    ASSERT_NE(pipe, nullptr);
+    std::string text;
+    char buf[256] = {0};
+    size_t len = 0;
+    while ((len = fread(buf, 1, sizeof(buf), pipe)) > 0) {
+        text.append(buf, len);
+    }
+    int status = pclose(pipe);
+    (void)remove(rawPath.c_str());
+    if (WEXITSTATUS(status) == 127) { // 127: python3 not found
+        GTEST_SKIP() << "python3 is not available";
+    }
+    ASSERT_EQ(WEXITSTATUS(status), 0) << text;
+
+    std::vector<uint8_t> block;
+    {
+        std::ifstream file(blockPath, std::ios::binary);
+        block.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    (void)remove(blockPath.c_str());
+    EXPECT_LT(block.size(), raw.size());
+    std::vector<uint8_t> decoded(raw.size());
+    ASSERT_TRUE(Lz4BlockDecompress(block.data(), block.size(), decoded.data(), decoded.size()));
+    EXPECT_EQ(decoded, raw);
+}
+#endif
+} // namespace Mki
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#ifndef MKI_UNITTEST_MOCK_BACKEND_FIXTURE_H
+#define MKI_UNITTEST_MOCK_BACKEND_FIXTURE_H
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include "mki/base/kernel_base.h"
+#include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+
+namespace Mki {
+constexpr uintptr_t FIXTURE_IN_ADDR = 0x1000;
+constexpr uintptr_t FIXTURE_OUT_ADDR = 0x2000;
+constexpr uint64_t FIXTURE_TENSOR_SIZE = 256;
+constexpr uint32_t FIXTURE_TILING_VALUE = 7;
+
+// writes tilingValue at the start of its tiling and launches tilingValue blocks
+class MockFixtureKernel : public KernelBase {
+public:
+    MockFixtureKernel(const std::string &name, const BinHandle *handle, uint32_t tilingValue = FIXTURE_TILING_VALUE)
+        : KernelBase(name, handle), tilingValue_(tilingValue)
+    {
+        launchBufferSize_ = 16; // 16: tiling size
+    }
+    bool CanSupport(const LaunchParam &launchParam) const override { return true; }
+
+protected:
+    Status InitImpl(const LaunchParam &launchParam) override
+    {
+        kernelInfo_.SetBlockDim(tilingValue_);
+        memcpy(kernelInfo_.GetTilingHostAddr(), &tilingValue_, sizeof(tilingValue_));
+        return Status::OkStatus();
+    }
+
+private:
+    uint32_t tilingValue_ = 0;
+};
+
+// switches to the mock backend and launches on stream_, launchParam_ reads FIXTURE_IN_ADDR and writes FIXTURE_OUT_ADDR
+class MockBackendFixture : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        backendType_ = BackendFactory::GetBackendType();
+        BackendFactory::SetBackendType(BackendType::MOCK);
+        backend_ = BackendFactory::GetMockBackend();
+        backend_->ClearLaunchRecords();
+        ASSERT_EQ(MkiRtStreamCreate(&stream_, 0), MKIRT_SUCCESS);
+        runInfo_.SetStream(stream_);
+        launchParam_.AddInTensor(MakeTensor(FIXTURE_IN_ADDR));
+        launchParam_.AddOutTensor(MakeTensor(FIXTURE_OUT_ADDR));
+    }
+    void TearDown() override
+    {
+        (void)MkiRtStreamDestroy(stream_);
+        BackendFactory::SetBackendType(backendType_);
+    }
+
+    static Tensor MakeTensor(uintptr_t addr)
+    {
+        Tensor tensor;
+        tensor.desc.dtype = TENSOR_DTYPE_FLOAT;
+        tensor.desc.dims = {8, 8};
+        tensor.data = reinterpret_cast<void *>(addr);
+        tensor.dataSize = FIXTURE_TENSOR_SIZE;
+        return tensor;
+    }
+    // address in slot idx of the launched args
+    static void *GetArg(const MockLaunchRecord &record, size_t idx)
+    {
+        void *addr = nullptr;
+        memcpy(&addr, record.args.data() + idx * sizeof(void *), sizeof(void *));
+        return addr;
+    }
+
+    BackendType backendType_ = BackendType::RT;
+    MockBackend *backend_ = nullptr;
+    MkiRtStream stream_ = nullptr;
+    RunInfo runInfo_;
+    LaunchParam launchParam_;
+};
+} // namespace Mki
+
+#endif
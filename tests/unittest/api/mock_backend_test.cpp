@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include "mki/base/kernel_base.h"
+#include "mki/utils/rt/rt.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+
+namespace Mki {
+class MockBackendKernel : public KernelBase {
+public:
+    explicit MockBackendKernel(const BinHandle *handle) : KernelBase("MockBackendKernel", handle)
+    {
+        launchBufferSize_ = 32; // 32: tiling size
+    }
+    bool CanSupport(const LaunchParam &launchParam) const override { return true; }
+
+protected:
+    Status InitImpl(const LaunchParam &launchParam) override
+    {
+        kernelInfo_.SetBlockDim(8); // 8: block dim
+        return Status::OkStatus();
+    }
+};
+
+class MockBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        backendType_ = BackendFactory::GetBackendType();
+        BackendFactory::SetBackendType(BackendType::MOCK);
+        BackendFactory::GetMockBackend()->ClearLaunchRecords();
+    }
+    void TearDown() override { BackendFactory::SetBackendType(backendType_); }
+
+    BackendType backendType_ = BackendType::RT;
+};
+
+TEST_F(MockBackendTest, MemoryAndStream)
+{
+    MockBackend *backend = BackendFactory::GetMockBackend();
+    ASSERT_EQ(BackendFactory::GetBackend(), backend);
+
+    uint64_t memUsed = backend->GetDeviceMemoryUsed();
+    void *devPtr = nullptr;
+    ASSERT_EQ(MkiRtMemMallocDevice(&devPtr, 64, MKIRT_MEM_DEFAULT), MKIRT_SUCCESS);
+    EXPECT_EQ(backend->GetDeviceMemoryUsed(), memUsed + 64);
+    uint8_t host[64] = {1, 2, 3};
+    ASSERT_EQ(MkiRtMemCopy(devPtr, 64, host, 64, MKIRT_MEMCOPY_HOST_TO_DEVICE), MKIRT_SUCCESS);
+    EXPECT_EQ(static_cast<uint8_t *>(devPtr)[2], 3);
+    ASSERT_EQ(MkiRtMemFreeDevice(devPtr), MKIRT_SUCCESS);
+    EXPECT_EQ(backend->GetDeviceMemoryUsed(), memUsed);
+
+    MkiRtStream stream = nullptr;
+    ASSERT_EQ(MkiRtStreamCreate(&stream, 0), MKIRT_SUCCESS);
+    int32_t streamId = -1;
+    EXPECT_EQ(MkiRtStreamGetId(stream, &streamId), MKIRT_SUCCESS);
+    EXPECT_GE(streamId, 0);
+    EXPECT_EQ(MkiRtStreamSynchronize(stream), MKIRT_SUCCESS);
+    EXPECT_EQ(MkiRtStreamDestroy(stream), MKIRT_SUCCESS);
+
+    char version[64] = {0};
+    EXPECT_EQ(MkiRtDeviceGetSocVersion(version, sizeof(version)), MKIRT_SUCCESS);
+    EXPECT_GT(strlen(version), 0);
+}
+
+TEST_F(MockBackendTest, RecordLaunch)
+{
+    BinHandle handle(nullptr);
+    MockBackendKernel kernel(&handle);
+    Tensor tensor;
+    tensor.desc.dtype = TENSOR_DTYPE_FLOAT;
+    tensor.desc.dims = {2, 4};
+    tensor.data = reinterpret_cast<void *>(0x1000);
+    LaunchParam launchParam;
+    launchParam.AddInTensor(tensor);
+    tensor.data = reinterpret_cast<void *>(0x2000);
+    launchParam.AddOutTensor(tensor);
+    ASSERT_TRUE(kernel.Init(launchParam).Ok());
+
+    RunInfo runInfo;
+    MkiRtStream stream = nullptr;
+    ASSERT_EQ(MkiRtStreamCreate(&stream, 0), MKIRT_SUCCESS);
+    runInfo.SetStream(stream);
+    ASSERT_TRUE(kernel.Run(launchParam, runInfo).Ok());
+    ASSERT_TRUE(kernel.Run(launchParam, runInfo).Ok());
+
+    MockBackend *backend = BackendFactory::GetMockBackend();
+    EXPECT_EQ(backend->GetLaunchCount(), 2);
+    std::vector<MockLaunchRecord> records = backend->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].blockDim, 8);
+    EXPECT_EQ(records[0].stream, stream);
+    ASSERT_GE(records[0].args.size(), 2 * sizeof(void *));
+    void *argsAddr[2] = {nullptr, nullptr};
+    memcpy(argsAddr, records[0].args.data(), sizeof(argsAddr));
+    EXPECT_EQ(argsAddr[0], reinterpret_cast<void *>(0x1000));
+    EXPECT_EQ(argsAddr[1], reinterpret_cast<void *>(0x2000));
+    EXPECT_LE(records[0].timestampNs, records[1].timestampNs);
+
+    backend->SetRecordLimit(0);
+    ASSERT_TRUE(kernel.Run(launchParam, runInfo).Ok());
+    EXPECT_EQ(backend->GetLaunchCount(), 3);
+    EXPECT_EQ(backend->GetLaunchRecords().size(), 2);
+    backend->SetRecordLimit(4096); // 4096: default record limit
+    EXPECT_EQ(MkiRtStreamDestroy(stream), MKIRT_SUCCESS);
+}
+
+TEST_F(MockBackendTest, RecordHandleLaunchName)
+{
+    uint8_t code[16] = {0};
+    MkiRtModuleInfo moduleInfo;
+    moduleInfo.data = code;
+    moduleInfo.dataLen = sizeof(code);
+    moduleInfo.name = "MultiKernelBinary";
+    void *handle = nullptr;
+    ASSERT_EQ(MkiRtRegisterAllFunction(&moduleInfo, &handle), MKIRT_SUCCESS);
+    ASSERT_NE(handle, nullptr);
+
+    MkiRtKernelParam param;
+    param.blockDim = 1;
+    ASSERT_EQ(MkiRtFunctionLaunchWithHandle(handle, &param, nullptr, nullptr), MKIRT_SUCCESS);
+    std::vector<MockLaunchRecord> records = BackendFactory::GetMockBackend()->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].kernelName, "MultiKernelBinary");
+}
+} // namespace Mki
@@ -13,6 +13,8 @@
 #include "mki_loader/op_register.h"
 
 namespace Mki {
+using namespace OpSpace;
+
 TEST(OpRegisterTest, Base)
 {
     std::vector<std::string> opList;
@@ -21,4 +23,29 @@ TEST(OpRegisterTest, Base)
     (void)operationCreators;
     (void)kernelCreators;
 }
+
+static const uint8_t TEST_BINARY_A[] = {1};
+static const uint8_t TEST_BINARY_B[] = {2, 2};
+REG_KERNEL(ascendtest1, OpRegisterTestKernel, TEST_BINARY_A);
+REG_KERNEL(ascendtest2, OpRegisterTestKernel, TEST_BINARY_B);
+
+TEST(OpRegisterTest, KernelBinary)
+{
+    using OpSpace::KernelBinaryRegister;
+    const BinaryBasicInfo *binary = KernelBinaryRegister::FindKernelBinary("ascendtest2", "OpRegisterTestKernel");
+    ASSERT_NE(binary, nullptr);
+    EXPECT_EQ(binary->binaryBuf, TEST_BINARY_B);
+    EXPECT_EQ(binary->binaryLen, sizeof(TEST_BINARY_B));
+    EXPECT_EQ(binary->targetSoc, "ascendtest2");
+    EXPECT_EQ(KernelBinaryRegister::FindKernelBinary("ascendtest3", "OpRegisterTestKernel"), nullptr);
+    EXPECT_EQ(KernelBinaryRegister::FindKernelBinary("ascendtest1", "UnknownKernel"), nullptr);
+
+    // registering the same kernel for one soc again keeps the first binary
+    KernelBinaryRegister("ascendtest1", "OpRegisterTestKernel", TEST_BINARY_B, sizeof(TEST_BINARY_B));
+    const auto *socBinarys = KernelBinaryRegister::FindSocKernelBinarys("ascendtest1");
+    ASSERT_NE(socBinarys, nullptr);
+    ASSERT_EQ(socBinarys->binarys.size(), 1);
+    EXPECT_EQ(socBinarys->binarys[0].kernelName, "OpRegisterTestKernel");
+    EXPECT_EQ(socBinarys->binarys[0].basicInfo.binaryBuf, TEST_BINARY_A);
+}
 } // namespace Mki
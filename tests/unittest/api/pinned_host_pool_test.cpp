@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include "mki/kernel_info.h"
+#include "mki/utils/rt/backend/backend_factory.h"
+#include "mki/utils/rt/memory/pinned_host_pool.h"
+
+namespace Mki {
+class PinnedHostPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        backend_ = BackendFactory::GetMockBackend();
+        hostMemCount_ = backend_->GetHostMemoryCount();
+    }
+
+    MockBackend *backend_ = nullptr;
+    size_t hostMemCount_ = 0;
+};
+
+TEST_F(PinnedHostPoolTest, SizeClassReuse)
+{
+    {
+        PinnedHostPool pool(backend_);
+        EXPECT_EQ(pool.Allocate(0), nullptr);
+        uint8_t *a = pool.Allocate(100);
+        uint8_t *b = pool.Allocate(256);
+        uint8_t *c = pool.Allocate(300);
+        ASSERT_NE(a, nullptr);
+        ASSERT_NE(b, nullptr);
+        ASSERT_NE(c, nullptr);
+        // one chunk is shared by all size classes
+        EXPECT_EQ(backend_->GetHostMemoryCount(), hostMemCount_ + 1);
+        EXPECT_EQ(b, a + PinnedHostPool::MIN_CLASS_SIZE);
+        EXPECT_EQ(c, b + PinnedHostPool::MIN_CLASS_SIZE);
+        EXPECT_TRUE(pool.IsPinned(a));
+        EXPECT_TRUE(pool.IsPinned(c + 511));
+        int local = 0;
+        EXPECT_FALSE(pool.IsPinned(&local));
+
+        PinnedHostPoolStats stats = pool.GetStats();
+        EXPECT_EQ(stats.allocatedBytes, 1024);
+        EXPECT_EQ(stats.reservedBytes, PinnedHostPool::CHUNK_SIZE);
+        EXPECT_EQ(stats.chunkCount, 1);
+
+        pool.Deallocate(a, 100);
+        EXPECT_EQ(pool.Allocate(200), a);
+        pool.Deallocate(c, 300);
+        EXPECT_EQ(pool.Allocate(512), c);
+        stats = pool.GetStats();
+        EXPECT_EQ(stats.cacheHitCount, 2);
+        EXPECT_EQ(stats.backendMallocCount, 1);
+        EXPECT_EQ(stats.peakAllocatedBytes, 1024);
+        pool.Deallocate(a, 200);
+        pool.Deallocate(b, 256);
+        pool.Deallocate(c, 512);
+        EXPECT_EQ(pool.GetStats().allocatedBytes, 0);
+    }
+    EXPECT_EQ(backend_->GetHostMemoryCount(), hostMemCount_);
+}
+
+TEST_F(PinnedHostPoolTest, LargeBlock)
+{
+    {
+        PinnedHostPool pool(backend_);
+        uint64_t size = PinnedHostPool::MAX_CLASS_SIZE + 1;
+        uint8_t *addr = pool.Allocate(size);
+        ASSERT_NE(addr, nullptr);
+        EXPECT_TRUE(pool.IsPinned(addr + size - 1));
+        EXPECT_FALSE(pool.IsPinned(addr + size));
+        EXPECT_EQ(pool.GetStats().largeBlockCount, 1);
+        EXPECT_EQ(backend_->GetHostMemoryCount(), hostMemCount_ + 1);
+        pool.Deallocate(addr, size);
+        EXPECT_EQ(backend_->GetHostMemoryCount(), hostMemCount_);
+        PinnedHostPoolStats stats = pool.GetStats();
+        EXPECT_EQ(stats.largeBlockCount, 0);
+        EXPECT_EQ(stats.reservedBytes, 0);
+        EXPECT_EQ(stats.allocatedBytes, 0);
+    }
+    EXPECT_EQ(backend_->GetHostMemoryCount(), hostMemCount_);
+}
+
+TEST_F(PinnedHostPoolTest, KernelInfoBuffers)
+{
+    PinnedHostPool pool(backend_);
+    {
+        KernelInfo kernelInfo;
+        kernelInfo.SetHostAllocator(&pool);
+        ASSERT_TRUE(kernelInfo.InitArgs(256).Ok());
+        ASSERT_TRUE(kernelInfo.AllocTilingHost(1000).Ok());
+        EXPECT_TRUE(pool.IsPinned(kernelInfo.GetArgs()));
+        EXPECT_TRUE(pool.IsPinned(kernelInfo.GetTilingHostAddr()));
+        EXPECT_EQ(pool.GetStats().allocatedBytes, 1280);
+    }
+    // buffers go back to the pool with the kernel info
+    EXPECT_EQ(pool.GetStats().allocatedBytes, 0);
+}
+
+TEST_F(PinnedHostPoolTest, GetPinnedHostPool)
+{
+    PinnedHostPool *pool = GetPinnedHostPool();
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(GetPinnedHostPool(), pool);
+}
+} // namespace Mki
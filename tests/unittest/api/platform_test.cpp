@@ -10,9 +10,11 @@
  * See the Mulan PSL v2 for more details.
  */
 #include <gtest/gtest.h>
+#include <cstdlib>
 #include "mki/utils/log/log.h"
 #include "mki/utils/platform/platform_info.h"
 #include "mki/utils/platform/platform_manager.h"
+#include "mki/utils/platform/platform_config_table.h"
 
 namespace Mki {
 TEST(PlatformTest, platformTest1)
@@ -61,6 +63,78 @@ TEST(PlatFormInfosImplTest, GetPlatformSpec)
     EXPECT_EQ(platformConfigs.GetFixPipeDtypeMap(), map1);
 }
 
+TEST(PlatformManagerTest, BuiltinConfig)
+{
+    size_t tableCount = 0;
+    const PlatformConfigTable *tables = GetBuiltinPlatformConfigTables(tableCount);
+    if (tableCount == 0) {
+        GTEST_SKIP() << "built with BUILD_PLATFORM_CONFIG_TABLE=OFF";
+    }
+    Mki::PlatformManager &platformManager = Mki::PlatformManager::Instance();
+    platformManager.Finalize();
+    ASSERT_EQ(platformManager.InitializePlatformManager(), PLATFORM_SUCCESS);
+    PlatformConfigs platformConfigs;
+    ASSERT_EQ(platformManager.GetPlatformConfigs("Ascend910B1", platformConfigs), PLATFORM_SUCCESS);
+    std::string val;
+    EXPECT_TRUE(platformConfigs.GetPlatformSpec("version", "Short_SoC_version", val));
+    EXPECT_EQ(val, "Ascend910B");
+    EXPECT_FALSE(platformConfigs.GetFixPipeDtypeMap().empty());
+    EXPECT_NE(platformManager.GetPlatformConfigs("NotExistSoc", platformConfigs), PLATFORM_SUCCESS);
+
+    // builtin table has the same content as the ini files
+    const char *homePath = std::getenv("ASDOPS_HOME_PATH");
+    if (homePath == nullptr) {
+        platformManager.Finalize();
+        return;
+    }
+    std::vector<PlatformConfigs> builtinConfigs(tableCount);
+    for (size_t i = 0; i < tableCount; ++i) {
+        ASSERT_EQ(platformManager.GetPlatformConfigs(tables[i].socVersion, builtinConfigs[i]), PLATFORM_SUCCESS);
+    }
+    platformManager.Finalize();
+    std::string iniPath = std::string(homePath) + "/configs/platform_configs";
+    setenv("ASDOPS_PLATFORM_CONFIG_PATH", iniPath.c_str(), 1);
+    ASSERT_EQ(platformManager.InitializePlatformManager(), PLATFORM_SUCCESS);
+    unsetenv("ASDOPS_PLATFORM_CONFIG_PATH");
+    for (size_t i = 0; i < tableCount; ++i) {
+        PlatformConfigs iniConfigs;
+        ASSERT_EQ(platformManager.GetPlatformConfigs(tables[i].socVersion, iniConfigs), PLATFORM_SUCCESS);
+        EXPECT_EQ(iniConfigs.GetPlatformSpecMap(), builtinConfigs[i].GetPlatformSpecMap()) << tables[i].fileName;
+        EXPECT_EQ(iniConfigs.GetAICoreIntrinsicDtype(), builtinConfigs[i].GetAICoreIntrinsicDtype());
+        EXPECT_EQ(iniConfigs.GetFixPipeDtypeMap(), builtinConfigs[i].GetFixPipeDtypeMap());
+    }
+    platformManager.Finalize();
+}
+
+TEST(PlatformInfoTest, PlatformCaps)
+{
+    Mki::PlatformManager &platformManager = Mki::PlatformManager::Instance();
+    ASSERT_EQ(platformManager.InitializePlatformManager(), PLATFORM_SUCCESS);
+    PlatformConfigs platformConfigs;
+    ASSERT_EQ(platformManager.GetPlatformConfigs("Ascend910B1", platformConfigs), PLATFORM_SUCCESS);
+    PlatformCaps caps;
+    ParsePlatformCaps(platformConfigs, PlatformType::ASCEND_910B, caps);
+    EXPECT_EQ(caps.aiCoreNum, 24);
+    EXPECT_EQ(caps.cubeCoreNum, 24);
+    EXPECT_EQ(caps.vectorCoreNum, 48);
+    EXPECT_EQ(caps.GetCoreNum(CoreType::CORE_TYPE_VECTOR), 48);
+    EXPECT_EQ(caps.GetCoreNum(CoreType::CORE_TYPE_CUBE), 24);
+    EXPECT_EQ(caps.ubSize, 196608);
+    EXPECT_EQ(caps.l1Size, 524288);
+    EXPECT_EQ(caps.l0CSize, 131072);
+    EXPECT_EQ(caps.l2Size, 201326592);
+    EXPECT_TRUE(caps.supportL0c2out);
+    EXPECT_TRUE(caps.supportFixpipe);
+    EXPECT_TRUE(caps.cubeVectorSplit);
+
+    ASSERT_EQ(platformManager.GetPlatformConfigs("Ascend310P3", platformConfigs), PLATFORM_SUCCESS);
+    ParsePlatformCaps(platformConfigs, PlatformType::ASCEND_310P, caps);
+    EXPECT_EQ(caps.GetCoreNum(CoreType::CORE_TYPE_VECTOR), caps.aiCoreNum);
+    EXPECT_FALSE(caps.supportL0c2out);
+    EXPECT_FALSE(caps.cubeVectorSplit);
+    platformManager.Finalize();
+}
+
 TEST(PlatformManagerTest, Finalize)
 {
     Mki::PlatformManager &platformManager = Mki::PlatformManager::Instance();
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include "mki/base/operation_base.h"
+#include "mki/stream_scheduler.h"
+#include "mock_backend_fixture.h"
+
+namespace Mki {
+class SchedulerKernel : public MockFixtureKernel {
+public:
+    using MockFixtureKernel::MockFixtureKernel;
+
+protected:
+    Status InitImpl(const LaunchParam &launchParam) override
+    {
+        kernelInfo_.GetScratchSizes().push_back(64); // 64: workspace size
+        return MockFixtureKernel::InitImpl(launchParam);
+    }
+};
+
+class FailingSchedulerKernel : public SchedulerKernel {
+public:
+    using SchedulerKernel::SchedulerKernel;
+    Status Run(const LaunchParam &launchParam, RunInfo &runInfo) override
+    {
+        return Status::FailStatus(ERROR_LAUNCH_KERNEL_ERROR, "launch fail");
+    }
+};
+
+template <typename KernelType>
+class SchedulerOperation : public OperationBase {
+public:
+    SchedulerOperation() : OperationBase("SchedulerOperation"), handle_(nullptr) {}
+    Kernel *GetBestKernel(const LaunchParam &launchParam) const override
+    {
+        return new KernelType("SchedulerKernel", &handle_);
+    }
+
+protected:
+    Status InferShapeImpl(const LaunchParam &launchParam, SVector<Tensor> &outTensors) const override
+    {
+        return Status::OkStatus();
+    }
+
+private:
+    BinHandle handle_;
+};
+
+class StreamSchedulerTest : public MockBackendFixture {
+protected:
+    static LaunchParam MakeLaunchParam(const std::vector<uintptr_t> &inAddrs, uintptr_t outAddr)
+    {
+        LaunchParam launchParam;
+        for (uintptr_t addr : inAddrs) {
+            launchParam.AddInTensor(MakeTensor(addr));
+        }
+        launchParam.AddOutTensor(MakeTensor(outAddr));
+        return launchParam;
+    }
+
+    SchedulerOperation<SchedulerKernel> op_;
+};
+
+TEST_F(StreamSchedulerTest, ParallelBranches)
+{
+    // q, k and v projections of x, then one node reading all of them
+    StreamScheduler scheduler;
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x2000)).Ok());
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x3000)).Ok());
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x4000)).Ok());
+    size_t nodeIdx = 0;
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x2000, 0x3000, 0x4000}, 0x5000), &nodeIdx).Ok());
+    EXPECT_EQ(nodeIdx, 3);
+    EXPECT_TRUE(scheduler.GetNodeDependencies(1).empty());
+    EXPECT_EQ(scheduler.GetNodeDependencies(3), std::vector<size_t>({0, 1, 2}));
+    EXPECT_EQ(scheduler.GetNodeStream(0), 0);
+    EXPECT_EQ(scheduler.GetNodeStream(1), 1);
+    EXPECT_EQ(scheduler.GetNodeStream(2), 2);
+    EXPECT_EQ(scheduler.GetNodeStream(3), 0);
+
+    ASSERT_TRUE(scheduler.Run(stream_).Ok());
+    std::vector<MockLaunchRecord> records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 4);
+    EXPECT_EQ(records[0].stream, stream_);
+    EXPECT_NE(records[1].stream, stream_);
+    EXPECT_NE(records[2].stream, records[1].stream);
+    EXPECT_EQ(records[3].stream, stream_);
+
+    StreamSchedulerStats stats = scheduler.GetStats();
+    EXPECT_EQ(stats.runCount, 1);
+    EXPECT_EQ(stats.launchCount, 4);
+    EXPECT_EQ(stats.sideLaunchCount, 2);
+    // 2 forks and 2 dependencies, the last node on the caller stream joins the branches
+    EXPECT_EQ(stats.eventWaitCount, 4);
+    EXPECT_EQ(stats.streamsUsed, 3);
+    EXPECT_EQ(stats.criticalPathLength, 2);
+    EXPECT_DOUBLE_EQ(stats.Parallelism(), 2.0);
+
+    // streams and events are reused by the next run
+    ASSERT_TRUE(scheduler.Run(stream_).Ok());
+    records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 8);
+    EXPECT_EQ(records[5].stream, records[1].stream);
+    EXPECT_EQ(scheduler.GetStats().eventWaitCount, 8);
+}
+
+TEST_F(StreamSchedulerTest, ChainStaysOnOneStream)
+{
+    StreamScheduler scheduler;
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x2000)).Ok());
+    // reads the output of node 0 through an overlapping range
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x2080}, 0x3000)).Ok());
+    // overwrites the input of node 1
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x4000}, 0x2080)).Ok());
+    EXPECT_EQ(scheduler.GetNodeDependencies(1), std::vector<size_t>({0}));
+    EXPECT_EQ(scheduler.GetNodeDependencies(2), std::vector<size_t>({0, 1}));
+    ASSERT_TRUE(scheduler.Run(stream_).Ok());
+
+    StreamSchedulerStats stats = scheduler.GetStats();
+    EXPECT_EQ(stats.streamsUsed, 1);
+    EXPECT_EQ(stats.eventWaitCount, 0);
+    EXPECT_EQ(stats.sideLaunchCount, 0);
+    EXPECT_DOUBLE_EQ(stats.Parallelism(), 1.0);
+    for (const auto &record : backend_->GetLaunchRecords()) {
+        EXPECT_EQ(record.stream, stream_);
+    }
+}
+
+TEST_F(StreamSchedulerTest, JoinAndStreamLimit)
+{
+    StreamScheduler scheduler(2); // 2: caller stream and one pool stream
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x2000)).Ok());
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x3000)).Ok());
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x4000)).Ok());
+    // explicit order between independent nodes
+    ASSERT_TRUE(scheduler.AddDependency(1, 2).Ok());
+    EXPECT_FALSE(scheduler.AddDependency(2, 1).Ok());
+    EXPECT_FALSE(scheduler.AddDependency(0, 3).Ok());
+    EXPECT_EQ(scheduler.GetNodeStream(1), 1);
+    EXPECT_EQ(scheduler.GetNodeStream(2), 1);
+
+    ASSERT_TRUE(scheduler.Run(stream_).Ok());
+    StreamSchedulerStats stats = scheduler.GetStats();
+    EXPECT_EQ(stats.streamsUsed, 2);
+    // 1 fork and the caller stream joins the pool stream
+    EXPECT_EQ(stats.eventWaitCount, 2);
+    EXPECT_EQ(stats.sideLaunchCount, 2);
+
+    scheduler.Clear();
+    EXPECT_EQ(scheduler.GetNodeCount(), 0);
+    EXPECT_FALSE(scheduler.Run(stream_).Ok());
+}
+
+TEST_F(StreamSchedulerTest, ClearAfterRunWaitsForEvents)
+{
+    StreamScheduler scheduler;
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x2000)).Ok());
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x3000)).Ok());
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x2000, 0x3000}, 0x4000)).Ok());
+    // the recorded fork and dependency events are still pending when Run returns
+    backend_->SetEventDeferred(true);
+    ASSERT_TRUE(scheduler.Run(stream_).Ok());
+    uint64_t destroyCount = backend_->GetIncompleteEventDestroyCount();
+    scheduler.Clear();
+    backend_->SetEventDeferred(false);
+    EXPECT_EQ(backend_->GetIncompleteEventDestroyCount(), destroyCount);
+    EXPECT_EQ(scheduler.GetNodeCount(), 0);
+}
+
+TEST_F(StreamSchedulerTest, JoinOnLaunchFailure)
+{
+    StreamScheduler scheduler;
+    SchedulerOperation<FailingSchedulerKernel> failingOp;
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x2000)).Ok());
+    ASSERT_TRUE(scheduler.AddNode(op_, MakeLaunchParam({0x1000}, 0x3000)).Ok());
+    ASSERT_TRUE(scheduler.AddNode(failingOp, MakeLaunchParam({0x1000}, 0x4000)).Ok());
+    // planned as the nodes are added, the getters are const
+    const StreamScheduler &planned = scheduler;
+    EXPECT_EQ(planned.GetNodeStream(2), 2);
+    EXPECT_EQ(planned.GetStats().streamsUsed, 3);
+
+    EXPECT_FALSE(scheduler.Run(stream_).Ok());
+    StreamSchedulerStats stats = scheduler.GetStats();
+    EXPECT_EQ(stats.launchCount, 2);
+    EXPECT_EQ(stats.runCount, 0);
+    // 2 forks, then the stream given to Run joins both pool streams although node 2 failed
+    EXPECT_EQ(stats.eventWaitCount, 4);
+}
+} // namespace Mki
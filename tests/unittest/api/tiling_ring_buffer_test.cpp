@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2024 Huawei Technologies Co., Ltd.
+ * MindKernelInfra is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+#include <gtest/gtest.h>
+#include <cstring>
+#include "mki/utils/rt/memory/tiling_ring_buffer.h"
+#include "mock_backend_fixture.h"
+
+namespace Mki {
+constexpr uint64_t TEST_RING_SIZE = 4096;
+
+class TilingRingBufferTest : public MockBackendFixture {
+protected:
+    void SetUp() override
+    {
+        MockBackendFixture::SetUp();
+        memUsed_ = backend_->GetDeviceMemoryUsed();
+    }
+    void TearDown() override
+    {
+        backend_->SetEventDeferred(false);
+        MockBackendFixture::TearDown();
+    }
+
+    uint64_t memUsed_ = 0;
+};
+
+TEST_F(TilingRingBufferTest, UploadAndWrap)
+{
+    {
+        TilingRingBuffer ring(backend_, TEST_RING_SIZE);
+        uint8_t data[1000];
+        for (size_t i = 0; i < sizeof(data); i++) {
+            data[i] = static_cast<uint8_t>(i);
+        }
+        uint8_t *slots[4] = {nullptr};
+        for (size_t i = 0; i < 4; i++) { // 4: slots of 1024 bytes fill the ring
+            ASSERT_EQ(ring.Upload(stream_, data, sizeof(data), &slots[i]), MKIRT_SUCCESS);
+            ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+        }
+        EXPECT_EQ(memcmp(slots[3], data, sizeof(data)), 0);
+        EXPECT_EQ(slots[1], slots[0] + 1024);
+        EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_ + TEST_RING_SIZE);
+
+        // events of the mock backend complete at once, the first slot is reused without waiting
+        uint8_t *slot = nullptr;
+        ASSERT_EQ(ring.Upload(stream_, data, 100, &slot), MKIRT_SUCCESS);
+        EXPECT_EQ(slot, slots[0]);
+        ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+        uint8_t big[2000] = {0};
+        ASSERT_EQ(ring.Upload(stream_, big, sizeof(big), &slot), MKIRT_SUCCESS);
+        EXPECT_EQ(slot, slots[0] + TilingRingBuffer::SLOT_ALIGN);
+        ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+        // the slot does not fit before the end of the buffer, it starts at the beginning again
+        ASSERT_EQ(ring.Upload(stream_, big, sizeof(big), &slot), MKIRT_SUCCESS);
+        EXPECT_EQ(slot, slots[0]);
+        ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+        TilingRingStats stats = ring.GetStats();
+        EXPECT_EQ(stats.uploadCount, 7);
+        EXPECT_EQ(stats.wrapCount, 1);
+        EXPECT_EQ(stats.waitCount, 0);
+        EXPECT_EQ(stats.streamCount, 1);
+        ring.ReleaseStream(stream_);
+        EXPECT_EQ(ring.GetStats().streamCount, 0);
+        EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_);
+    }
+    EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_);
+}
+
+TEST_F(TilingRingBufferTest, WaitForStream)
+{
+    TilingRingBuffer ring(backend_, TEST_RING_SIZE);
+    backend_->SetEventDeferred(true);
+    uint8_t data[2048] = {0};
+    uint8_t *first = nullptr;
+    uint8_t *slot = nullptr;
+    ASSERT_EQ(ring.Upload(stream_, data, sizeof(data), &first), MKIRT_SUCCESS);
+    ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+    ASSERT_EQ(ring.Upload(stream_, data, sizeof(data), &slot), MKIRT_SUCCESS);
+    ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+    // the ring is full and the event is not completed, upload waits for the first slot
+    ASSERT_EQ(ring.Upload(stream_, data, sizeof(data), &slot), MKIRT_SUCCESS);
+    EXPECT_EQ(slot, first);
+    EXPECT_EQ(ring.GetStats().waitCount, 1);
+    ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+    backend_->CompleteEvents();
+    ring.ReleaseStream(stream_);
+}
+
+TEST_F(TilingRingBufferTest, UploadFail)
+{
+    TilingRingBuffer ring(backend_, TEST_RING_SIZE);
+    uint8_t data[2048] = {0};
+    uint8_t *slot = nullptr;
+    EXPECT_EQ(ring.Upload(stream_, nullptr, sizeof(data), &slot), MKIRT_ERROR_PARA_CHECK_FAIL);
+    EXPECT_EQ(ring.Upload(stream_, data, TEST_RING_SIZE + 1, &slot), MKIRT_ERROR_OUT_OF_MEMORY);
+    ASSERT_EQ(ring.Upload(stream_, data, sizeof(data), &slot), MKIRT_SUCCESS);
+    ASSERT_EQ(ring.Upload(stream_, data, sizeof(data), &slot), MKIRT_SUCCESS);
+    // nothing is committed, the slots can not be recycled
+    EXPECT_EQ(ring.Upload(stream_, data, sizeof(data), &slot), MKIRT_ERROR_OUT_OF_MEMORY);
+    ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+    EXPECT_EQ(ring.Upload(stream_, data, sizeof(data), &slot), MKIRT_SUCCESS);
+    ASSERT_EQ(ring.Commit(stream_), MKIRT_SUCCESS);
+    ring.ReleaseStream(stream_);
+}
+
+TEST_F(TilingRingBufferTest, KernelRunWithoutTilingDeviceAddr)
+{
+    BinHandle handle(nullptr);
+    MockFixtureKernel kernel("TilingRingKernel", &handle);
+    kernel.SetLaunchWithTiling(false);
+    uint8_t tilingHost[16] = {0};
+    kernel.SetTilingHostAddr(tilingHost, sizeof(tilingHost));
+    ASSERT_TRUE(kernel.Init(launchParam_).Ok());
+
+    ASSERT_TRUE(kernel.Run(launchParam_, runInfo_).Ok());
+    ASSERT_TRUE(kernel.Run(launchParam_, runInfo_).Ok());
+    EXPECT_EQ(runInfo_.GetTilingDeviceAddr(), nullptr);
+
+    std::vector<MockLaunchRecord> records = backend_->GetLaunchRecords();
+    ASSERT_EQ(records.size(), 2);
+    void *tilingAddr[2] = {nullptr, nullptr};
+    for (size_t i = 0; i < 2; i++) { // 2: in and out tensors come before tiling
+        ASSERT_GE(records[i].args.size(), 3 * sizeof(void *));
+        tilingAddr[i] = GetArg(records[i], 2);
+        ASSERT_NE(tilingAddr[i], nullptr);
+    }
+    // every launch gets its own slot, the tiling written by InitImpl is uploaded
+    EXPECT_EQ(static_cast<uint8_t *>(tilingAddr[1]),
+              static_cast<uint8_t *>(tilingAddr[0]) + TilingRingBuffer::SLOT_ALIGN);
+    EXPECT_EQ(*static_cast<uint32_t *>(tilingAddr[1]), FIXTURE_TILING_VALUE);
+}
+
+TEST_F(TilingRingBufferTest, StreamDestroyReleasesRing)
+{
+    TilingRingBuffer *ring = GetTilingRingBuffer();
+    uint64_t streamCount = ring->GetStats().streamCount;
+    MkiRtStream stream = nullptr;
+    ASSERT_EQ(MkiRtStreamCreate(&stream, 0), MKIRT_SUCCESS);
+    uint8_t data[64] = {0};
+    uint8_t *slot = nullptr;
+    ASSERT_EQ(ring->Upload(stream, data, sizeof(data), &slot), MKIRT_SUCCESS);
+    ASSERT_EQ(ring->Commit(stream), MKIRT_SUCCESS);
+    EXPECT_EQ(ring->GetStats().streamCount, streamCount + 1);
+    EXPECT_GT(backend_->GetDeviceMemoryUsed(), memUsed_);
+
+    ASSERT_EQ(MkiRtStreamDestroy(stream), MKIRT_SUCCESS);
+    EXPECT_EQ(ring->GetStats().streamCount, streamCount);
+    EXPECT_EQ(backend_->GetDeviceMemoryUsed(), memUsed_);
+}
+} // namespace Mki